@@ -0,0 +1,236 @@
+/* Parse throughput of jvcmd along several axes: number of options in the spec, number of arguments,
+   short option clusters, options with values, positional arguments and typed conversions.
+   Each case is parsed a few times to warm up, then timed on repeated runs, whose percentiles are printed
+   in nanoseconds per token (argument of argv), and per option of the spec for the option count axis. */
+#define _POSIX_C_SOURCE 200809L /* for clock_gettime() */
+
+#include "../jvcmd/jvcmd.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static unsigned random_state = 1;
+
+static unsigned next_random(void) {
+    random_state = random_state * 1103515245u + 12345u;
+    return random_state >> 16;
+}
+
+/* Synthetic spec and command line of a case. Strings are kept in 'names' until the case is freed. */
+typedef struct BenchCase {
+    char const* title;
+    bool per_option;        /* whether the time per option of the spec is meaningful */
+    jvArgument* arguments;
+    jvArgument** options;   /* NULL-terminated */
+    jvArgument** pos_args;  /* NULL-terminated */
+    int nb_options;
+    char (*names)[24];      /* "--opt-N" for each option */
+    int argc;
+    char** argv;
+} BenchCase;
+
+enum OptionKind { KIND_FLAG, KIND_VALUE, KIND_INT, KIND_FLOAT, KIND_BOOL, KIND_ALLOWED, KIND_MIXED };
+
+static char const* const allowed_values = "none fast medium slow best huge tiny auto";
+static char const* const values[] = { "42", "-7", "1000000", "3.25", "true", "no", "fast", "auto", "some/path/to/a/file.txt" };
+
+static void make_options(BenchCase* bench, int nb_options, enum OptionKind kind) {
+    bench->nb_options = nb_options;
+    bench->arguments = (jvArgument*)calloc(nb_options + 1, sizeof(jvArgument));
+    bench->options = (jvArgument**)calloc(nb_options + 1, sizeof(jvArgument*));
+    bench->names = (char(*)[24])malloc((nb_options + 1) * sizeof(*bench->names));
+    static char const short_names[] = "abcdefgijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"; /* without -h */
+    for (int i = 0; i < nb_options; ++i) {
+        jvArgument* arg = &bench->arguments[i];
+        snprintf(bench->names[i], sizeof(bench->names[i]), "--opt-%d", i);
+        arg->name = bench->names[i] + 2;
+        arg->help = "Synthetic option.";
+        arg->short_name = i < 51 ? short_names[i] : 0;
+        enum OptionKind option_kind = kind == KIND_MIXED ? (enum OptionKind)(i % KIND_MIXED) : kind;
+        arg->multiple = option_kind >= KIND_INT; // every value is converted, not only the last one
+        switch (option_kind) {
+        case KIND_FLAG: break;
+        case KIND_VALUE: arg->need_value = true; break;
+        case KIND_INT: arg->is_int = true; arg->int_min = -1000; arg->int_max = 1000000; break;
+        case KIND_FLOAT: arg->is_float = true; break;
+        case KIND_BOOL: arg->is_bool = true; break;
+        case KIND_ALLOWED: arg->allowed_values = allowed_values; break;
+        case KIND_MIXED: break;
+        }
+        bench->options[i] = arg;
+    }
+}
+
+/* Value accepted by 'arg' */
+static char const* value_for(jvArgument const* arg) {
+    if (arg->is_int)
+        return values[next_random() % 3];
+    if (arg->is_float)
+        return values[next_random() % 4];
+    if (arg->is_bool)
+        return values[4 + next_random() % 2];
+    if (arg->allowed_values != NULL)
+        return values[6 + next_random() % 2];
+    return values[next_random() % 9];
+}
+
+/* Random long options of the spec, followed by their value if they need one. */
+static void make_long_options(BenchCase* bench, int argc) {
+    bench->argc = argc;
+    bench->argv = (char**)malloc((argc + 1) * sizeof(char*));
+    bench->argv[0] = "bench";
+    for (int i = 1; i < argc; ++i) {
+        int index = (int)((next_random() << 16 | next_random()) % (unsigned)bench->nb_options);
+        bench->argv[i] = bench->names[index];
+        if (bench->arguments[index].need_value || bench->arguments[index].is_int || bench->arguments[index].is_float
+                || bench->arguments[index].is_bool || bench->arguments[index].allowed_values != NULL) {
+            if (i + 1 == argc) // no room for the value
+                bench->argv[i] = (char*)"--";
+            else
+                bench->argv[++i] = (char*)value_for(&bench->arguments[index]);
+        }
+    }
+    bench->argv[argc] = NULL;
+}
+
+/* Clusters of 2 to 8 short flags, such as "-xvzf". */
+static void make_short_clusters(BenchCase* bench, int argc) {
+    static char clusters[64][10];
+    for (int c = 0; c < 64; ++c) {
+        int size = 2 + c % 7;
+        clusters[c][0] = '-';
+        for (int i = 1; i <= size; ++i)
+            clusters[c][i] = bench->arguments[next_random() % bench->nb_options].short_name;
+        clusters[c][size + 1] = '\0';
+    }
+    bench->argc = argc;
+    bench->argv = (char**)malloc((argc + 1) * sizeof(char*));
+    bench->argv[0] = "bench";
+    for (int i = 1; i < argc; ++i)
+        bench->argv[i] = clusters[next_random() % 64];
+    bench->argv[argc] = NULL;
+}
+
+/* A few positional arguments, the last one taking all remaining values, between rare options. */
+static void make_positionals(BenchCase* bench, int argc) {
+    static jvArgument input = { "input", "Input file.", .required = true };
+    static jvArgument output = { "output", "Output file." };
+    static jvArgument files = { "files", "Other files.", .multiple = true };
+    static jvArgument* pos_args[] = { &input, &output, &files, NULL };
+    bench->pos_args = pos_args;
+    bench->argc = argc;
+    bench->argv = (char**)malloc((argc + 1) * sizeof(char*));
+    bench->argv[0] = "bench";
+    for (int i = 1; i < argc; ++i)
+        bench->argv[i] = (i % 64 == 0) ? bench->names[next_random() % bench->nb_options] : (char*)values[8];
+    bench->argv[argc] = NULL;
+}
+
+static void free_case(BenchCase* bench) {
+    jvParsingConfig config = { .options = bench->options, .pos_args = bench->pos_args };
+    jvcmd_free_arguments(&config); // what the parses built into the arguments
+    free(bench->arguments);
+    free(bench->options);
+    free(bench->names);
+    free(bench->argv);
+}
+
+static int compare_doubles(void const* a, void const* b) {
+    double x = *(double const*)a, y = *(double const*)b;
+    return (x > y) - (x < y);
+}
+
+static int max_runs = 31;
+
+static void run_case(BenchCase* bench) {
+    jvParsingConfig config = {
+        .options = bench->options,
+        .pos_args = bench->pos_args,
+        .nb_pos_args_required = bench->pos_args != NULL,
+        .action_extra_value = &jvcmd_discard_extra_values,
+    };
+    /* about 50M tokens in total for the biggest cases, at least 5 timed runs */
+    int nb_runs = (int)(50000000 / ((long long)bench->argc + bench->nb_options));
+    nb_runs = nb_runs < 5 ? 5 : nb_runs > max_runs ? max_runs : nb_runs;
+    int nb_warmups = 1 + nb_runs / 5;
+    double* durations = (double*)malloc(nb_runs * sizeof(double));
+    for (int run = -nb_warmups; run < nb_runs; ++run) {
+        double start = now_ns();
+        jvcmd_parse_arguments(bench->argc, bench->argv, config);
+        if (run >= 0)
+            durations[run] = now_ns() - start;
+    }
+    qsort(durations, nb_runs, sizeof(double), &compare_doubles);
+    double p50 = durations[(nb_runs - 1) / 2], p90 = durations[(nb_runs - 1) * 9 / 10];
+    printf("%-22s %7d %8d %9.1f %9.1f %9.1f", bench->title, bench->nb_options, bench->argc,
+           durations[0] / bench->argc, p50 / bench->argc, p90 / bench->argc);
+    if (bench->per_option)
+        printf(" %12.1f\n", p50 / bench->nb_options);
+    else
+        printf(" %12s\n", "-");
+    free(durations);
+    free_case(bench);
+}
+
+int main(int argc, char** argv) {
+    jvArgument max_argc_arg = { "max-argc", "Largest command line to generate (default: 1000000).", 'a', .is_int = true, .int_min = 10, .int_max = 1000000 };
+    jvArgument runs_arg = { "runs", "Maximal number of timed runs of each case (default: 31).", 'r', .is_int = true, .int_min = 1, .int_max = 10000 };
+    jvArgument* options[] = { &max_argc_arg, &runs_arg, NULL };
+    jvcmd_parse_arguments(argc, argv, (jvParsingConfig) {
+        .description = "Measures the time taken by jvcmd_parse_arguments on synthetic command lines.",
+        .options = options,
+    });
+    int max_argc = max_argc_arg.specified ? max_argc_arg.as_int : 1000000;
+    if (runs_arg.specified)
+        max_runs = runs_arg.as_int;
+
+    printf("%-22s %7s %8s %9s %9s %9s %12s\n", "", "", "", "min", "p50", "p90", "p50");
+    printf("%-22s %7s %8s %9s %9s %9s %12s\n", "case", "options", "argc", "ns/token", "ns/token", "ns/token", "ns/option");
+
+    static int const option_counts[] = { 10, 100, 1000, 10000 };
+    for (int i = 0; i < 4; ++i) {
+        BenchCase bench = { "option count", true };
+        make_options(&bench, option_counts[i], KIND_FLAG);
+        make_long_options(&bench, 1000);
+        run_case(&bench);
+    }
+    static int const argcs[] = { 10, 100, 1000, 10000, 100000, 1000000 };
+    for (int i = 0; i < 6 && argcs[i] <= max_argc; ++i) {
+        BenchCase bench = { "argc (mixed options)" };
+        make_options(&bench, 32, KIND_MIXED);
+        make_long_options(&bench, argcs[i]);
+        run_case(&bench);
+    }
+    int argc_cases = max_argc < 100000 ? max_argc : 100000;
+    static struct { char const* title; enum OptionKind kind; } const typed[] = {
+        { "value-heavy", KIND_VALUE }, { "int conversion", KIND_INT }, { "float conversion", KIND_FLOAT },
+        { "bool conversion", KIND_BOOL }, { "allowed_values", KIND_ALLOWED },
+    };
+    for (int i = 0; i < 5; ++i) {
+        BenchCase bench = { typed[i].title };
+        make_options(&bench, 32, typed[i].kind);
+        make_long_options(&bench, argc_cases);
+        run_case(&bench);
+    }
+    {
+        BenchCase bench = { "short clusters" };
+        make_options(&bench, 51, KIND_FLAG);
+        make_short_clusters(&bench, argc_cases);
+        run_case(&bench);
+    }
+    {
+        BenchCase bench = { "positional-heavy" };
+        make_options(&bench, 32, KIND_FLAG);
+        make_positionals(&bench, argc_cases);
+        run_case(&bench);
+    }
+    return 0;
+}
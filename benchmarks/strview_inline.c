@@ -0,0 +1,134 @@
+/* Measures the cost of out-of-line calls to the small StrView functions, by building this file twice:
+   without JVSTR_HEADER_ONLY, then with -DJVSTR_HEADER_ONLY where they are inlined in jvcmd.c and in this file. */
+#define _POSIX_C_SOURCE 200809L /* for clock_gettime() */
+
+#include "../jvcmd/jvcmd.h"
+#include "../jvcmd/StrView.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Byte per byte tokenizer, as written by users of StrView: two calls per byte to extract and classify it. */
+static size_t count_words(StrView text, StrCharset const* separators) {
+    size_t nb_words = 0;
+    bool in_word = false;
+    while (text.size > 0) {
+        bool is_separator = jvstr_charset_has(separators, jvstr_extract_first(&text));
+        nb_words += !is_separator && !in_word;
+        in_word = !is_separator;
+    }
+    return nb_words;
+}
+
+/* Token per token matching, with the functions used by jvcmd to recognize options. */
+static size_t count_options(StrView const* tokens, size_t nb_tokens) {
+    StrView prefix = STRVIEW_MAKE("--");
+    StrView help = STRVIEW_MAKE("--help");
+    size_t nb_options = 0;
+    for (size_t i = 0; i < nb_tokens; ++i)
+        nb_options += jvstr_starts_with(tokens[i], prefix, 0) && !jvstr_equal(tokens[i], help);
+    return nb_options;
+}
+
+/* Best of several runs, in nanoseconds per byte */
+static double bench_bytes(StrView text) {
+    StrCharset separators = jvstr_charset_make(STRVIEW_MAKE(" \t\n"));
+    double best = 1e300;
+    size_t nb_words = 0;
+    for (int run = 0; run < 5; ++run) {
+        double start = now_ns();
+        nb_words += count_words(text, &separators);
+        double elapsed = now_ns() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    if (nb_words == 0)
+        puts("Unexpected empty text");
+    return best / text.size;
+}
+
+/* Best of several runs, in nanoseconds per token */
+static double bench_tokens(StrView const* tokens, size_t nb_tokens) {
+    double best = 1e300;
+    size_t nb_options = 0;
+    for (int run = 0; run < 10; ++run) {
+        double start = now_ns();
+        nb_options += count_options(tokens, nb_tokens);
+        double elapsed = now_ns() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    if (nb_options == 0)
+        puts("Unexpected absence of options");
+    return best / nb_tokens;
+}
+
+/* Best of several runs, in nanoseconds per argument */
+static double bench_parse(int argc, char** argv) {
+    jvArgument verbose = { "verbose", "Verbose output.", 'v' };
+    jvArgument level = { "level", "Level.", 'l', .is_int = true };
+    jvArgument name = { "name", "Name.", 'n', .need_value = true };
+    jvArgument* options[] = { &verbose, &level, &name, NULL };
+
+    double best = 1e300;
+    for (int run = 0; run < 10; ++run) {
+        double start = now_ns();
+        jvcmd_parse_arguments(argc, argv, (jvParsingConfig) {
+            .options = options,
+            .action_extra_value = &jvcmd_discard_extra_values,
+        });
+        double elapsed = now_ns() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    return best / argc;
+}
+
+int main(void) {
+    size_t text_size = 64 << 20;
+    char* text = (char*)malloc(text_size);
+    unsigned state = 1;
+    for (size_t i = 0; i < text_size; ++i) {
+        state = state * 1103515245u + 12345u;
+        text[i] = (state >> 16) % 7 == 0 ? ' ' : (char)('a' + (state >> 20) % 26);
+    }
+
+    size_t nb_tokens = text_size / 16;
+    StrView* tokens = (StrView*)malloc(nb_tokens * sizeof(StrView));
+    for (size_t i = 0; i < nb_tokens; ++i) {
+        text[i * 16] = '-';
+        text[i * 16 + 1] = (i % 3 == 0) ? 'x' : '-';
+        tokens[i] = (StrView) { text + i * 16, 4 + i % 12 };
+    }
+
+    static char const* const samples[] = {
+        "--verbose", "--level", "42", "-n", "some/path/to/a/file.txt", "-vv", "--name", "value", "extra",
+    };
+    int nb_samples = (int)(sizeof(samples) / sizeof(samples[0]));
+    int argc = 1000000;
+    char** argv = (char**)malloc((argc + 1) * sizeof(char*));
+    argv[0] = "bench";
+    for (int i = 1; i < argc; ++i)
+        argv[i] = (char*)samples[(i - 1) % nb_samples];
+    argv[argc] = NULL;
+
+#if defined(JVSTR_HEADER_ONLY)
+    puts("StrView functions inlined (JVSTR_HEADER_ONLY)");
+#else
+    puts("StrView functions called from StrView.c");
+#endif
+    printf("byte loop:  %6.2f ns/byte\n", bench_bytes((StrView) { text, text_size }));
+    printf("token loop: %6.2f ns/token\n", bench_tokens(tokens, nb_tokens));
+    printf("jvcmd:      %6.2f ns/argument\n", bench_parse(argc, argv));
+    free(argv);
+    free(tokens);
+    free(text);
+    return 0;
+}
@@ -0,0 +1,83 @@
+/* Measures the cost of jvParsingConfig.strict_utf8 compared with the parse itself. */
+#define _POSIX_C_SOURCE 200809L /* for clock_gettime() */
+
+#include "../jvcmd/jvcmd.h"
+#include "../jvcmd/StrView.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Best of several runs, in nanoseconds per argument */
+static double bench_parse(int argc, char** argv, bool strict_utf8) {
+    jvArgument verbose = { "verbose", "Verbose output.", 'v' };
+    jvArgument level = { "level", "Level.", 'l', .is_int = true };
+    jvArgument name = { "name", "Name.", 'n', .need_value = true };
+    jvArgument* options[] = { &verbose, &level, &name, NULL };
+    
+    double best = 1e300;
+    for (int run = 0; run < 10; ++run) {
+        double start = now_ns();
+        jvcmd_parse_arguments(argc, argv, (jvParsingConfig) {
+            .strict_utf8 = strict_utf8,
+            .options = options,
+            .action_extra_value = &jvcmd_discard_extra_values,
+        });
+        double elapsed = now_ns() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    return best / argc;
+}
+
+static double bench_validation(int argc, char** argv, size_t* nb_bytes) {
+    double best = 1e300;
+    size_t invalid = 0;
+    *nb_bytes = 0;
+    for (int run = 0; run < 10; ++run) {
+        double start = now_ns();
+        for (int i = 0; i < argc; ++i) {
+            StrView arg = StrView_make(argv[i]);
+            invalid += jvstr_find_invalid_utf8(arg) != arg.size;
+            *nb_bytes += arg.size;
+        }
+        double elapsed = now_ns() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+    *nb_bytes /= 10;
+    if (invalid != 0)
+        puts("Unexpected invalid UTF-8");
+    return best;
+}
+
+int main(void) {
+    static char const* const samples[] = {
+        "--verbose", "--level", "42", "-n", "some/path/to/a/file.txt",
+        "/usr/share/locale/fr/LC_MESSAGES/program.mo", "Grüße aus Köln", "日本語のテキスト", "-vv",
+    };
+    int nb_samples = (int)(sizeof(samples) / sizeof(samples[0]));
+    int argc = 1000000;
+    char** argv = (char**)malloc((argc + 1) * sizeof(char*));
+    argv[0] = "bench";
+    for (int i = 1; i < argc; ++i)
+        argv[i] = (char*)samples[(i - 1) % nb_samples];
+    argv[argc] = NULL;
+    
+    double without = bench_parse(argc, argv, false);
+    double with = bench_parse(argc, argv, true);
+    size_t nb_bytes;
+    double validation = bench_validation(argc - 1, argv + 1, &nb_bytes);
+    
+    printf("parse without strict_utf8: %6.2f ns/argument\n", without);
+    printf("parse with strict_utf8:    %6.2f ns/argument (%+.1f%%)\n", with, 100 * (with - without) / without);
+    printf("jvstr_find_invalid_utf8:   %6.2f ns/argument, %.2f GB/s\n", validation / (argc - 1), nb_bytes / validation);
+    free(argv);
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "../jvcmd/jvcmd.h"
+#include "../jvcmd/StrBuf.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -32,20 +33,21 @@ int main(int argc, char** argv) {
     
     float result;
     char op;
-    switch (operation.value[0]) {
-    case 'a': /* add */
+    enum { ADD, SUB, MULT, DIV }; /* in the order of operation.allowed_values */
+    switch (operation.as_index) {
+    case ADD:
         result = lhs + rhs;
         op = '+';
         break;
-    case 's': /* sub */
+    case SUB:
         result = lhs - rhs;
         op = '-';
         break;
-    case 'm': /* mult */
+    case MULT:
         result = lhs * rhs;
         op = '*';
         break;
-    case 'd': /* div */
+    case DIV:
         result = lhs / rhs; /* division by zero is handled correctly with float */
         if (integer_option.specified && rhs != 0) result = (int) result;
         op = '/';
@@ -55,10 +57,16 @@ int main(int argc, char** argv) {
         exit(EXIT_FAILURE);
     }
     
+    /* shortest text which reads back as the same float */
+    char result_text[JVSTR_FORMAT_SIZE];
+    jvstr_format_float(result_text, result);
     if (sentence_option.specified) {
-        printf("The result of %g %c %g is %g.\n", lhs, op, rhs, result);
+        char lhs_text[JVSTR_FORMAT_SIZE], rhs_text[JVSTR_FORMAT_SIZE];
+        jvstr_format_float(lhs_text, lhs);
+        jvstr_format_float(rhs_text, rhs);
+        printf("The result of %s %c %s is %s.\n", lhs_text, op, rhs_text, result_text);
     } else {
-        printf("%g\n", result);
+        puts(result_text);
     }
     
     return 0;
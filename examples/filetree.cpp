@@ -1,69 +1,105 @@
-#include "../jvcmd/jvcmd.h"
+#include "../jvcmd/jvcmd.hpp"
 
 #include <filesystem>
 #include <iostream>
+#include <string_view>
+#include <vector>
 
 namespace fs = std::filesystem;
 
-void check_file_exists(jvParsingConfig* config, jvArgument* arg) {
-    if (!fs::is_directory(arg->value))
-        jvcmd_exit_with_error(config, "Invalid value for option '%s': '%s' is not a path to a directory.", arg->name, arg->value);
+struct Settings {
+    bool follow_symlinks = false;
+    bool full_path = false;
+    int max_depth = 5;
+    std::vector<std::string_view> root_directories = { "." };
+};
+
+static char const* const description = "Iterate recursively over directories and print their files.";
+
+// Parse straight into the members of 'settings'.
+bool parse_with_binder(int argc, char** argv, Settings& settings) {
+    jvcmd::Binder<Settings> parser(settings, description);
+    
+    parser.bind(&Settings::follow_symlinks, "follow-symlink", 0, "Follow symbolic links for directories.").is_bool();
+    parser.bind(&Settings::full_path, "full-path", 'f', "Print full path.");
+    parser.bind(&Settings::max_depth, "max-depth", 'L', "How much the iteration can be nested.").is_int(1, 50);
+    parser.bind_positional(&Settings::root_directories, "root", "Root directories to be iterated over.");
+    
+    if (auto result = parser.parse(argc, argv); !result) {
+        std::cerr << "ERROR! " << result.error().message << "\n";
+        return false;
+    }
+    return true;
 }
 
+// The same command line from a constexpr spec: the compiler checks the names and bounds,
+// and builds the perfect hash of the long names and the usage line.
+static constexpr auto spec = jvcmd::make_spec(
+    jvcmd::option("follow-symlink", "Follow symbolic links for directories.").is_bool(),
+    jvcmd::option("full-path", "Print full path.", 'f'),
+    jvcmd::option("max-depth", "How much the iteration can be nested.", 'L').is_int(1, 50),
+    jvcmd::positional("root", "Root directories to be iterated over.").multiple());
+
+bool parse_with_spec(int argc, char** argv, Settings& settings) {
+    jvcmd::StaticParser<spec> parser(description);
+    if (auto result = parser.parse(argc, argv); !result) {
+        std::cerr << "ERROR! " << result.error().message << "\n";
+        return false;
+    }
+    settings.follow_symlinks = parser["follow-symlink"].as_bool();
+    settings.full_path = parser["full-path"].specified();
+    if (parser["max-depth"].specified())
+        settings.max_depth = parser["max-depth"].as_int();
+    if (jvcmd::Values roots = parser["root"].values(); !roots.empty()) {
+        settings.root_directories.clear();
+        for (std::string_view root : roots) // points into argv
+            settings.root_directories.push_back(root);
+    }
+    return true;
+}
 
 int main(int argc, char** argv) {
 
-    jvArgument full_path       = { "full-path", "Print full path.", 'f' };
+    Settings settings;
+#ifdef FILETREE_STATIC_SPEC
+    bool parsed = parse_with_spec(argc, argv, settings);
+#else
+    bool parsed = parse_with_binder(argc, argv, settings);
+#endif
+    if (!parsed)
+        return 1;
     
-    jvArgument follow_symlinks = { "follow-symlink", "Follow symbolic links for directories." };
-    follow_symlinks.is_bool = true;
-    follow_symlinks.default_value = "false";
-    
-    jvArgument max_depth       = { "max-depth", "How much the iteration can be nested.", 'L' };
-    max_depth.is_int = true;
-    max_depth.int_min = 1;
-    max_depth.int_max = 50;
-    max_depth.default_value = "5";
-    
-    jvArgument root_directory  = { "root", "Root directory to be iterated over." };
-    root_directory.need_value = true;
-    root_directory.default_value = ".";
-    root_directory.action = check_file_exists;
-                                 
-    
-    jvArgument* options[] = { &follow_symlinks, &full_path, &max_depth, NULL };
-    jvArgument* pos_args[] = { &root_directory, NULL };
-    
-    jvcmd_parse_arguments(argc, argv, jvParsingConfig{
-        .description = "Iterate recursively over a directory and print its files.",
-        .options = options,
-        .pos_args = pos_args,
-        .nb_pos_args_required = 0,
-    });
-    
-    fs::path root = fs::absolute(root_directory.value).lexically_normal();
-    
-    auto dir_option = (follow_symlinks.as_bool ? fs::directory_options::follow_directory_symlink : fs::directory_options::none);
-    fs::recursive_directory_iterator iter = { root, dir_option }, end = {};
-    
-    std::cout << root.string() << '\n';
-    while (iter != end) {
-        int current_depth = iter.depth();
-        if (current_depth >= max_depth.as_int) {
-            iter.pop(); // skip this directory because too nested
-            continue;
+    for (std::string_view root_directory : settings.root_directories) {
+        if (!fs::is_directory(root_directory)) {
+            std::cerr << "ERROR! '" << root_directory << "' is not a path to a directory.\n";
+            return 1;
         }
-        for (int i = 0; i < current_depth; ++i) {
-            std::cout << "    ";
+    }
+    
+    auto dir_option = (settings.follow_symlinks ? fs::directory_options::follow_directory_symlink : fs::directory_options::none);
+    for (std::string_view root_directory : settings.root_directories) {
+        fs::path root = fs::absolute(root_directory).lexically_normal();
+        fs::recursive_directory_iterator iter = { root, dir_option }, end = {};
+        
+        std::cout << root.string() << '\n';
+        while (iter != end) {
+            int current_depth = iter.depth();
+            if (current_depth >= settings.max_depth) {
+                iter.pop(); // skip this directory because too nested
+                continue;
+            }
+            for (int i = 0; i < current_depth; ++i) {
+                std::cout << "    ";
+            }
+            if (settings.full_path)
+                std::cout << "  - " << iter->path().string();
+            else
+                std::cout << "  - " << fs::relative(iter->path(), root).string();
+            if (iter->is_directory())
+                std::cout << "/";
+            std::cout << "\n";
+            ++iter;
         }
-        if (full_path.specified)
-            std::cout << "  - " << iter->path().string();
-        else
-            std::cout << "  - " << fs::relative(iter->path(), root).string();
-        if (iter->is_directory())
-            std::cout << "/";
-        std::cout << "\n";
-        ++iter;
     }
 
     return 0;
@@ -0,0 +1,597 @@
+/*
+This is the C implementation for the JsonDoc structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+#include "JsonDoc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+static int count_trailing_zeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+static bool is_whitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool is_operator(char c) {
+    return c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+}
+
+static bool is_hex_digit(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+
+/* STAGE 1: Bitmasks of interesting characters, 64 bytes at once, turned into a list of tokens. */
+
+typedef struct BlockMasks {
+    uint64_t quote, backslash, op, whitespace, control;
+} BlockMasks;
+
+static void classify_block(unsigned char const* block, BlockMasks* m) {
+    memset(m, 0, sizeof(BlockMasks));
+#ifdef __SSE2__
+    for (int i = 0; i < 64; i += 16) {
+        __m128i x = _mm_loadu_si128((__m128i const*)(block + i));
+#define JSON_MASK(cmp) ((uint64_t)(uint16_t)_mm_movemask_epi8(cmp) << i)
+#define JSON_EQ(ch) _mm_cmpeq_epi8(x, _mm_set1_epi8(ch))
+        m->quote |= JSON_MASK(JSON_EQ('"'));
+        m->backslash |= JSON_MASK(JSON_EQ('\\'));
+        /* '{' '}' '[' ']' are 0x7B 0x7D 0x5B 0x5D: setting bit 0x20 leaves two values */
+        __m128i lowered = _mm_or_si128(x, _mm_set1_epi8(0x20));
+        __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(lowered, _mm_set1_epi8('{')),
+                                        _mm_cmpeq_epi8(lowered, _mm_set1_epi8('}')));
+        m->op |= JSON_MASK(_mm_or_si128(brackets, _mm_or_si128(JSON_EQ(':'), JSON_EQ(','))));
+        m->whitespace |= JSON_MASK(_mm_or_si128(_mm_or_si128(JSON_EQ(' '), JSON_EQ('\t')),
+                                                _mm_or_si128(JSON_EQ('\n'), JSON_EQ('\r'))));
+        __m128i below_space = _mm_cmpeq_epi8(_mm_max_epu8(x, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F));
+        m->control |= JSON_MASK(below_space);
+#undef JSON_EQ
+#undef JSON_MASK
+    }
+#else
+    for (int i = 0; i < 64; ++i) {
+        uint64_t bit = (uint64_t)1 << i;
+        char c = (char)block[i];
+        if (c == '"') m->quote |= bit;
+        if (c == '\\') m->backslash |= bit;
+        if (is_operator(c)) m->op |= bit;
+        if (is_whitespace(c)) m->whitespace |= bit;
+        if (block[i] < 0x20) m->control |= bit;
+    }
+#endif
+}
+
+// Mask of the characters preceded by an odd number of backslashes.
+// `prev_escaped` is 1 if the first character of the block is escaped, and is updated for the next block.
+static uint64_t find_escaped(uint64_t backslash, uint64_t* prev_escaped) {
+    const uint64_t even_bits = 0x5555555555555555u;
+    backslash &= ~*prev_escaped; /* an escaped backslash does not start a sequence */
+    uint64_t follows_escape = (backslash << 1) | *prev_escaped;
+    uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+    uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+    *prev_escaped = sequences_starting_on_even_bits < backslash; /* carry of the addition */
+    uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+
+// Bit i of the result is the XOR of bits 0..i of x, i.e. 1 between an opening and a closing quote.
+static uint64_t prefix_xor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+static bool is_valid_escape(StrView text, size_t pos) {
+    if (pos >= text.size) // backslash at the end of the document
+        return false;
+    switch (text.begin[pos]) {
+    case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+        return true;
+    case 'u':
+        if (pos + 4 >= text.size)
+            return false;
+        for (size_t i = pos + 1; i <= pos + 4; ++i)
+            if (!is_hex_digit(text.begin[i]))
+                return false;
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool index_tokens(JsonDoc* doc, char const** error, size_t* error_pos) {
+    StrView text = doc->text;
+    size_t capacity = 0;
+    uint64_t prev_escaped = 0, prev_in_string = 0, prev_scalar = 0;
+    size_t last_opening_quote = 0;
+    
+    for (size_t base = 0; base < text.size; base += 64) {
+        unsigned char const* block = (unsigned char const*)text.begin + base;
+        unsigned char padded[64];
+        if (text.size - base < 64) {
+            memset(padded, ' ', sizeof(padded));
+            memcpy(padded, block, text.size - base);
+            block = padded;
+        }
+        BlockMasks m;
+        classify_block(block, &m);
+        
+        uint64_t escaped = find_escaped(m.backslash, &prev_escaped);
+        uint64_t quote = m.quote & ~escaped;
+        uint64_t in_string = prefix_xor(quote) ^ prev_in_string; /* opening quote included, closing excluded */
+        prev_in_string = (uint64_t)0 - (in_string >> 63);
+        uint64_t opening_quotes = quote & in_string;
+        
+        if (opening_quotes != 0) {
+            uint64_t last = opening_quotes;
+            while (last & (last - 1))
+                last &= last - 1;
+            last_opening_quote = base + count_trailing_zeros(last);
+        }
+        if ((m.control & in_string) != 0) {
+            *error = "control character in string";
+            *error_pos = base + count_trailing_zeros(m.control & in_string);
+            return false;
+        }
+        for (escaped &= in_string; escaped != 0; escaped &= escaped - 1) {
+            size_t pos = base + count_trailing_zeros(escaped);
+            if (!is_valid_escape(text, pos)) {
+                *error = "invalid escape sequence";
+                *error_pos = pos - 1;
+                return false;
+            }
+        }
+        
+        uint64_t outside = ~in_string & ~quote;
+        uint64_t scalar = outside & ~m.op & ~m.whitespace;
+        uint64_t scalar_starts = scalar & ~((scalar << 1) | prev_scalar);
+        prev_scalar = scalar >> 63;
+        uint64_t tokens = (m.op & outside) | opening_quotes | scalar_starts;
+        
+        if (doc->nb_tokens + 64 > capacity) {
+            capacity = capacity == 0 ? 256 : 2 * capacity;
+            uint32_t* offsets = (uint32_t*)realloc(doc->offsets, capacity * sizeof(uint32_t));
+            if (offsets == NULL) {
+                *error = "not enough memory";
+                *error_pos = base;
+                return false;
+            }
+            doc->offsets = offsets;
+        }
+        for (; tokens != 0; tokens &= tokens - 1)
+            doc->offsets[doc->nb_tokens++] = (uint32_t)(base + count_trailing_zeros(tokens));
+    }
+    if (prev_in_string) {
+        *error = "unterminated string";
+        *error_pos = last_opening_quote;
+        return false;
+    }
+    return true;
+}
+
+
+/* STAGE 2: Validating the sequence of tokens, and computing where each value ends. */
+
+static bool is_valid_number(StrView s) {
+    size_t i = 0;
+    if (i < s.size && s.begin[i] == '-')
+        ++i;
+    if (i < s.size && s.begin[i] == '0') {
+        ++i;
+    } else {
+        if (i >= s.size || s.begin[i] < '1' || s.begin[i] > '9')
+            return false;
+        while (i < s.size && s.begin[i] >= '0' && s.begin[i] <= '9')
+            ++i;
+    }
+    if (i < s.size && s.begin[i] == '.') {
+        size_t digits_start = ++i;
+        while (i < s.size && s.begin[i] >= '0' && s.begin[i] <= '9')
+            ++i;
+        if (i == digits_start)
+            return false;
+    }
+    if (i < s.size && (s.begin[i] == 'e' || s.begin[i] == 'E')) {
+        ++i;
+        if (i < s.size && (s.begin[i] == '+' || s.begin[i] == '-'))
+            ++i;
+        size_t digits_start = i;
+        while (i < s.size && s.begin[i] >= '0' && s.begin[i] <= '9')
+            ++i;
+        if (i == digits_start)
+            return false;
+    }
+    return i == s.size;
+}
+
+// Scalar starting at `pos`, up to the next delimiter.
+static StrView scalar_at(StrView text, size_t pos) {
+    size_t end = pos;
+    while (end < text.size && !is_whitespace(text.begin[end]) && !is_operator(text.begin[end]) && text.begin[end] != '"')
+        ++end;
+    return (StrView){ text.begin + pos, end - pos };
+}
+
+static bool is_valid_scalar(StrView s) {
+    return jvstr_equal(s, STRVIEW_MAKE("true")) || jvstr_equal(s, STRVIEW_MAKE("false"))
+        || jvstr_equal(s, STRVIEW_MAKE("null")) || is_valid_number(s);
+}
+
+enum { EXPECT_VALUE, EXPECT_KEY, AFTER_VALUE };
+
+static bool validate_tokens(JsonDoc* doc, char const** error, size_t* error_pos) {
+    size_t n = doc->nb_tokens;
+    doc->skip = (uint32_t*)malloc((n + 1) * sizeof(uint32_t));
+    size_t* stack = (size_t*)malloc((n + 1) * sizeof(size_t)); /* tokens of open containers */
+    if (doc->skip == NULL || stack == NULL) {
+        free(stack);
+        *error = "not enough memory";
+        *error_pos = 0;
+        return false;
+    }
+    size_t depth = 0;
+    int state = EXPECT_VALUE;
+    size_t t = 0;
+    *error = NULL;
+    while (*error == NULL) {
+        size_t pos = t < n ? doc->offsets[t] : doc->text.size;
+        char c = t < n ? doc->text.begin[pos] : '\0';
+        if (state == AFTER_VALUE && depth == 0) {
+            if (t < n)
+                *error = "unexpected data after the value";
+            break;
+        }
+        if (t >= n) {
+            *error = "unexpected end";
+        } else if (state == EXPECT_KEY) {
+            if (c != '"')
+                *error = "expected a string as key";
+            else if (t + 1 >= n || doc->text.begin[doc->offsets[t + 1]] != ':')
+                *error = "expected ':' after key", pos = t + 1 < n ? doc->offsets[t + 1] : doc->text.size;
+            else
+                t += 2, state = EXPECT_VALUE;
+        } else if (state == EXPECT_VALUE) {
+            if (c == '{' || c == '[') {
+                stack[depth++] = t++;
+                char closing = c == '{' ? '}' : ']';
+                if (t < n && doc->text.begin[doc->offsets[t]] == closing)
+                    state = AFTER_VALUE; /* empty container, closed below */
+                else
+                    state = c == '{' ? EXPECT_KEY : EXPECT_VALUE;
+                if (state == AFTER_VALUE) {
+                    doc->skip[stack[--depth]] = (uint32_t)(t + 1);
+                    ++t;
+                }
+            } else if (c == '"') {
+                doc->skip[t] = (uint32_t)(t + 1);
+                ++t;
+                state = AFTER_VALUE;
+            } else if (is_operator(c)) {
+                *error = "expected a value";
+            } else if (!is_valid_scalar(scalar_at(doc->text, pos))) {
+                *error = (c == '-' || (c >= '0' && c <= '9')) ? "invalid number" : "invalid literal";
+            } else {
+                doc->skip[t] = (uint32_t)(t + 1);
+                ++t;
+                state = AFTER_VALUE;
+            }
+        } else { /* AFTER_VALUE, inside a container */
+            char container = doc->text.begin[doc->offsets[stack[depth - 1]]];
+            if (c == ',') {
+                ++t;
+                state = container == '{' ? EXPECT_KEY : EXPECT_VALUE;
+            } else if (c == (container == '{' ? '}' : ']')) {
+                doc->skip[stack[--depth]] = (uint32_t)(t + 1);
+                ++t;
+            } else {
+                *error = container == '{' ? "expected ',' or '}'" : "expected ',' or ']'";
+            }
+        }
+        if (*error != NULL)
+            *error_pos = pos;
+    }
+    free(stack);
+    return *error == NULL;
+}
+
+
+bool jvjson_parse(JsonDoc* doc, StrView text, char const** error, size_t* error_pos) {
+    memset(doc, 0, sizeof(JsonDoc));
+    doc->text = text;
+    if (text.size >= UINT32_MAX) {
+        *error = "document is too large";
+        *error_pos = 0;
+        return false;
+    }
+    return index_tokens(doc, error, error_pos) && validate_tokens(doc, error, error_pos);
+}
+
+void jvjson_free(JsonDoc* doc) {
+    free(doc->offsets);
+    free(doc->skip);
+    memset(doc, 0, sizeof(JsonDoc));
+}
+
+
+/* QUERIES */
+
+static const JsonValue invalid_value = { NULL, 0 };
+
+static char first_char(JsonValue value) {
+    return value.doc->text.begin[value.doc->offsets[value.token]];
+}
+
+JsonValue jvjson_root(JsonDoc const* doc) {
+    JsonValue root = { doc, 0 };
+    return doc->nb_tokens > 0 && doc->skip != NULL ? root : invalid_value;
+}
+
+JsonType jvjson_type(JsonValue value) {
+    if (value.doc == NULL)
+        return JSON_INVALID;
+    switch (first_char(value)) {
+    case '{': return JSON_OBJECT;
+    case '[': return JSON_ARRAY;
+    case '"': return JSON_STRING;
+    case 't': case 'f': return JSON_BOOL;
+    case 'n': return JSON_NULL;
+    default:  return JSON_NUMBER;
+    }
+}
+
+// Token of the first element or member of a container, or 0 if empty.
+static size_t first_child(JsonValue container) {
+    size_t t = container.token + 1;
+    return t + 1 == container.doc->skip[container.token] ? 0 : t;
+}
+
+// Token of the next element or member of a container, or 0 if it was the last one.
+// `token` is the token of the element, or the token of the key for objects.
+static size_t next_child(JsonDoc const* doc, size_t token, bool is_object) {
+    size_t t = is_object ? doc->skip[token + 2] : doc->skip[token];
+    return doc->text.begin[doc->offsets[t]] == ',' ? t + 1 : 0;
+}
+
+JsonValue jvjson_member(JsonValue object, StrView key) {
+    if (jvjson_type(object) != JSON_OBJECT)
+        return invalid_value;
+    for (size_t t = first_child(object); t != 0; t = next_child(object.doc, t, true)) {
+        JsonValue member_key = { object.doc, t };
+        if (jvstr_equal(jvjson_string(member_key), key))
+            return (JsonValue){ object.doc, t + 2 };
+    }
+    return invalid_value;
+}
+
+JsonValue jvjson_at(JsonValue array, size_t index) {
+    if (jvjson_type(array) != JSON_ARRAY)
+        return invalid_value;
+    for (size_t t = first_child(array); t != 0; t = next_child(array.doc, t, false)) {
+        if (index-- == 0)
+            return (JsonValue){ array.doc, t };
+    }
+    return invalid_value;
+}
+
+size_t jvjson_count(JsonValue container) {
+    JsonType type = jvjson_type(container);
+    if (type != JSON_OBJECT && type != JSON_ARRAY)
+        return 0;
+    size_t count = 0;
+    for (size_t t = first_child(container); t != 0; t = next_child(container.doc, t, type == JSON_OBJECT))
+        ++count;
+    return count;
+}
+
+JsonValue jvjson_get(JsonValue value, StrView path) {
+    while (path.size > 0 && value.doc != NULL) {
+        char c = path.begin[0];
+        if (c == '.') {
+            jvstr_split(&path, 0, 1);
+        } else if (c == '[') {
+            StrView digits = jvstr_split(&path, jvstr_find(path, ']'), 1);
+            jvstr_split(&digits, 0, 1); /* '[' */
+            size_t index = 0;
+            if (digits.size == 0)
+                return invalid_value;
+            while (digits.size > 0) {
+                char digit = jvstr_extract_first(&digits);
+                if (digit < '0' || digit > '9')
+                    return invalid_value;
+                index = index * 10 + (digit - '0');
+            }
+            value = jvjson_at(value, index);
+        } else {
+            StrView key = jvstr_split(&path, jvstr_until_in(path, STRVIEW_MAKE(".["), 0), 0);
+            value = jvjson_member(value, key);
+        }
+    }
+    return value;
+}
+
+StrView jvjson_raw(JsonValue value) {
+    if (value.doc == NULL)
+        return STRVIEW_MAKE("");
+    JsonDoc const* doc = value.doc;
+    size_t begin = doc->offsets[value.token];
+    switch (jvjson_type(value)) {
+    case JSON_OBJECT: case JSON_ARRAY: {
+        size_t end = doc->offsets[doc->skip[value.token] - 1] + 1; /* closing bracket included */
+        return (StrView){ doc->text.begin + begin, end - begin };
+    }
+    case JSON_STRING: {
+        StrView content = jvjson_string(value);
+        return (StrView){ content.begin - 1, content.size + 2 };
+    }
+    default:
+        return scalar_at(doc->text, begin);
+    }
+}
+
+StrView jvjson_string(JsonValue value) {
+    if (jvjson_type(value) != JSON_STRING)
+        return STRVIEW_MAKE("");
+    JsonDoc const* doc = value.doc;
+    StrView rest = { doc->text.begin + doc->offsets[value.token] + 1, doc->text.size - doc->offsets[value.token] - 1 };
+    size_t end = 0;
+    while (true) { /* the document was validated, so the string is terminated */
+        end += jvstr_find((StrView){ rest.begin + end, rest.size - end }, '"');
+        size_t nb_backslashes = 0;
+        while (nb_backslashes < end && rest.begin[end - 1 - nb_backslashes] == '\\')
+            ++nb_backslashes;
+        if (nb_backslashes % 2 == 0)
+            break;
+        ++end;
+    }
+    return (StrView){ rest.begin, end };
+}
+
+static unsigned parse_hex4(char const* s) {
+    unsigned value = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = s[i];
+        value = value * 16 + (c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+    }
+    return value;
+}
+
+size_t jvjson_decode_string(JsonValue value, char* buffer, size_t buffer_size) {
+    StrView s = jvjson_string(value);
+    size_t size = 0;
+#define JSON_PUT(ch) do { if (size + 1 < buffer_size) buffer[size] = (char)(ch); ++size; } while (0)
+    while (s.size > 0) {
+        char c = jvstr_extract_first(&s);
+        if (c != '\\') {
+            JSON_PUT(c);
+            continue;
+        }
+        c = jvstr_extract_first(&s);
+        switch (c) {
+        case 'b': JSON_PUT('\b'); break;
+        case 'f': JSON_PUT('\f'); break;
+        case 'n': JSON_PUT('\n'); break;
+        case 'r': JSON_PUT('\r'); break;
+        case 't': JSON_PUT('\t'); break;
+        case 'u': {
+            unsigned cp = parse_hex4(s.begin);
+            jvstr_split(&s, 0, 4);
+            if (cp >= 0xD800 && cp < 0xDC00 && s.size >= 6 && s.begin[0] == '\\' && s.begin[1] == 'u') {
+                unsigned low = parse_hex4(s.begin + 2);
+                if (low >= 0xDC00 && low < 0xE000) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    jvstr_split(&s, 0, 6);
+                }
+            }
+            if (cp < 0x80) {
+                JSON_PUT(cp);
+            } else if (cp < 0x800) {
+                JSON_PUT(0xC0 | (cp >> 6));
+                JSON_PUT(0x80 | (cp & 0x3F));
+            } else if (cp < 0x10000) {
+                JSON_PUT(0xE0 | (cp >> 12));
+                JSON_PUT(0x80 | ((cp >> 6) & 0x3F));
+                JSON_PUT(0x80 | (cp & 0x3F));
+            } else {
+                JSON_PUT(0xF0 | (cp >> 18));
+                JSON_PUT(0x80 | ((cp >> 12) & 0x3F));
+                JSON_PUT(0x80 | ((cp >> 6) & 0x3F));
+                JSON_PUT(0x80 | (cp & 0x3F));
+            }
+            break;
+        }
+        default: /* '"' '\\' '/' */
+            JSON_PUT(c);
+            break;
+        }
+    }
+#undef JSON_PUT
+    if (buffer_size > 0)
+        buffer[size < buffer_size ? size : buffer_size - 1] = '\0';
+    return size;
+}
+
+bool jvjson_as_int64(JsonValue value, int64_t* result) {
+    if (jvjson_type(value) != JSON_NUMBER)
+        return false;
+    StrView s = jvjson_raw(value);
+    bool negative = s.begin[0] == '-';
+    if (negative)
+        jvstr_split(&s, 0, 1);
+    uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+    uint64_t magnitude = 0;
+    while (s.size > 0) {
+        char c = jvstr_extract_first(&s);
+        if (c < '0' || c > '9' || magnitude > (limit - (c - '0')) / 10)
+            return false; /* fraction, exponent, or overflow */
+        magnitude = magnitude * 10 + (c - '0');
+    }
+    *result = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    return true;
+}
+
+bool jvjson_as_double(JsonValue value, double* result) {
+    if (jvjson_type(value) != JSON_NUMBER)
+        return false;
+    StrView s = jvjson_raw(value);
+    char local[64];
+    char* copy = s.size < sizeof(local) ? local : (char*)malloc(s.size + 1); /* strtod needs '\0' */
+    if (copy == NULL)
+        return false;
+    memcpy(copy, s.begin, s.size);
+    copy[s.size] = '\0';
+    *result = strtod(copy, NULL);
+    if (copy != local)
+        free(copy);
+    return true;
+}
+
+bool jvjson_as_bool(JsonValue value) {
+    return value.doc != NULL && first_char(value) == 't';
+}
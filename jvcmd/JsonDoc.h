@@ -0,0 +1,120 @@
+/*
+This is the C header for the JsonDoc structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef JVSTR_JSONDOC
+#define JVSTR_JSONDOC
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "StrView.h"
+
+/*
+JsonDoc is a validated JSON document which is not decoded: it references the original text (zero-copy).
+Parsing builds an index of the structural tokens in one pass over 64-byte blocks, then validates the grammar.
+Values are only decoded when queried, and containers can be skipped in O(1) thanks to the index.
+The text must outlive the document.
+*/
+typedef struct JsonDoc {
+    StrView text;
+    uint32_t* offsets; /* offset in text of each token: { } [ ] : , and first byte of each string or scalar */
+    uint32_t* skip;    /* for each token starting a value, index of the token after this value */
+    size_t nb_tokens;
+} JsonDoc;
+
+typedef enum JsonType {
+    JSON_INVALID, /* value not found */
+    JSON_NULL,
+    JSON_BOOL,
+    JSON_NUMBER,
+    JSON_STRING,
+    JSON_ARRAY,
+    JSON_OBJECT,
+} JsonType;
+
+// Reference to a value inside a document, cheap to copy.
+typedef struct JsonValue {
+    JsonDoc const* doc;
+    size_t token;
+} JsonValue;
+
+// Parse and validate `text`, initializing `doc`.
+// On error, returns false and sets `*error` to a static message and `*error_pos` to the byte offset in text.
+// `doc` needs to be released with jvjson_free, whatever the result.
+bool jvjson_parse(JsonDoc* doc, StrView text, char const** error, size_t* error_pos);
+
+// Release the index of the document.
+void jvjson_free(JsonDoc* doc);
+
+// The top-level value of the document.
+JsonValue jvjson_root(JsonDoc const* doc);
+
+// Type of the value, JSON_INVALID for values returned by failed lookups.
+JsonType jvjson_type(JsonValue value);
+
+// Member of an object by key. Keys are compared without decoding escape sequences.
+JsonValue jvjson_member(JsonValue object, StrView key);
+
+// Element of an array by index.
+JsonValue jvjson_at(JsonValue array, size_t index);
+
+// Number of members of an object or elements of an array, 0 for other values.
+size_t jvjson_count(JsonValue container);
+
+// Lookup with a path such as "limits.cpu", "servers[2].host" or "[0]".
+// Returns a JSON_INVALID value if any step is not found.
+JsonValue jvjson_get(JsonValue value, StrView path);
+
+// Text of the value as found in the document, for example '{"cpu":4}' or '"a\\nb"'. Empty if invalid.
+StrView jvjson_raw(JsonValue value);
+
+// Content of a string, without quotes, and without decoding escape sequences. Empty if not a string.
+StrView jvjson_string(JsonValue value);
+
+// Decode a string into `buffer` of `buffer_size` bytes (null-terminated if buffer_size > 0).
+// Returns the size of the decoded string, which may be larger than buffer_size - 1 if truncated.
+size_t jvjson_decode_string(JsonValue value, char* buffer, size_t buffer_size);
+
+// Convert a number. Returns false if not a number, or if it does not fit in an int64_t.
+bool jvjson_as_int64(JsonValue value, int64_t* result);
+bool jvjson_as_double(JsonValue value, double* result);
+
+// true for the literal 'true', false otherwise.
+bool jvjson_as_bool(JsonValue value);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
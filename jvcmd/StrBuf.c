@@ -0,0 +1,992 @@
+/*
+This is the C implementation for the StrBuf structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+#include "StrBuf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h> /* only macros: the library does not need to be linked with -lm */
+#include <locale.h>
+
+// Initialize an empty buffer, using its inline storage.
+void jvstr_buf_init(StrBuf* buf) {
+    jvstr_buf_init_in(buf, buf->small, sizeof(buf->small));
+}
+
+// Initialize an empty buffer using `memory` of `size` bytes until it must grow.
+void jvstr_buf_init_in(StrBuf* buf, char* memory, size_t size) {
+    buf->begin = memory;
+    buf->size = 0;
+    buf->capacity = size - 1;
+    buf->allocate = NULL;
+    buf->arena = NULL;
+    buf->is_allocated = false;
+    buf->has_failed = false;
+    buf->begin[0] = '\0';
+}
+
+// Release memory allocated with malloc by the buffer.
+void jvstr_buf_free(StrBuf* buf) {
+    if (buf->is_allocated)
+        free(buf->begin);
+    buf->begin = buf->small;
+    buf->size = 0;
+    buf->capacity = sizeof(buf->small) - 1;
+    buf->is_allocated = false;
+    buf->small[0] = '\0';
+}
+
+// Remove the content, keeping the storage.
+void jvstr_buf_clear(StrBuf* buf) {
+    buf->size = 0;
+    buf->begin[0] = '\0';
+    buf->has_failed = false;
+}
+
+// Ensure `extra` chars can be appended without growing.
+bool jvstr_buf_reserve(StrBuf* buf, size_t extra) {
+    if (buf->has_failed)
+        return false;
+    if (buf->capacity - buf->size >= extra)
+        return true;
+    size_t capacity = buf->capacity * 2 + 1;
+    if (capacity < buf->size + extra)
+        capacity = buf->size + extra;
+    
+    char* memory;
+    if (buf->allocate != NULL) {
+        memory = (char*)buf->allocate(buf->arena, capacity + 1);
+        if (memory != NULL)
+            memcpy(memory, buf->begin, buf->size + 1);
+    } else if (buf->is_allocated) {
+        memory = (char*)realloc(buf->begin, capacity + 1);
+    } else {
+        memory = (char*)malloc(capacity + 1);
+        if (memory != NULL)
+            memcpy(memory, buf->begin, buf->size + 1);
+    }
+    if (memory == NULL) {
+        buf->has_failed = true;
+        return false;
+    }
+    if (buf->allocate != NULL && buf->is_allocated)
+        free(buf->begin); // an arena was given after malloc was used
+    buf->is_allocated = buf->allocate == NULL;
+    buf->begin = memory;
+    buf->capacity = capacity;
+    return true;
+}
+
+// View of the content.
+StrView jvstr_buf_view(StrBuf const* buf) {
+    StrView view = { buf->begin, buf->size };
+    return view;
+}
+
+// Append the chars of str.
+void jvstr_buf_append(StrBuf* buf, StrView str) {
+    // str may be a view of the buffer itself, which moves when growing
+    bool is_inside = str.begin >= buf->begin && str.begin <= buf->begin + buf->size;
+    size_t offset = is_inside ? (size_t)(str.begin - buf->begin) : 0;
+    if (!jvstr_buf_reserve(buf, str.size))
+        return;
+    if (is_inside)
+        str.begin = buf->begin + offset;
+    memmove(buf->begin + buf->size, str.begin, str.size);
+    buf->size += str.size;
+    buf->begin[buf->size] = '\0';
+}
+
+// Append a single char.
+void jvstr_buf_append_char(StrBuf* buf, char ch) {
+    if (!jvstr_buf_reserve(buf, 1))
+        return;
+    buf->begin[buf->size++] = ch;
+    buf->begin[buf->size] = '\0';
+}
+
+// Append `count` times the char `ch`.
+void jvstr_buf_append_repeat(StrBuf* buf, char ch, size_t count) {
+    if (!jvstr_buf_reserve(buf, count))
+        return;
+    memset(buf->begin + buf->size, ch, count);
+    buf->size += count;
+    buf->begin[buf->size] = '\0';
+}
+
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Write the decimal digits of value ending at `end`, two digits at a time. Returns where they begin.
+static char* write_digits(char* end, unsigned long long value) {
+    while (value >= 100) {
+        unsigned pair = (unsigned)(value % 100);
+        value /= 100;
+        end -= 2;
+        memcpy(end, digit_pairs + 2 * pair, 2);
+    }
+    if (value >= 10) {
+        end -= 2;
+        memcpy(end, digit_pairs + 2 * value, 2);
+    } else {
+        *--end = (char)('0' + value);
+    }
+    return end;
+}
+
+// Append the decimal representation of an integer.
+void jvstr_buf_append_uint(StrBuf* buf, unsigned long long value) {
+    char digits[20];
+    char* begin = write_digits(digits + sizeof(digits), value);
+    jvstr_buf_append(buf, (StrView){ begin, (size_t)(digits + sizeof(digits) - begin) });
+}
+
+void jvstr_buf_append_int(StrBuf* buf, long long value) {
+    char digits[21];
+    // negating in unsigned arithmetic, which is defined for LLONG_MIN
+    unsigned long long magnitude = value < 0 ? 0 - (unsigned long long)value : (unsigned long long)value;
+    char* begin = write_digits(digits + sizeof(digits), magnitude);
+    if (value < 0)
+        *--begin = '-';
+    jvstr_buf_append(buf, (StrView){ begin, (size_t)(digits + sizeof(digits) - begin) });
+}
+
+// Append a floating-point value with `nb_decimals` digits after the point.
+void jvstr_buf_append_float(StrBuf* buf, double value, int nb_decimals) {
+    static const double powers_of_ten[18] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17
+    };
+    if (nb_decimals < 0)
+        nb_decimals = 0;
+    if (nb_decimals > 17)
+        nb_decimals = 17;
+    if (isnan(value) || isinf(value)) {
+        if (signbit(value))
+            jvstr_buf_append_char(buf, '-');
+        jvstr_buf_append(buf, isnan(value) ? STRVIEW_MAKE("nan") : STRVIEW_MAKE("inf"));
+        return;
+    }
+    
+    // Fast path: the value scaled by 10^nb_decimals is small enough that its error is below 2^-19,
+    // so rounding it to an integer gives the same result as with the exact value, except close to halfway.
+    double scaled = (signbit(value) ? -value : value) * powers_of_ten[nb_decimals];
+    if (scaled < 8589934592.0) {
+        unsigned long long integral = (unsigned long long)scaled;
+        double fraction = scaled - (double)integral;
+        if (fraction < 0.5 - 1e-5 || fraction > 0.5 + 1e-5) {
+            unsigned long long digits = integral + (fraction > 0.5);
+            unsigned long long divisor = (unsigned long long)powers_of_ten[nb_decimals];
+            if (signbit(value))
+                jvstr_buf_append_char(buf, '-');
+            jvstr_buf_append_uint(buf, digits / divisor);
+            if (nb_decimals > 0) {
+                char decimals[17];
+                char* end = decimals + nb_decimals;
+                char* begin = write_digits(end, digits % divisor);
+                memset(decimals, '0', (size_t)(begin - decimals));
+                jvstr_buf_append_char(buf, '.');
+                jvstr_buf_append(buf, (StrView){ decimals, (size_t)nb_decimals });
+            }
+            return;
+        }
+    }
+    
+    // Slow path: printf rounds exactly, then the decimal separator of the locale is replaced.
+    size_t start = buf->size;
+    jvstr_buf_append_format(buf, "%.*f", nb_decimals, value);
+    char const* separator = localeconv()->decimal_point;
+    if (buf->has_failed || (separator[0] == '.' && separator[1] == '\0'))
+        return;
+    StrView written = { buf->begin + start, buf->size - start };
+    size_t pos = jvstr_search(written, StrView_make(separator));
+    if (pos == written.size)
+        return;
+    size_t separator_size = strlen(separator);
+    buf->begin[start + pos] = '.';
+    memmove(buf->begin + start + pos + 1, buf->begin + start + pos + separator_size, written.size - pos - separator_size + 1);
+    buf->size -= separator_size - 1;
+}
+
+/* Shortest round-trip formatting, with the Ryu algorithm (Ulf Adams, "Ryu: fast float-to-string conversion", 2018).
+   The bounds of the interval of decimal values which read back as the same binary value are computed
+   with 125-bit fixed-point powers of 5, then digits are removed while the interval still contains a value.
+   Among the shortest decimal values, the closest to the binary value is chosen. */
+
+// pow5_inv_split[q] is 2^(ceil(log2(5^q)) - 1 + 125) / 5^q + 1 and pow5_split[i] is 5^i scaled to 125 bits, as [low, high].
+static const uint64_t pow5_inv_split[292][2] = {
+    { 0x0000000000000001u, 0x2000000000000000u }, { 0x999999999999999Au, 0x1999999999999999u },
+    { 0x47AE147AE147AE15u, 0x147AE147AE147AE1u }, { 0x6C8B4395810624DEu, 0x10624DD2F1A9FBE7u },
+    { 0x7A786C226809D496u, 0x1A36E2EB1C432CA5u }, { 0x61F9F01B866E43ABu, 0x14F8B588E368F084u },
+    { 0xB4C7F34938583622u, 0x10C6F7A0B5ED8D36u }, { 0x87A6520EC08D236Au, 0x1AD7F29ABCAF4857u },
+    { 0x9FB841A566D74F88u, 0x15798EE2308C39DFu }, { 0xE62D01511F12A607u, 0x112E0BE826D694B2u },
+    { 0xD6AE6881CB5109A4u, 0x1B7CDFD9D7BDBAB7u }, { 0xDEF1ED34A2A73AEAu, 0x15FD7FE17964955Fu },
+    { 0x7F27F0F6E885C8BBu, 0x119799812DEA1119u }, { 0x650CB4BE40D60DF8u, 0x1C25C268497681C2u },
+    { 0xEA70909833DE7193u, 0x16849B86A12B9B01u }, { 0x21F3A6E0297EC143u, 0x1203AF9EE756159Bu },
+    { 0x6985D7CD0F313537u, 0x1CD2B297D889BC2Bu }, { 0x2137DFD73F5A90F9u, 0x170EF54646D49689u },
+    { 0xE75FE645CC4873FAu, 0x12725DD1D243ABA0u }, { 0xA5663D3C7A0D865Du, 0x1D83C94FB6D2AC34u },
+    { 0x511E976394D79EB1u, 0x179CA10C9242235Du }, { 0xDA7EDF82DD794BC1u, 0x12E3B40A0E9B4F7Du },
+    { 0x2A6498D1625BAC68u, 0x1E392010175EE596u }, { 0xEEB6E0A781E2F053u, 0x182DB34012B25144u },
+    { 0x58924D52CE4F26A9u, 0x1357C299A88EA76Au }, { 0x27507BB7B07EA441u, 0x1EF2D0F5DA7DD8AAu },
+    { 0x52A6C95FC0655034u, 0x18C240C4AECB13BBu }, { 0x0EEBD44C99EAA690u, 0x13CE9A36F23C0FC9u },
+    { 0xB17953ADC3110A80u, 0x1FB0F6BE50601941u }, { 0xC12DDC8B02740867u, 0x195A5EFEA6B34767u },
+    { 0x3424B06F3529A052u, 0x14484BFEEBC29F86u }, { 0x901D59F290EE19DBu, 0x1039D66589687F9Eu },
+    { 0x4CFBC31DB4B0295Fu, 0x19F623D5A8A73297u }, { 0x3D9635B15D59BAB2u, 0x14C4E977BA1F5BACu },
+    { 0x97AB5E277DE16228u, 0x109D8792FB4C4956u }, { 0xF2ABC9D8C9689D0Du, 0x1A95A5B7F87A0EF0u },
+    { 0x5BBCA17A3ABA173Eu, 0x154484932D2E725Au }, { 0xAFCA1AC82EFB45CBu, 0x11039D428A8B8EAEu },
+    { 0xB2DCF7A6B1920945u, 0x1B38FB9DAA78E44Au }, { 0xF57D92EBC141A104u, 0x15C72FB1552D836Eu },
+    { 0xC46475896767B403u, 0x116C262777579C58u }, { 0x6D6D88DBD8A5ECD2u, 0x1BE03D0BF225C6F4u },
+    { 0x8ABE071646EB23DBu, 0x164CFDA3281E38C3u }, { 0x6EFE6C11D255B649u, 0x11D7314F534B609Cu },
+    { 0xB197134FB6EF8A0Eu, 0x1C8B821885456760u }, { 0x27AC0F72F8BFA1A5u, 0x16D601AD376AB91Au },
+    { 0xB95672C260994E1Eu, 0x1244CE242C5560E1u }, { 0xF5571E03CDC21695u, 0x1D3AE36D13BBCE35u },
+    { 0x2AAC18030B01ABABu, 0x17624F8A762FD82Bu }, { 0xBBBCE0026F348956u, 0x12B50C6EC4F31355u },
+    { 0x92C7CCD0B1EDA889u, 0x1DEE7A4AD4B81EEFu }, { 0xDBD30A408E57BA07u, 0x17F1FB6F10934BF2u },
+    { 0x7CA8D50071DFC806u, 0x1327FC58DA0F6FF5u }, { 0xFAA7BB33E9660CD6u, 0x1EA6608E29B24CBBu },
+    { 0x9552FC298784D711u, 0x18851A0B548EA3C9u }, { 0xAAA8C9BAD2D0AC0Eu, 0x139DAE6F76D88307u },
+    { 0xDDDADC5E1E1AACE3u, 0x1F62B0B257C0D1A5u }, { 0x7E48B04B4B488A4Fu, 0x191BC08EAC9A4151u },
+    { 0xCB6D59D5D5D3A1D9u, 0x141633A556E1CDDAu }, { 0x3C577B1177DC817Bu, 0x1011C2EAABE7D7E2u },
+    { 0xC6F25E825960CF2Au, 0x19B604AAACA62636u }, { 0x6BF518684780A5BBu, 0x14919D5556EB51C5u },
+    { 0x232A79ED06008496u, 0x10747DDDDF22A7D1u }, { 0xD1DD8FE1A3340756u, 0x1A53FC9631D10C81u },
+    { 0xA7E4731AE8F66C45u, 0x150FFD44F4A73D34u }, { 0x531D28E253F8569Eu, 0x10D9976A5D52975Du },
+    { 0xEB61DB03B98D5762u, 0x1AF5BF109550F22Eu }, { 0xBC4E48CFC7A445E8u, 0x159165A6DDDA5B58u },
+    { 0x6371D3D96C836B20u, 0x11411E1F17E1E2ADu }, { 0x9F1C8628AD9F11CDu, 0x1B9B6364F3030448u },
+    { 0xE5B06B53BE18DB0Bu, 0x1615E91D8F359D06u }, { 0xEAF3890FCB4715A2u, 0x11AB20E472914A6Bu },
+    { 0x44B8DB4C7871BC37u, 0x1C45016D841BAA46u }, { 0x03C715D6C6C1635Fu, 0x169D9ABE03495505u },
+    { 0x3638DE456BCDE919u, 0x1217AEFE69077737u }, { 0x56C163A2461641C1u, 0x1CF2B1970E725858u },
+    { 0xDF011C81D1AB67CEu, 0x17288E1271F51379u }, { 0x7F3416CE4155ECA5u, 0x1286D80EC190DC61u },
+    { 0x6520247D3556476Eu, 0x1DA48CE468E7C702u }, { 0xEA801D30F7783925u, 0x17B6D71D20B96C01u },
+    { 0xBB99B0F3F92CFA84u, 0x12F8AC174D612334u }, { 0x5F5C4E532847F739u, 0x1E5AACF215683854u },
+    { 0x7F7D0B75B9D32C2Eu, 0x18488A5B44536043u }, { 0x9930D5F7C7DC2358u, 0x136D3B7C36A919CFu },
+    { 0x8EB4898C72F9D226u, 0x1F152BF9F10E8FB2u }, { 0x722A07A38F2E41B8u, 0x18DDBCC7F40BA628u },
+    { 0xC1BB394FA5BE9AFAu, 0x13E497065CD61E86u }, { 0x9C5EC2190930F7F6u, 0x1FD424D6FAF030D7u },
+    { 0x49E56814075A5FF8u, 0x197683DF2F268D79u }, { 0x6E51201005E1E660u, 0x145ECFE5BF520AC7u },
+    { 0xF1DA800CD181851Au, 0x104BD984990E6F05u }, { 0x4FC400148268D4F5u, 0x1A12F5A0F4E3E4D6u },
+    { 0xD96999AA01ED772Bu, 0x14DBF7B3F71CB711u }, { 0xADEE1488018AC5BCu, 0x10AFF95CC5B09274u },
+    { 0x497CEDA668DE092Cu, 0x1AB328946F80EA54u }, { 0x3ACA57B853E4D424u, 0x155C2076BF9A5510u },
+    { 0x623B7960431D7683u, 0x1116805EFFAEAA73u }, { 0x9D2BF566D1C8BD9Eu, 0x1B5733CB32B110B8u },
+    { 0x7DBCC452416D647Fu, 0x15DF5CA28EF40D60u }, { 0xCAFD69DB678AB6CCu, 0x117F7D4ED8C33DE6u },
+    { 0xAB2F0FC572778ADFu, 0x1BFF2EE48E052FD7u }, { 0x88F273045B92D580u, 0x1665BF1D3E6A8CACu },
+    { 0xD3F528D049424466u, 0x11EAFF4A98553D56u }, { 0xB988414D4203A0A3u, 0x1CAB3210F3BB9557u },
+    { 0x6139CDD76802E6E9u, 0x16EF5B40C2FC7779u }, { 0xE761717920025254u, 0x125915CD68C9F92Du },
+    { 0xA568B58E999D5086u, 0x1D5B561574765B7Cu }, { 0x5120913EE14AA6D2u, 0x177C44DDF6C515FDu },
+    { 0xA74D40FF1AA21F0Eu, 0x12C9D0B1923744CAu }, { 0x0BAECE64F769CB4Au, 0x1E0FB44F50586E11u },
+    { 0x3C8BD850C5EE3C3Bu, 0x180C903F7379F1A7u }, { 0xCA0979DA37F1C9C9u, 0x133D4032C2C7F485u },
+    { 0xA9A8C2F6BFE942DBu, 0x1EC866B79E0CBA6Fu }, { 0x2153CF2BCCBA9BE3u, 0x18A0522C7E709526u },
+    { 0x1AA9728970954982u, 0x13B374F06526DDB8u }, { 0xF775840F1A88759Du, 0x1F8587E7083E2F8Cu },
+    { 0x5F9136727BA05E17u, 0x19379FEC0698260Au }, { 0x1940F85B9619E4DFu, 0x142C7FF0054684D5u },
+    { 0xE100C6AFAB47EA4Cu, 0x1023998CD1053710u }, { 0xCE67A44C453FDD47u, 0x19D28F47B4D524E7u },
+    { 0xD852E9D69DCCB106u, 0x14A8729FC3DDB71Fu }, { 0x79DBEE454B0A2738u, 0x1086C219697E2C19u },
+    { 0x295FE3A211A9D859u, 0x1A71368F0F30468Fu }, { 0xBAB31C81A7BB137Au, 0x15275ED8D8F36BA5u },
+    { 0x6228E39AEC95A92Fu, 0x10EC4BE0AD8F8951u }, { 0x9D0E38F7E0EF7517u, 0x1B13AC9AAF4C0EE8u },
+    { 0xB0D82D931A592A79u, 0x15A956E225D67253u }, { 0x8D79BE0F4847552Eu, 0x11544581B7DEC1DCu },
+    { 0x158F967EDA0BBB7Cu, 0x1BBA08CF8C979C94u }, { 0x77A611FF14D62F97u, 0x162E6D72D6DFB076u },
+    { 0xF951A7FF43DE8C79u, 0x11BEBDF578B2F391u }, { 0xC21C3FFED2FDAD8Eu, 0x1C6463225AB7EC1Cu },
+    { 0x01B0333242648AD8u, 0x16B6B5B5155FF017u }, { 0x0159C28E9B83A246u, 0x122BC490DDE659ACu },
+    { 0xCEF604175F3903A3u, 0x1D12D41AFCA3C2ACu }, { 0x725E69AC4C2D9C83u, 0x17424348CA1C9BBDu },
+    { 0xF5185489D68AE39Cu, 0x129B69070816E2FDu }, { 0xEE8D540FBDAB05C6u, 0x1DC574D80CF16B2Fu },
+    { 0xBED77672FE226B05u, 0x17D12A4670C1228Cu }, { 0xFF12C528CB4EBC04u, 0x130DBB6B8D674ED6u },
+    { 0xCB513B74787DF9A0u, 0x1E7C5F127BD87E24u }, { 0x090DC929F9FE614Du, 0x18637F41FCAD31B7u },
+    { 0xA0D7D42194CB810Au, 0x1382CC34CA2427C5u }, { 0x67BFB9CF5478CE77u, 0x1F37AD21436D0C6Fu },
+    { 0x1FCC94A5DD2D71F9u, 0x18F9574DCF8A7059u }, { 0x7FD6DD517DBDF4C7u, 0x13FAAC3E3FA1F37Au },
+    { 0xFFBE2EE8C92FEE0Bu, 0x1FF779FD329CB8C3u }, { 0x6631BF20A0F324D6u, 0x1992C7FDC216FA36u },
+    { 0xB827CC1A1A5C1D78u, 0x14756CCB01ABFB5Eu }, { 0x935309AE7B7CE460u, 0x105DF0A267BCC918u },
+    { 0x1EEB42B0C594A099u, 0x1A2FE76A3F9474F4u }, { 0xE58902270476E6E1u, 0x14F31F8832DD2A5Cu },
+    { 0xB7A0CE859D2BEBE7u, 0x10C27FA028B0EEB0u }, { 0x59014A6F61DFDFD8u, 0x1AD0CC33744E4AB4u },
+    { 0xE0CDD525E7E64CADu, 0x1573D68F903EA229u }, { 0x4D7177518651D6F1u, 0x11297872D9CBB4EEu },
+    { 0x7BE8BEE8D6E957E8u, 0x1B758D848FAC54B0u }, { 0xFCBA3253DF211320u, 0x15F7A46A0C89DD59u },
+    { 0x63C8284318E74280u, 0x1192E9EE706E4AAEu }, { 0x060D0D3827D86A66u, 0x1C1E43171A4A1117u },
+    { 0x6B3DA42CECAD21EBu, 0x167E9C127B6E7412u }, { 0x88FE1CF0BD574E56u, 0x11FEE341FC585CDBu },
+    { 0x419694B462254A23u, 0x1CCB0536608D615Fu }, { 0x67ABAA29E81DD4E9u, 0x1708D0F84D3DE77Fu },
+    { 0xB95621BB2017DD87u, 0x126D73F9D764B932u }, { 0xC223692B668C95A5u, 0x1D7BECC2F23AC1EAu },
+    { 0xCE82BA891ED6DE1Du, 0x179657025B6234BBu }, { 0xA53562074BDF1818u, 0x12DEAC01E2B4F6FCu },
+    { 0x3B889CD87964F359u, 0x1E3113363787F194u }, { 0xFC6D4A46C783F5E1u, 0x18274291C6065ADCu },
+    { 0x30576E9F06032B1Au, 0x13529BA7D19EAF17u }, { 0x1A257DCB3CD1DE90u, 0x1EEA92A61C311825u },
+    { 0x481DFE3C30A7E540u, 0x18BBA884E35A79B7u }, { 0xD34B31C9C0865100u, 0x13C9539D82AEC7C5u },
+    { 0x5211E942CDA3B4CDu, 0x1FA885C8D117A609u }, { 0x74DB21023E1C90A4u, 0x19539E3A40DFB807u },
+    { 0xF715B401CB4A0D50u, 0x1442E4FB67196005u }, { 0xF8DE299B09080AA7u, 0x103583FC527AB337u },
+    { 0x8E304291A80CDDD7u, 0x19EF3993B72AB859u }, { 0x3E8D020E200A4B13u, 0x14BF6142F8EEF9E1u },
+    { 0x653D9B3E80083C0Fu, 0x10991A9BFA58C7E7u }, { 0x6EC8F864000D2CE4u, 0x1A8E90F9908E0CA5u },
+    { 0x8BD3F9E999A423EAu, 0x153EDA614071A3B7u }, { 0x3CA994BAE1501CBBu, 0x10FF151A99F482F9u },
+    { 0xC775BAC49BB3612Bu, 0x1B31BB5DC320D18Eu }, { 0xD2C4956A16291A89u, 0x15C162B168E70E0Bu },
+    { 0xDBD0778811BA7BA1u, 0x11678227871F3E6Fu }, { 0x2C80BF401C5D929Bu, 0x1BD8D03F3E9863E6u },
+    { 0xBD33CC3349E47549u, 0x16470CFF6546B651u }, { 0xCA8FD68F6E505DD4u, 0x11D270CC51055EA7u },
+    { 0x4419574BE3B3C953u, 0x1C83E7AD4E6EFDD9u }, { 0x0347790982F63AA9u, 0x16CFEC8AA52597E1u },
+    { 0xCF6C60D468C4FBBAu, 0x123FF06EEA847980u }, { 0xE57A34870E07F92Au, 0x1D331A4B10D3F59Au },
+    { 0x512E906C0B399422u, 0x175C1508DA432AE2u }, { 0xDA8BA6BCD5C7A9B5u, 0x12B010D3E1CF5581u },
+    { 0x90DF712E22D90F87u, 0x1DE6815302E5559Cu }, { 0xDA4C5A8B4F140C6Cu, 0x17EB9AA8CF1DDE16u },
+    { 0xAEA37BA2A5A9A38Au, 0x1322E220A5B17E78u }, { 0x7DD25F6AA2A905A9u, 0x1E9E369AA2B59727u },
+    { 0x97DB7F888220D154u, 0x187E92154EF7AC1Fu }, { 0x797C6606CE80A777u, 0x139874DDD8C6234Cu },
+    { 0x8F2D700AE4010BF1u, 0x1F5A549627A36BADu }, { 0x0C2459A25000D65Au, 0x191510781FB5EFBEu },
+    { 0x701D1481D99A4515u, 0x1410D9F9B2F7F2FEu }, { 0xC017439B147B6A77u, 0x100D7B2E28C65BFEu },
+    { 0xCCF205C4ED9243F2u, 0x19AF2B7D0E0A2CCAu }, { 0x0A5B37D0BE0E9CC2u, 0x148C22CA71A1BD6Fu },
+    { 0x0848F973CB3EE3CEu, 0x10701BD527B4978Cu }, { 0xDA0E5BEC78649FB0u, 0x1A4CF9550C5425ACu },
+    { 0x7B3EAFF060507FC0u, 0x150A6110D6A9B7BDu }, { 0x95CBBFF380406633u, 0x10D51A73DEEE2C97u },
+    { 0xEFAC665266CD7052u, 0x1AEE90B964B04758u }, { 0x2623850EB8A459DBu, 0x158BA6FAB6F36C47u },
+    { 0x1E82D0D893B6AE49u, 0x113C85955F29236Cu }, { 0xFD9E1AF41F8AB075u, 0x1B9408EEFEA838ACu },
+    { 0x97B1AF29B2D559F7u, 0x16100725988693BDu }, { 0xAC8E25BAF5777B2Cu, 0x11A66C1E139EDC97u },
+    { 0x7A7D092B2258C513u, 0x1C3D79C9B8FE2DBFu }, { 0x61FDA0EF4EAD6A76u, 0x169794A160CB57CCu },
+    { 0xE7FE1A590BBDEEC5u, 0x1212DD4DE7091309u }, { 0xA6635D5B45FCB13Au, 0x1CEAFBAFD80E84DCu },
+    { 0x851C4AAF6B308DC8u, 0x172262F3133ED0B0u }, { 0xD0E36EF2BC26D7D4u, 0x1281E8C275CBDA26u },
+    { 0xB49F17EAC6A48C86u, 0x1D9CA79D894629D7u }, { 0x2A18DFEF0550706Bu, 0x17B08617A104EE46u },
+    { 0x54E0B3259DD9F389u, 0x12F39E794D9D8B6Bu }, { 0x87CDEB6F62F65274u, 0x1E5297287C2F4578u },
+    { 0xD30B22BF825EA85Du, 0x18421286C9BF6AC6u }, { 0x0F3C1BCC684BB9E4u, 0x13680ED23AFF889Fu },
+    { 0x18602C7A4079296Du, 0x1F0CE4839198DA98u }, { 0x46B356C833942124u, 0x18D71D360E13E213u },
+    { 0x388F78A029434DB6u, 0x13DF4A91A4DCB4DCu }, { 0x5A7F2766A86BAF8Au, 0x1FCBAA82A1612160u },
+    { 0x153285EBB9EFBFA2u, 0x196FBB9BB44DB44Du }, { 0xAA8ED189618C994Eu, 0x145962E2F6A4903Du },
+    { 0xEED8A7A11AD6E10Cu, 0x1047824F2BB6D9CAu }, { 0x7E27729B5E249B45u, 0x1A0C03B1DF8AF611u },
+    { 0xFE85F549181D4904u, 0x14D6695B193BF80Du }, { 0xCB9E5DD4134AA0D0u, 0x10AB877C142FF9A4u },
+    { 0xDF63C9535211014Du, 0x1AAC0BF9B9E65C3Au }, { 0x191CA10F74DA6771u, 0x15566FFAFB1EB02Fu },
+    { 0xADB080D92A4852C1u, 0x1111F32F2F4BC025u }, { 0x15E7348EAA0D5134u, 0x1B4FEB7EB212CD09u },
+    { 0xAB1F5D3EEE710DC4u, 0x15D98932280F0A6Du }, { 0xBC1917658B8DA49Du, 0x117AD428200C0857u },
+    { 0x2CF4F23C127C3A94u, 0x1BF7B9D9CCE00D59u }, { 0xF0C3F4FCDB969543u, 0x165FC7E170B33DE0u },
+    { 0x5A365D9716121103u, 0x11E6398126F5CB1Au }, { 0x9056FC24F01CE804u, 0x1CA38F350B22DE90u },
+    { 0xD9DF301D8CE3ECD0u, 0x16E93F5DA2824BA6u }, { 0xE17F59B13D8323DAu, 0x125432B14ECEA2EBu },
+    { 0x68CBC2B52F38395Cu, 0x1D53844EE47DD179u }, { 0x53D6355DBF602DE3u, 0x177603725064A794u },
+    { 0xA9782AB165E68B1Cu, 0x12C4CF8EA6B6EC76u }, { 0x0F26AAB56FD744FAu, 0x1E07B27DD78B13F1u },
+    { 0x3F52222ABFDF6A62u, 0x18062864AC6F4327u }, { 0x65DB4E88997F884Eu, 0x1338205089F29C1Fu },
+    { 0x6FC54A7428CC0D4Au, 0x1EC033B40FEA9365u }, { 0x596AA1F68709A43Bu, 0x1899C2F673220F84u },
+    { 0xADEEE7F86C07B696u, 0x13AE3591F5B4D936u }, { 0x497E3FF3E00C5756u, 0x1F7D228322BAF524u },
+    { 0xD464FFF64CD6AC45u, 0x1930E868E89590E9u }, { 0x4383FFF83D7889D1u, 0x14272053ED4473EEu },
+    { 0xCF9CCCC69793A174u, 0x101F4D0FF1038FF1u }, { 0x7F6147A425B90252u, 0x19CBAE7FE805B31Cu },
+    { 0xCC4DD2E9B7C7350Fu, 0x14A2F1FFECD15C16u }, { 0x3D0B0F215FD290D9u, 0x10825B3323DAB012u },
+    { 0x61AB4B689950E7C1u, 0x1A6A2B85062AB350u }, { 0x4E22A2BA1440B967u, 0x1521BC6A6B555C40u },
+    { 0x0B4EE894DD009453u, 0x10E7C9EEBC4449CDu }, { 0x1217DA87C800ED51u, 0x1B0C764AC6D3A948u },
+    { 0xDB46486CA000BDDAu, 0x15A391D56BDC876Cu }, { 0x490506BD4CCD64AFu, 0x114FA7DDEFE39F8Au },
+    { 0xA8080AC87AE23AB1u, 0x1BB2A62FE638FF43u }, { 0x5339A239FBE82EF4u, 0x162884F31E93FF69u },
+    { 0x75C7B4FB2FECF25Du, 0x11BA03F5B20FFF87u }, { 0x22D92191E647EA2Eu, 0x1C5CD322B67FFF3Fu },
+    { 0xB57A8141850654F2u, 0x16B0A8E891FFFF65u }, { 0xC4620101373843F5u, 0x1226ED86DB3332B7u },
+    { 0x3A366801F1F39FEEu, 0x1D0B15A491EB8459u }, { 0xFB5EB99B27F6198Bu, 0x173C115074BC69E0u },
+    { 0x2F7EFAE2865E7AD6u, 0x129674405D6387E7u }, { 0xE597F7D0D6FD9156u, 0x1DBD86CD6238D971u },
+    { 0x8479930D78CADAABu, 0x17CAD23DE82D7AC1u }, { 0xD06142712D6F1556u, 0x1308A831868AC89Au },
+    { 0x4D686A4EAF182222u, 0x1E74404F3DAADA91u }, { 0xA453883EF279B4E8u, 0x185D003F6488AEDAu },
+    { 0xE9DC6CFF28615D87u, 0x137D99CC506D58AEu }, { 0xA960AE650D6895A4u, 0x1F2F5C7A1A488DE4u },
+    { 0xBAB3BEB73DED4483u, 0x18F2B061AEA07183u }, { 0x2EF6322C318A9D36u, 0x13F559E7BEE6C136u }
+};
+
+static const uint64_t pow5_split[326][2] = {
+    { 0x0000000000000000u, 0x1000000000000000u }, { 0x0000000000000000u, 0x1400000000000000u },
+    { 0x0000000000000000u, 0x1900000000000000u }, { 0x0000000000000000u, 0x1F40000000000000u },
+    { 0x0000000000000000u, 0x1388000000000000u }, { 0x0000000000000000u, 0x186A000000000000u },
+    { 0x0000000000000000u, 0x1E84800000000000u }, { 0x0000000000000000u, 0x1312D00000000000u },
+    { 0x0000000000000000u, 0x17D7840000000000u }, { 0x0000000000000000u, 0x1DCD650000000000u },
+    { 0x0000000000000000u, 0x12A05F2000000000u }, { 0x0000000000000000u, 0x174876E800000000u },
+    { 0x0000000000000000u, 0x1D1A94A200000000u }, { 0x0000000000000000u, 0x12309CE540000000u },
+    { 0x0000000000000000u, 0x16BCC41E90000000u }, { 0x0000000000000000u, 0x1C6BF52634000000u },
+    { 0x0000000000000000u, 0x11C37937E0800000u }, { 0x0000000000000000u, 0x16345785D8A00000u },
+    { 0x0000000000000000u, 0x1BC16D674EC80000u }, { 0x0000000000000000u, 0x1158E460913D0000u },
+    { 0x0000000000000000u, 0x15AF1D78B58C4000u }, { 0x0000000000000000u, 0x1B1AE4D6E2EF5000u },
+    { 0x0000000000000000u, 0x10F0CF064DD59200u }, { 0x0000000000000000u, 0x152D02C7E14AF680u },
+    { 0x0000000000000000u, 0x1A784379D99DB420u }, { 0x0000000000000000u, 0x108B2A2C28029094u },
+    { 0x0000000000000000u, 0x14ADF4B7320334B9u }, { 0x4000000000000000u, 0x19D971E4FE8401E7u },
+    { 0x8800000000000000u, 0x1027E72F1F128130u }, { 0xAA00000000000000u, 0x1431E0FAE6D7217Cu },
+    { 0xD480000000000000u, 0x193E5939A08CE9DBu }, { 0xC9A0000000000000u, 0x1F8DEF8808B02452u },
+    { 0xBE04000000000000u, 0x13B8B5B5056E16B3u }, { 0xAD85000000000000u, 0x18A6E32246C99C60u },
+    { 0xD8E6400000000000u, 0x1ED09BEAD87C0378u }, { 0x878FE80000000000u, 0x13426172C74D822Bu },
+    { 0x6973E20000000000u, 0x1812F9CF7920E2B6u }, { 0x03D0DA8000000000u, 0x1E17B84357691B64u },
+    { 0x8262889000000000u, 0x12CED32A16A1B11Eu }, { 0x22FB2AB400000000u, 0x178287F49C4A1D66u },
+    { 0xABB9F56100000000u, 0x1D6329F1C35CA4BFu }, { 0xCB54395CA0000000u, 0x125DFA371A19E6F7u },
+    { 0xBE2947B3C8000000u, 0x16F578C4E0A060B5u }, { 0x2DB399A0BA000000u, 0x1CB2D6F618C878E3u },
+    { 0xFC90400474400000u, 0x11EFC659CF7D4B8Du }, { 0x7BB4500591500000u, 0x166BB7F0435C9E71u },
+    { 0xDAA16406F5A40000u, 0x1C06A5EC5433C60Du }, { 0xA8A4DE8459868000u, 0x118427B3B4A05BC8u },
+    { 0xD2CE16256FE82000u, 0x15E531A0A1C872BAu }, { 0x87819BAECBE22800u, 0x1B5E7E08CA3A8F69u },
+    { 0xF4B1014D3F6D5900u, 0x111B0EC57E6499A1u }, { 0x71DD41A08F48AF40u, 0x1561D276DDFDC00Au },
+    { 0x0E549208B31ADB10u, 0x1ABA4714957D300Du }, { 0x28F4DB456FF0C8EAu, 0x10B46C6CDD6E3E08u },
+    { 0x33321216CBECFB24u, 0x14E1878814C9CD8Au }, { 0xBFFE969C7EE839EDu, 0x1A19E96A19FC40ECu },
+    { 0xF7FF1E21CF512434u, 0x105031E2503DA893u }, { 0xF5FEE5AA43256D41u, 0x14643E5AE44D12B8u },
+    { 0x337E9F14D3EEC892u, 0x197D4DF19D605767u }, { 0x005E46DA08EA7AB6u, 0x1FDCA16E04B86D41u },
+    { 0xA03AEC4845928CB2u, 0x13E9E4E4C2F34448u }, { 0xC849A75A56F72FDEu, 0x18E45E1DF3B0155Au },
+    { 0x7A5C1130ECB4FBD6u, 0x1F1D75A5709C1AB1u }, { 0xEC798ABE93F11D65u, 0x13726987666190AEu },
+    { 0xA797ED6E38ED64BFu, 0x184F03E93FF9F4DAu }, { 0x517DE8C9C728BDEFu, 0x1E62C4E38FF87211u },
+    { 0xD2EEB17E1C7976B5u, 0x12FDBB0E39FB474Au }, { 0x87AA5DDDA397D462u, 0x17BD29D1C87A191Du },
+    { 0xE994F5550C7DC97Bu, 0x1DAC74463A989F64u }, { 0x11FD195527CE9DEDu, 0x128BC8ABE49F639Fu },
+    { 0xD67C5FAA71C24568u, 0x172EBAD6DDC73C86u }, { 0x8C1B77950E32D6C2u, 0x1CFA698C95390BA8u },
+    { 0x57912ABD28DFC639u, 0x121C81F7DD43A749u }, { 0xAD75756C7317B7C8u, 0x16A3A275D494911Bu },
+    { 0x98D2D2C78FDDA5BAu, 0x1C4C8B1349B9B562u }, { 0x9F83C3BCB9EA8794u, 0x11AFD6EC0E14115Du },
+    { 0x0764B4ABE8652979u, 0x161BCCA7119915B5u }, { 0x493DE1D6E27E73D7u, 0x1BA2BFD0D5FF5B22u },
+    { 0x6DC6AD264D8F0866u, 0x1145B7E285BF98F5u }, { 0xC938586FE0F2CA80u, 0x159725DB272F7F32u },
+    { 0x7B866E8BD92F7D20u, 0x1AFCEF51F0FB5EFFu }, { 0xAD34051767BDAE34u, 0x10DE1593369D1B5Fu },
+    { 0x9881065D41AD19C1u, 0x15159AF804446237u }, { 0x7EA147F492186032u, 0x1A5B01B605557AC5u },
+    { 0x6F24CCF8DB4F3C1Fu, 0x1078E111C3556CBBu }, { 0x4AEE003712230B27u, 0x14971956342AC7EAu },
+    { 0xDDA98044D6ABCDF0u, 0x19BCDFABC13579E4u }, { 0x0A89F02B062B60B6u, 0x10160BCB58C16C2Fu },
+    { 0xCD2C6C35C7B638E4u, 0x141B8EBE2EF1C73Au }, { 0x8077874339A3C71Du, 0x1922726DBAAE3909u },
+    { 0xE0956914080CB8E4u, 0x1F6B0F092959C74Bu }, { 0x6C5D61AC8507F38Eu, 0x13A2E965B9D81C8Fu },
+    { 0x4774BA17A649F072u, 0x188BA3BF284E23B3u }, { 0x1951E89D8FDC6C8Fu, 0x1EAE8CAEF261ACA0u },
+    { 0x0FD3316279E9C3D9u, 0x132D17ED577D0BE4u }, { 0x13C7FDBB186434CFu, 0x17F85DE8AD5C4EDDu },
+    { 0x58B9FD29DE7D4203u, 0x1DF67562D8B36294u }, { 0xB7743E3A2B0E4942u, 0x12BA095DC7701D9Cu },
+    { 0xE5514DC8B5D1DB92u, 0x17688BB5394C2503u }, { 0xDEA5A13AE3465277u, 0x1D42AEA2879F2E44u },
+    { 0x0B2784C4CE0BF38Au, 0x1249AD2594C37CEBu }, { 0xCDF165F6018EF06Du, 0x16DC186EF9F45C25u },
+    { 0x416DBF7381F2AC88u, 0x1C931E8AB871732Fu }, { 0x88E497A83137ABD5u, 0x11DBF316B346E7FDu },
+    { 0xEB1DBD923D8596CAu, 0x1652EFDC6018A1FCu }, { 0x25E52CF6CCE6FC7Du, 0x1BE7ABD3781ECA7Cu },
+    { 0x97AF3C1A40105DCEu, 0x1170CB642B133E8Du }, { 0xFD9B0B20D0147542u, 0x15CCFE3D35D80E30u },
+    { 0x3D01CDE904199292u, 0x1B403DCC834E11BDu }, { 0x462120B1A28FFB9Bu, 0x1108269FD210CB16u },
+    { 0xD7A968DE0B33FA82u, 0x154A3047C694FDDBu }, { 0xCD93C3158E00F923u, 0x1A9CBC59B83A3D52u },
+    { 0xC07C59ED78C09BB6u, 0x10A1F5B813246653u }, { 0xB09B7068D6F0C2A3u, 0x14CA732617ED7FE8u },
+    { 0xDCC24C830CACF34Cu, 0x19FD0FEF9DE8DFE2u }, { 0xC9F96FD1E7EC180Fu, 0x103E29F5C2B18BEDu },
+    { 0x3C77CBC661E71E13u, 0x144DB473335DEEE9u }, { 0x8B95BEB7FA60E598u, 0x1961219000356AA3u },
+    { 0x6E7B2E65F8F91EFEu, 0x1FB969F40042C54Cu }, { 0xC50CFCFFBB9BB35Fu, 0x13D3E2388029BB4Fu },
+    { 0xB6503C3FAA82A037u, 0x18C8DAC6A0342A23u }, { 0xA3E44B4F95234844u, 0x1EFB1178484134ACu },
+    { 0xE66EAF11BD360D2Bu, 0x135CEAEB2D28C0EBu }, { 0xE00A5AD62C839075u, 0x183425A5F872F126u },
+    { 0x980CF18BB7A47493u, 0x1E412F0F768FAD70u }, { 0x5F0816F752C6C8DCu, 0x12E8BD69AA19CC66u },
+    { 0xF6CA1CB527787B13u, 0x17A2ECC414A03F7Fu }, { 0xF47CA3E2715699D7u, 0x1D8BA7F519C84F5Fu },
+    { 0xF8CDE66D86D62026u, 0x127748F9301D319Bu }, { 0xF7016008E88BA830u, 0x17151B377C247E02u },
+    { 0xB4C1B80B22AE923Cu, 0x1CDA62055B2D9D83u }, { 0x50F91306F5AD1B65u, 0x12087D4358FC8272u },
+    { 0xE53757C8B318623Fu, 0x168A9C942F3BA30Eu }, { 0x9E852DBADFDE7ACFu, 0x1C2D43B93B0A8BD2u },
+    { 0xA3133C94CBEB0CC1u, 0x119C4A53C4E69763u }, { 0x8BD80BB9FEE5CFF1u, 0x16035CE8B6203D3Cu },
+    { 0xAECE0EA87E9F43EEu, 0x1B843422E3A84C8Bu }, { 0x4D40C9294F238A75u, 0x1132A095CE492FD7u },
+    { 0x2090FB73A2EC6D12u, 0x157F48BB41DB7BCDu }, { 0x68B53A508BA78856u, 0x1ADF1AEA12525AC0u },
+    { 0x417144725748B536u, 0x10CB70D24B7378B8u }, { 0x51CD958EED1AE283u, 0x14FE4D06DE5056E6u },
+    { 0xE640FAF2A8619B24u, 0x1A3DE04895E46C9Fu }, { 0xEFE89CD7A93D00F7u, 0x1066AC2D5DAEC3E3u },
+    { 0xEBE2C40D938C4134u, 0x14805738B51A74DCu }, { 0x26DB7510F86F5181u, 0x19A06D06E2611214u },
+    { 0x9849292A9B4592F1u, 0x100444244D7CAB4Cu }, { 0xBE5B73754216F7ADu, 0x1405552D60DBD61Fu },
+    { 0xADF25052929CB598u, 0x1906AA78B912CBA7u }, { 0x996EE4673743E2FFu, 0x1F485516E7577E91u },
+    { 0xFFE54EC0828A6DDFu, 0x138D352E5096AF1Au }, { 0xBFDEA270A32D0957u, 0x18708279E4BC5AE1u },
+    { 0x2FD64B0CCBF84BADu, 0x1E8CA3185DEB719Au }, { 0x5DE5EEE7FF7B2F4Cu, 0x1317E5EF3AB32700u },
+    { 0x755F6AA1FF59FB1Fu, 0x17DDDF6B095FF0C0u }, { 0x92B7454A7F3079E7u, 0x1DD55745CBB7ECF0u },
+    { 0x5BB28B4E8F7E4C30u, 0x12A5568B9F52F416u }, { 0xF29F2E22335DDF3Cu, 0x174EAC2E8727B11Bu },
+    { 0xEF46F9AAC035570Bu, 0x1D22573A28F19D62u }, { 0xD58C5C0AB8215667u, 0x123576845997025Du },
+    { 0x4AEF730D6629AC01u, 0x16C2D4256FFCC2F5u }, { 0x9DAB4FD0BFB41701u, 0x1C73892ECBFBF3B2u },
+    { 0xA28B11E277D08E60u, 0x11C835BD3F7D784Fu }, { 0x8B2DD65B15C4B1F9u, 0x163A432C8F5CD663u },
+    { 0x6DF94BF1DB35DE77u, 0x1BC8D3F7B3340BFCu }, { 0xC4BBCF772901AB0Au, 0x115D847AD000877Du },
+    { 0x35EAC354F34215CDu, 0x15B4E5998400A95Du }, { 0x8365742A30129B40u, 0x1B221EFFE500D3B4u },
+    { 0xD21F689A5E0BA108u, 0x10F5535FEF208450u }, { 0x06A742C0F58E894Au, 0x1532A837EAE8A565u },
+    { 0x4851137132F22B9Du, 0x1A7F5245E5A2CEBEu }, { 0xED32AC26BFD75B42u, 0x108F936BAF85C136u },
+    { 0xA87F57306FCD3212u, 0x14B378469B673184u }, { 0xD29F2CFC8BC07E97u, 0x19E056584240FDE5u },
+    { 0xA3A37C1DD7584F1Eu, 0x102C35F729689EAFu }, { 0x8C8C5B254D2E62E6u, 0x14374374F3C2C65Bu },
+    { 0x6FAF71EEA079FB9Fu, 0x1945145230B377F2u }, { 0x0B9B4E6A48987A87u, 0x1F965966BCE055EFu },
+    { 0x674111026D5F4C94u, 0x13BDF7E0360C35B5u }, { 0xC111554308B71FBAu, 0x18AD75D8438F4322u },
+    { 0x7155AA93CAE4E7A8u, 0x1ED8D34E547313EBu }, { 0x26D58A9C5ECF10C9u, 0x13478410F4C7EC73u },
+    { 0xF08AED437682D4FBu, 0x1819651531F9E78Fu }, { 0xECADA89454238A3Au, 0x1E1FBE5A7E786173u },
+    { 0x73EC895CB4963664u, 0x12D3D6F88F0B3CE8u }, { 0x90E7ABB3E1BBC3FDu, 0x1788CCB6B2CE0C22u },
+    { 0x352196A0DA2AB4FDu, 0x1D6AFFE45F818F2Bu }, { 0x0134FE24885AB11Eu, 0x1262DFEEBBB0F97Bu },
+    { 0xC1823DADAA715D65u, 0x16FB97EA6A9D37D9u }, { 0x31E2CD19150DB4BFu, 0x1CBA7DE5054485D0u },
+    { 0x1F2DC02FAD2890F7u, 0x11F48EAF234AD3A2u }, { 0xA6F9303B9872B535u, 0x1671B25AEC1D888Au },
+    { 0x50B77C4A7E8F6282u, 0x1C0E1EF1A724EAADu }, { 0x5272ADAE8F199D91u, 0x1188D357087712ACu },
+    { 0x670F591A32E004F6u, 0x15EB082CCA94D757u }, { 0x40D32F60BF980633u, 0x1B65CA37FD3A0D2Du },
+    { 0x4883FD9C77BF03E0u, 0x111F9E62FE44483Cu }, { 0x5AA4FD0395AEC4D8u, 0x156785FBBDD55A4Bu },
+    { 0x314E3C447B1A760Eu, 0x1AC1677AAD4AB0DEu }, { 0xDED0E5AACCF089C9u, 0x10B8E0ACAC4EAE8Au },
+    { 0x96851F15802CAC3Bu, 0x14E718D7D7625A2Du }, { 0xFC2666DAE037D74Au, 0x1A20DF0DCD3AF0B8u },
+    { 0x9D980048CC22E68Eu, 0x10548B68A044D673u }, { 0x84FE005AFF2BA032u, 0x1469AE42C8560C10u },
+    { 0xA63D8071BEF6883Eu, 0x198419D37A6B8F14u }, { 0xCFCCE08E2EB42A4Eu, 0x1FE52048590672D9u },
+    { 0x21E00C58DD309A70u, 0x13EF342D37A407C8u }, { 0x2A580F6F147CC10Du, 0x18EB0138858D09BAu },
+    { 0xB4EE134AD99BF150u, 0x1F25C186A6F04C28u }, { 0x7114CC0EC80176D2u, 0x137798F428562F99u },
+    { 0xCD59FF127A01D486u, 0x18557F31326BBB7Fu }, { 0xC0B07ED7188249A8u, 0x1E6ADEFD7F06AA5Fu },
+    { 0xD86E4F466F516E09u, 0x1302CB5E6F642A7Bu }, { 0xCE89E3180B25C98Bu, 0x17C37E360B3D351Au },
+    { 0x822C5BDE0DEF3BEEu, 0x1DB45DC38E0C8261u }, { 0xF15BB96AC8B58575u, 0x1290BA9A38C7D17Cu },
+    { 0x2DB2A7C57AE2E6D2u, 0x1734E940C6F9C5DCu }, { 0x391F51B6D99BA086u, 0x1D022390F8B83753u },
+    { 0x03B3931248014454u, 0x1221563A9B732294u }, { 0x04A077D6DA019569u, 0x16A9ABC9424FEB39u },
+    { 0x45C895CC9081FAC3u, 0x1C5416BB92E3E607u }, { 0x8B9D5D9FDA513CBAu, 0x11B48E353BCE6FC4u },
+    { 0xAE84B507D0E58BE8u, 0x1621B1C28AC20BB5u }, { 0x1A25E249C51EEEE3u, 0x1BAA1E332D728EA3u },
+    { 0xF057AD6E1B33554Du, 0x114A52DFFC679925u }, { 0x6C6D98C9A2002AA1u, 0x159CE797FB817F6Fu },
+    { 0x4788FEFC0A803549u, 0x1B04217DFA61DF4Bu }, { 0x0CB59F5D8690214Eu, 0x10E294EEBC7D2B8Fu },
+    { 0xCFE30734E83429A1u, 0x151B3A2A6B9C7672u }, { 0x83DBC9022241340Au, 0x1A6208B50683940Fu },
+    { 0xB2695DA15568C086u, 0x107D457124123C89u }, { 0x1F03B509AAC2F0A7u, 0x149C96CD6D16CBACu },
+    { 0x26C4A24C1573ACD1u, 0x19C3BC80C85C7E97u }, { 0x783AE56F8D684C03u, 0x101A55D07D39CF1Eu },
+    { 0x16499ECB70C25F03u, 0x1420EB449C8842E6u }, { 0x9BDC067E4CF2F6C4u, 0x19292615C3AA539Fu },
+    { 0x82D3081DE02FB476u, 0x1F736F9B3494E887u }, { 0xB1C3E512AC1DD0C9u, 0x13A825C100DD1154u },
+    { 0xDE34DE57572544FCu, 0x18922F31411455A9u }, { 0x55C215ED2CEE963Bu, 0x1EB6BAFD91596B14u },
+    { 0xB5994DB43C151DE5u, 0x133234DE7AD7E2ECu }, { 0xE2FFA1214B1A655Eu, 0x17FEC216198DDBA7u },
+    { 0xDBBF89699DE0FEB6u, 0x1DFE729B9FF15291u }, { 0x2957B5E202AC9F31u, 0x12BF07A143F6D39Bu },
+    { 0xF3ADA35A8357C6FEu, 0x176EC98994F48881u }, { 0x70990C31242DB8BDu, 0x1D4A7BEBFA31AAA2u },
+    { 0x865FA79EB69C9376u, 0x124E8D737C5F0AA5u }, { 0xE7F791866443B854u, 0x16E230D05B76CD4Eu },
+    { 0xA1F575E7FD54A669u, 0x1C9ABD04725480A2u }, { 0xA53969B0FE54E801u, 0x11E0B622C774D065u },
+    { 0x0E87C41D3DEA2202u, 0x1658E3AB7952047Fu }, { 0xD229B5248D64AA82u, 0x1BEF1C9657A6859Eu },
+    { 0x435A1136D85EEA91u, 0x117571DDF6C81383u }, { 0x143095848E76A536u, 0x15D2CE55747A1864u },
+    { 0x193CBAE5B2144E83u, 0x1B4781EAD1989E7Du }, { 0x2FC5F4CF8F4CB112u, 0x110CB132C2FF630Eu },
+    { 0xBBB77203731FDD56u, 0x154FDD7F73BF3BD1u }, { 0x2AA54E844FE7D4ACu, 0x1AA3D4DF50AF0AC6u },
+    { 0xDAA75112B1F0E4EBu, 0x10A6650B926D66BBu }, { 0xD15125575E6D1E26u, 0x14CFFE4E7708C06Au },
+    { 0x85A56EAD360865B0u, 0x1A03FDE214CAF085u }, { 0x7387652C41C53F8Eu, 0x10427EAD4CFED653u },
+    { 0x50693E7752368F71u, 0x14531E58A03E8BE8u }, { 0x64838E1526C4334Eu, 0x1967E5EEC84E2EE2u },
+    { 0xFDA4719A70754022u, 0x1FC1DF6A7A61BA9Au }, { 0xDE86C70086494815u, 0x13D92BA28C7D14A0u },
+    { 0x162878C0A7DB9A1Au, 0x18CF768B2F9C59C9u }, { 0x5BB296F0D1D280A1u, 0x1F03542DFB83703Bu },
+    { 0x194F9E5683239064u, 0x1362149CBD322625u }, { 0x5FA385EC23EC747Eu, 0x183A99C3EC7EAFAEu },
+    { 0xF78C67672CE7919Du, 0x1E494034E79E5B99u }, { 0x3AB7C0A07C10BB02u, 0x12EDC82110C2F940u },
+    { 0x4965B0C89B14E9C3u, 0x17A93A2954F3B790u }, { 0x5BBF1CFAC1DA2433u, 0x1D9388B3AA30A574u },
+    { 0xB957721CB92856A0u, 0x127C35704A5E6768u }, { 0xE7AD4EA3E7726C48u, 0x171B42CC5CF60142u },
+    { 0xA198A24CE14F075Au, 0x1CE2137F74338193u }, { 0x44FF65700CD16498u, 0x120D4C2FA8A030FCu },
+    { 0x563F3ECC1005BDBEu, 0x16909F3B92C83D3Bu }, { 0x2BCF0E7F14072D2Eu, 0x1C34C70A777A4C8Au },
+    { 0x5B61690F6C847C3Du, 0x11A0FC668AAC6FD6u }, { 0xF239C35347A59B4Cu, 0x16093B802D578BCBu },
+    { 0xEEC83428198F021Fu, 0x1B8B8A6038AD6EBEu }, { 0x553D20990FF96153u, 0x1137367C236C6537u },
+    { 0x2A8C68BF53F7B9A8u, 0x1585041B2C477E85u }, { 0x752F82EF28F5A812u, 0x1AE64521F7595E26u },
+    { 0x093DB1D57999890Bu, 0x10CFEB353A97DAD8u }, { 0x0B8D1E4AD7FFEB4Eu, 0x1503E602893DD18Eu },
+    { 0x8E7065DD8DFFE622u, 0x1A44DF832B8D45F1u }, { 0xF9063FAA78BFEFD5u, 0x106B0BB1FB384BB6u },
+    { 0xB747CF9516EFEBCAu, 0x1485CE9E7A065EA4u }, { 0xE519C37A5CABE6BDu, 0x19A742461887F64Du },
+    { 0xAF301A2C79EB7036u, 0x1008896BCF54F9F0u }, { 0xDAFC20B798664C43u, 0x140AABC6C32A386Cu },
+    { 0x11BB28E57E7FDF54u, 0x190D56B873F4C688u }, { 0x1629F31EDE1FD72Au, 0x1F50AC6690F1F82Au },
+    { 0x4DDA37F34AD3E67Au, 0x13926BC01A973B1Au }, { 0xE150C5F01D88E019u, 0x187706B0213D09E0u },
+    { 0x19A4F76C24EB181Fu, 0x1E94C85C298C4C59u }, { 0xB0071AA39712EF13u, 0x131CFD3999F7AFB7u },
+    { 0x9C08E14C7CD7AAD8u, 0x17E43C8800759BA5u }, { 0x030B199F9C0D958Eu, 0x1DDD4BAA0093028Fu },
+    { 0x61E6F003C1887D79u, 0x12AA4F4A405BE199u }, { 0xBA60AC04B1EA9CD7u, 0x1754E31CD072D9FFu },
+    { 0xA8F8D705DE65440Du, 0x1D2A1BE4048F907Fu }, { 0xC99B8663AAFF4A88u, 0x123A516E82D9BA4Fu },
+    { 0xBC0267FC95BF1D2Au, 0x16C8E5CA239028E3u }, { 0xAB0301FBBB2EE474u, 0x1C7B1F3CAC74331Cu },
+    { 0xEAE1E13D54FD4EC9u, 0x11CCF385EBC89FF1u }, { 0x659A598CAA3CA27Bu, 0x1640306766BAC7EEu },
+    { 0xFF00EFEFD4CBCB1Au, 0x1BD03C81406979E9u }, { 0x3F6095F5E4FF5EF0u, 0x116225D0C841EC32u },
+    { 0xCF38BB735E3F36ACu, 0x15BAAF44FA52673Eu }, { 0x8306EA5035CF0457u, 0x1B295B1638E7010Eu },
+    { 0x11E4527221A162B6u, 0x10F9D8EDE39060A9u }, { 0x565D670EAA09BB64u, 0x15384F295C7478D3u },
+    { 0x2BF4C0D2548C2A3Du, 0x1A8662F3B3919708u }, { 0x1B78F88374D79A66u, 0x1093FDD8503AFE65u },
+    { 0x625736A4520D8100u, 0x14B8FD4E6449BDFEu }, { 0xFAED044D6690E140u, 0x19E73CA1FD5C2D7Du },
+    { 0xBCD422B0601A8CC8u, 0x103085E53E599C6Eu }, { 0x6C092B5C78212FFAu, 0x143CA75E8DF0038Au },
+    { 0x070B763396297BF8u, 0x194BD136316C046Du }, { 0x48CE53C07BB3DAF6u, 0x1F9EC583BDC70588u },
+    { 0x2D80F4584D5068DAu, 0x13C33B72569C6375u }, { 0x78E1316E60A48310u, 0x18B40A4EEC437C52u }
+};
+
+// ceil(log2(5^e)) for 0 < e <= 3528, and 1 for e = 0.
+static int32_t pow5_bits(int32_t e) {
+    return (int32_t)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+// floor(log10(2^e)) for 0 <= e <= 1650.
+static uint32_t log10_pow2(int32_t e) {
+    return ((uint32_t)e * 78913) >> 18;
+}
+
+// floor(log10(5^e)) for 0 <= e <= 2620.
+static uint32_t log10_pow5(int32_t e) {
+    return ((uint32_t)e * 732923) >> 20;
+}
+
+static bool is_multiple_of_pow5(uint64_t value, uint32_t p) {
+    uint32_t count = 0;
+    while (count < p && value % 5 == 0) {
+        value /= 5;
+        ++count;
+    }
+    return count >= p;
+}
+
+static bool is_multiple_of_pow2(uint64_t value, uint32_t p) {
+    return (value & ((1ull << p) - 1)) == 0;
+}
+
+#if !defined(__SIZEOF_INT128__)
+// Low 64 bits of a * b, the high 64 bits are written to `*high`.
+static uint64_t multiply64(uint64_t a, uint64_t b, uint64_t* high) {
+    uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t)a, lb = (uint32_t)b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), carry = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    carry += lo < t;
+    *high = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+    return lo;
+}
+#endif
+
+// (m * mul) >> j, where mul = [low, high] is a 128-bit number and 64 <= j < 128.
+static uint64_t mul_shift64(uint64_t m, uint64_t const mul[2], int32_t j) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t b0 = (__uint128_t)m * mul[0];
+    __uint128_t b2 = (__uint128_t)m * mul[1];
+    return (uint64_t)(((b0 >> 64) + b2) >> (j - 64));
+#else
+    uint64_t high0, high1;
+    multiply64(m, mul[0], &high0);
+    uint64_t low1 = multiply64(m, mul[1], &high1);
+    uint64_t sum = high0 + low1;
+    high1 += sum < high0;
+    int32_t shift = j - 64;
+    return shift == 0 ? sum : (high1 << (64 - shift)) | (sum >> shift);
+#endif
+}
+
+// (m * factor) >> shift, where 32 <= shift < 96.
+static uint32_t mul_shift32(uint32_t m, uint64_t factor, int32_t shift) {
+    uint64_t bits0 = (uint64_t)m * (uint32_t)factor;
+    uint64_t bits1 = (uint64_t)m * (factor >> 32);
+    uint64_t sum = (bits0 >> 32) + bits1;
+    return (uint32_t)(sum >> (shift - 32));
+}
+
+// Shortest decimal `digits` * 10^`exponent` which reads back as the double of the given bits, which is finite and not zero.
+static void shortest_double(uint64_t mantissa_bits, uint32_t exponent_bits, uint64_t* digits, int32_t* exponent) {
+    int32_t e2;
+    uint64_t m2;
+    if (exponent_bits == 0) {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = mantissa_bits;
+    } else {
+        e2 = (int32_t)exponent_bits - 1023 - 52 - 2;
+        m2 = (1ull << 52) | mantissa_bits;
+    }
+    bool accept_bounds = (m2 & 1) == 0; // round-to-even when reading back
+    // The interval is [4 * m2 - 1 - mm_shift, 4 * m2 + 2] * 2^e2, its lower half is smaller at powers of 2.
+    uint64_t mv = 4 * m2;
+    uint32_t mm_shift = mantissa_bits != 0 || exponent_bits <= 1;
+
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    bool vm_is_trailing_zeros = false, vr_is_trailing_zeros = false;
+    if (e2 >= 0) {
+        uint32_t q = log10_pow2(e2) - (e2 > 3);
+        e10 = (int32_t)q;
+        int32_t k = 125 + pow5_bits((int32_t)q) - 1;
+        int32_t i = -e2 + (int32_t)q + k;
+        vr = mul_shift64(4 * m2, pow5_inv_split[q], i);
+        vp = mul_shift64(4 * m2 + 2, pow5_inv_split[q], i);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, pow5_inv_split[q], i);
+        if (q <= 21) {
+            // Only one of mp, mv and mm can be a multiple of 5, if any.
+            if (mv % 5 == 0)
+                vr_is_trailing_zeros = is_multiple_of_pow5(mv, q);
+            else if (accept_bounds)
+                vm_is_trailing_zeros = is_multiple_of_pow5(mv - 1 - mm_shift, q);
+            else
+                vp -= is_multiple_of_pow5(mv + 2, q);
+        }
+    } else {
+        uint32_t q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = (int32_t)q + e2;
+        int32_t i = -e2 - (int32_t)q;
+        int32_t k = pow5_bits(i) - 125;
+        int32_t j = (int32_t)q - k;
+        vr = mul_shift64(4 * m2, pow5_split[i], j);
+        vp = mul_shift64(4 * m2 + 2, pow5_split[i], j);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, pow5_split[i], j);
+        if (q <= 1) {
+            // mv = 4 * m2 has at least 2 trailing 0 bits.
+            vr_is_trailing_zeros = true;
+            if (accept_bounds)
+                vm_is_trailing_zeros = mm_shift == 1; // mm = mv - 1 - mm_shift has 1 trailing 0 bit iff mm_shift == 1
+            else
+                --vp; // mp = mv + 2 has at least 1 trailing 0 bit
+        } else if (q < 63) {
+            vr_is_trailing_zeros = is_multiple_of_pow2(mv, q);
+        }
+    }
+
+    // Remove digits while vp and vm differ, tracking the last removed digit of vr for rounding.
+    int32_t removed = 0;
+    unsigned last_removed_digit = 0;
+    uint64_t output;
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+        // Rare case: the bounds or the value may be exact decimals.
+        while (vp / 10 > vm / 10) {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = (unsigned)(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vm_is_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = (unsigned)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+            last_removed_digit = 4; // exactly halfway: round to even
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+    } else {
+        // Common case: two digits at a time first, as most doubles have 16 or 17 significant digits.
+        bool round_up = false;
+        if (vp / 100 > vm / 100) {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+    *digits = output;
+    *exponent = e10 + removed;
+}
+
+// Same as shortest_double for a float.
+static void shortest_float(uint32_t mantissa_bits, uint32_t exponent_bits, uint64_t* digits, int32_t* exponent) {
+    int32_t e2;
+    uint32_t m2;
+    if (exponent_bits == 0) {
+        e2 = 1 - 127 - 23 - 2;
+        m2 = mantissa_bits;
+    } else {
+        e2 = (int32_t)exponent_bits - 127 - 23 - 2;
+        m2 = (1u << 23) | mantissa_bits;
+    }
+    bool accept_bounds = (m2 & 1) == 0;
+    uint32_t mv = 4 * m2;
+    uint32_t mp = 4 * m2 + 2;
+    uint32_t mm_shift = mantissa_bits != 0 || exponent_bits <= 1;
+    uint32_t mm = 4 * m2 - 1 - mm_shift;
+
+    uint32_t vr, vp, vm;
+    int32_t e10;
+    bool vm_is_trailing_zeros = false, vr_is_trailing_zeros = false;
+    unsigned last_removed_digit = 0;
+    if (e2 >= 0) {
+        uint32_t q = log10_pow2(e2);
+        e10 = (int32_t)q;
+        int32_t k = 61 + pow5_bits((int32_t)q) - 1;
+        int32_t i = -e2 + (int32_t)q + k;
+        vr = mul_shift32(mv, pow5_inv_split[q][1] + 1, i);
+        vp = mul_shift32(mp, pow5_inv_split[q][1] + 1, i);
+        vm = mul_shift32(mm, pow5_inv_split[q][1] + 1, i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            // Only one digit will be removed: the digit removed from q to q - 1 is needed for rounding.
+            int32_t l = 61 + pow5_bits((int32_t)q - 1) - 1;
+            last_removed_digit = mul_shift32(mv, pow5_inv_split[q - 1][1] + 1, -e2 + (int32_t)q - 1 + l) % 10;
+        }
+        if (q <= 9) {
+            if (mv % 5 == 0)
+                vr_is_trailing_zeros = is_multiple_of_pow5(mv, q);
+            else if (accept_bounds)
+                vm_is_trailing_zeros = is_multiple_of_pow5(mm, q);
+            else
+                vp -= is_multiple_of_pow5(mp, q);
+        }
+    } else {
+        uint32_t q = log10_pow5(-e2);
+        e10 = (int32_t)q + e2;
+        int32_t i = -e2 - (int32_t)q;
+        int32_t k = pow5_bits(i) - 61;
+        int32_t j = (int32_t)q - k;
+        vr = mul_shift32(mv, pow5_split[i][1], j);
+        vp = mul_shift32(mp, pow5_split[i][1], j);
+        vm = mul_shift32(mm, pow5_split[i][1], j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            j = (int32_t)q - 1 - (pow5_bits(i + 1) - 61);
+            last_removed_digit = mul_shift32(mv, pow5_split[i + 1][1], j) % 10;
+        }
+        if (q <= 1) {
+            vr_is_trailing_zeros = true;
+            if (accept_bounds)
+                vm_is_trailing_zeros = mm_shift == 1;
+            else
+                --vp;
+        } else if (q < 31) {
+            vr_is_trailing_zeros = is_multiple_of_pow2(mv, q - 1);
+        }
+    }
+
+    int32_t removed = 0;
+    uint32_t output;
+    if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+        while (vp / 10 > vm / 10) {
+            vm_is_trailing_zeros &= vm % 10 == 0;
+            vr_is_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vm_is_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_is_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+            last_removed_digit = 4;
+        output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+    } else {
+        while (vp / 10 > vm / 10) {
+            last_removed_digit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || last_removed_digit >= 5);
+    }
+    *digits = output;
+    *exponent = e10 + removed;
+}
+
+// Number of decimal digits of value.
+static size_t decimal_length(unsigned long long value) {
+    size_t length = 1;
+    while (value >= 10000) {
+        value /= 10000;
+        length += 4;
+    }
+    return length + (value >= 10) + (value >= 100) + (value >= 1000);
+}
+
+// Write `digits` * 10^`exponent` as "%g" would, with all the digits: positional notation
+// for exponents from -4 to 16, scientific notation otherwise. Returns the number of chars written.
+static size_t write_decimal(char* buffer, bool is_negative, uint64_t digits, int32_t exponent) {
+    char* out = buffer;
+    if (is_negative)
+        *out++ = '-';
+    char all_digits[20];
+    size_t nb_digits = decimal_length(digits);
+    write_digits(all_digits + nb_digits, digits);
+    // value = 0.<all_digits> * 10^point
+    int32_t point = (int32_t)nb_digits + exponent;
+    if (point > -4 && point <= 17) {
+        if (point <= 0) {
+            memcpy(out, "0.", 2);
+            memset(out + 2, '0', (size_t)-point);
+            out += 2 + (size_t)-point;
+            memcpy(out, all_digits, nb_digits);
+            out += nb_digits;
+        } else if ((size_t)point >= nb_digits) {
+            memcpy(out, all_digits, nb_digits);
+            memset(out + nb_digits, '0', (size_t)point - nb_digits);
+            out += point;
+        } else {
+            memcpy(out, all_digits, (size_t)point);
+            out[point] = '.';
+            memcpy(out + point + 1, all_digits + point, nb_digits - (size_t)point);
+            out += nb_digits + 1;
+        }
+    } else {
+        *out++ = all_digits[0];
+        if (nb_digits > 1) {
+            *out++ = '.';
+            memcpy(out, all_digits + 1, nb_digits - 1);
+            out += nb_digits - 1;
+        }
+        int32_t scientific = point - 1;
+        *out++ = 'e';
+        *out++ = scientific < 0 ? '-' : '+';
+        unsigned magnitude = (unsigned)(scientific < 0 ? -scientific : scientific);
+        if (magnitude >= 100)
+            *out++ = (char)('0' + magnitude / 100);
+        memcpy(out, digit_pairs + 2 * (magnitude % 100), 2);
+        out += 2;
+    }
+    *out = '\0';
+    return (size_t)(out - buffer);
+}
+
+// Write "nan", "inf" or "0" with its sign, return 0 if value is none of them.
+static size_t write_special(char* buffer, double value) {
+    StrView name;
+    if (isnan(value))
+        name = STRVIEW_MAKE("nan");
+    else if (isinf(value))
+        name = STRVIEW_MAKE("inf");
+    else if (value == 0)
+        name = STRVIEW_MAKE("0");
+    else
+        return 0;
+    char* out = buffer;
+    if (signbit(value))
+        *out++ = '-';
+    memcpy(out, name.begin, name.size + 1);
+    return (size_t)(out - buffer) + name.size;
+}
+
+size_t jvstr_format_double(char* buffer, double value) {
+    size_t size = write_special(buffer, value);
+    if (size != 0)
+        return size;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint64_t digits;
+    int32_t exponent;
+    shortest_double(bits & ((1ull << 52) - 1), (uint32_t)(bits >> 52) & 0x7FF, &digits, &exponent);
+    return write_decimal(buffer, bits >> 63, digits, exponent);
+}
+
+size_t jvstr_format_float(char* buffer, float value) {
+    size_t size = write_special(buffer, value);
+    if (size != 0)
+        return size;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint64_t digits;
+    int32_t exponent;
+    shortest_float(bits & ((1u << 23) - 1), (bits >> 23) & 0xFF, &digits, &exponent);
+    return write_decimal(buffer, bits >> 31, digits, exponent);
+}
+
+size_t jvstr_format_uint(char* buffer, unsigned long long value) {
+    size_t size = decimal_length(value);
+    write_digits(buffer + size, value);
+    buffer[size] = '\0';
+    return size;
+}
+
+size_t jvstr_format_int(char* buffer, long long value) {
+    if (value >= 0)
+        return jvstr_format_uint(buffer, (unsigned long long)value);
+    buffer[0] = '-';
+    // negating in unsigned arithmetic, which is defined for LLONG_MIN
+    return 1 + jvstr_format_uint(buffer + 1, 0 - (unsigned long long)value);
+}
+
+// Append the shortest representation which reads back as the same value.
+void jvstr_buf_append_shortest(StrBuf* buf, double value) {
+    char text[JVSTR_FORMAT_SIZE];
+    jvstr_buf_append(buf, (StrView){ text, jvstr_format_double(text, value) });
+}
+
+void jvstr_buf_append_shortest_float(StrBuf* buf, float value) {
+    char text[JVSTR_FORMAT_SIZE];
+    jvstr_buf_append(buf, (StrView){ text, jvstr_format_float(text, value) });
+}
+
+// Append text formatted with printf.
+void jvstr_buf_append_format(StrBuf* buf, char const* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    jvstr_buf_append_vformat(buf, fmt, args);
+    va_end(args);
+}
+
+void jvstr_buf_append_vformat(StrBuf* buf, char const* fmt, va_list args) {
+    if (buf->has_failed)
+        return;
+    va_list args_copy;
+    va_copy(args_copy, args);
+    int length = vsnprintf(buf->begin + buf->size, buf->capacity - buf->size + 1, fmt, args_copy);
+    va_end(args_copy);
+    if (length < 0) {
+        buf->begin[buf->size] = '\0';
+        return;
+    }
+    if ((size_t)length > buf->capacity - buf->size) { // did not fit, trying again with enough room
+        buf->begin[buf->size] = '\0';
+        if (!jvstr_buf_reserve(buf, (size_t)length))
+            return;
+        vsnprintf(buf->begin + buf->size, (size_t)length + 1, fmt, args);
+    }
+    buf->size += (size_t)length;
+}
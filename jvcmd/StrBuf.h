@@ -0,0 +1,132 @@
+/*
+This is the C header for the StrBuf structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef JVSTR_STRBUF
+#define JVSTR_STRBUF
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "StrView.h"
+#include <stdarg.h>
+
+/*
+StrBuf is a growable string, always NUL-terminated, the writable companion of StrView.
+Short strings are stored inside the structure, so most buffers never allocate.
+When it grows, memory comes from `allocate(arena, size)` if set (never freed by the buffer), else from malloc.
+If memory cannot be obtained, `has_failed` is set and the following appends are ignored.
+The structure points into itself: it must not be copied while in use.
+Usage:
+    StrBuf buf;
+    jvstr_buf_init(&buf);
+    jvstr_buf_append(&buf, STRVIEW_MAKE("answer="));
+    jvstr_buf_append_int(&buf, 42);
+    puts(buf.begin);
+    jvstr_buf_free(&buf);
+*/
+#define JVSTR_STRBUF_SMALL_SIZE 64
+
+typedef struct StrBuf {
+    char* begin;     // content, followed by a NUL character
+    size_t size;     // number of chars, excluding the NUL character
+    size_t capacity; // number of chars which fit without growing, excluding the NUL character
+    void* (*allocate)(void* arena, size_t size); // if not NULL, used instead of malloc to grow
+    void* arena;
+    bool is_allocated; // whether begin was allocated with malloc by the buffer
+    bool has_failed;   // whether some memory could not be obtained, then the content is truncated
+    char small[JVSTR_STRBUF_SMALL_SIZE];
+} StrBuf;
+
+// Initialize an empty buffer, using its inline storage.
+void jvstr_buf_init(StrBuf* buf);
+
+// Initialize an empty buffer using `memory` of `size` bytes (i.e. an array on the stack) until it must grow.
+void jvstr_buf_init_in(StrBuf* buf, char* memory, size_t size);
+
+// Release memory allocated with malloc by the buffer. The buffer can be initialized again.
+void jvstr_buf_free(StrBuf* buf);
+
+// Remove the content, keeping the storage.
+void jvstr_buf_clear(StrBuf* buf);
+
+// Ensure `extra` chars can be appended without growing. Returns false if there is not enough memory.
+bool jvstr_buf_reserve(StrBuf* buf, size_t extra);
+
+// View of the content.
+StrView jvstr_buf_view(StrBuf const* buf);
+
+// Append the chars of str.
+void jvstr_buf_append(StrBuf* buf, StrView str);
+
+// Append a single char.
+void jvstr_buf_append_char(StrBuf* buf, char ch);
+
+// Append `count` times the char `ch`, i.e. for padding.
+void jvstr_buf_append_repeat(StrBuf* buf, char ch, size_t count);
+
+// Append the decimal representation of an integer.
+void jvstr_buf_append_int(StrBuf* buf, long long value);
+void jvstr_buf_append_uint(StrBuf* buf, unsigned long long value);
+
+// Append a floating-point value with `nb_decimals` digits after the point (at most 17),
+// as printf("%.*f") in the "C" locale: the decimal separator is always '.'.
+void jvstr_buf_append_float(StrBuf* buf, double value, int nb_decimals);
+
+// Append the shortest decimal representation which reads back (i.e. with strtod) as exactly the same value,
+// as written by jvstr_format_double and jvstr_format_float.
+void jvstr_buf_append_shortest(StrBuf* buf, double value);
+void jvstr_buf_append_shortest_float(StrBuf* buf, float value);
+
+// Append text formatted with printf.
+void jvstr_buf_append_format(StrBuf* buf, char const* fmt, ...);
+void jvstr_buf_append_vformat(StrBuf* buf, char const* fmt, va_list args);
+
+// Size of a buffer large enough for the jvstr_format_* functions, including the NUL character.
+#define JVSTR_FORMAT_SIZE 32
+
+// Write the decimal representation of an integer, followed by a NUL character, in `buffer`.
+// Returns the number of chars written, excluding the NUL character.
+size_t jvstr_format_int(char* buffer, long long value);
+size_t jvstr_format_uint(char* buffer, unsigned long long value);
+
+// Write the shortest decimal representation which reads back as exactly `value`, the closest to `value` if several
+// have the same length, as printf("%g") would without its 6 digits limit: "0.1", "1024", "1.5e+300", "-inf", "nan".
+// The decimal separator is always '.'. Returns the number of chars written, excluding the NUL character.
+size_t jvstr_format_double(char* buffer, double value);
+size_t jvstr_format_float(char* buffer, float value);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
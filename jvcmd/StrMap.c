@@ -0,0 +1,242 @@
+/*
+This is the C implementation for the StrMap structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+#include "StrMap.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Control bytes: full slots hold the 7 low bits of the hash, empty and deleted slots have their high bit set. */
+enum { CTRL_EMPTY = 0x80, CTRL_DELETED = 0xFE, GROUP_SIZE = 16 };
+
+// Number of slots for `nb_entries` entries, with a load factor of at most 7/8.
+static size_t nb_slots_for(size_t nb_entries) {
+    size_t nb_slots = GROUP_SIZE;
+    while (nb_slots - nb_slots / 8 < nb_entries)
+        nb_slots *= 2;
+    return nb_slots;
+}
+
+// Mask of the control bytes equal to `ctrl` among the 16 starting at `group`.
+static unsigned group_match(unsigned char const* group, unsigned char ctrl) {
+#if defined(__SSE2__)
+    __m128i bytes = _mm_loadu_si128((__m128i const*)group);
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8((char)ctrl)));
+#else
+    unsigned mask = 0;
+    for (int i = 0; i < GROUP_SIZE; ++i)
+        mask |= (unsigned)(group[i] == ctrl) << i;
+    return mask;
+#endif
+}
+
+// Mask of the empty or deleted slots among the 16 starting at `group`.
+static unsigned group_match_free(unsigned char const* group) {
+#if defined(__SSE2__)
+    return (unsigned)_mm_movemask_epi8(_mm_loadu_si128((__m128i const*)group));
+#else
+    unsigned mask = 0;
+    for (int i = 0; i < GROUP_SIZE; ++i)
+        mask |= (unsigned)(group[i] >> 7) << i;
+    return mask;
+#endif
+}
+
+static unsigned lowest_bit(unsigned mask) {
+#if defined(__GNUC__)
+    return (unsigned)__builtin_ctz(mask);
+#else
+    unsigned i = 0;
+    while (((mask >> i) & 1) == 0)
+        ++i;
+    return i;
+#endif
+}
+
+static void set_ctrl(StrMap* map, size_t slot, unsigned char ctrl) {
+    map->ctrl[slot] = ctrl;
+    if (slot < GROUP_SIZE) // mirrored so that groups can be loaded past the last slot
+        map->ctrl[map->nb_slots + slot] = ctrl;
+}
+
+// Number of bytes of storage needed by jvstr_map_init_in to hold `nb_entries` entries.
+size_t jvstr_map_memory_size(size_t nb_entries) {
+    size_t nb_slots = nb_slots_for(nb_entries);
+    return nb_slots * sizeof(StrMapEntry) + nb_slots + GROUP_SIZE;
+}
+
+// Initialize an empty map storing at most `nb_entries` entries in `memory`.
+void jvstr_map_init_in(StrMap* map, void* memory, size_t nb_entries, uint64_t seed) {
+    map->nb_slots = nb_slots_for(nb_entries);
+    map->entries = (StrMapEntry*)memory;
+    map->ctrl = (unsigned char*)(map->entries + map->nb_slots);
+    memset(map->ctrl, CTRL_EMPTY, map->nb_slots + GROUP_SIZE);
+    map->size = 0;
+    map->growth_left = map->nb_slots - map->nb_slots / 8;
+    map->seed = seed;
+    map->owns_memory = false;
+    map->ignore_case = false;
+}
+
+// Initialize an empty map with room for `nb_entries` entries, growing as needed.
+bool jvstr_map_init(StrMap* map, size_t nb_entries) {
+    void* memory = malloc(jvstr_map_memory_size(nb_entries));
+    if (memory == NULL)
+        return false;
+    jvstr_map_init_in(map, memory, nb_entries, 0x9E3779B97F4A7C15u);
+    map->owns_memory = true;
+    return true;
+}
+
+// Release memory allocated by the map.
+void jvstr_map_free(StrMap* map) {
+    if (map->owns_memory)
+        free(map->entries);
+    map->entries = NULL;
+    map->ctrl = NULL;
+    map->nb_slots = map->size = map->growth_left = 0;
+}
+
+static uint64_t hash_key(StrMap const* map, StrView key) {
+    return map->ignore_case ? jvstr_hash_icase(key, map->seed) : jvstr_hash(key, map->seed);
+}
+
+// Slot of `key` if found, else -1. If `free_slot` is not NULL, it receives the first empty or deleted slot probed.
+static size_t probe(StrMap const* map, StrView key, uint64_t hash, size_t* free_slot) {
+    size_t mask = map->nb_slots - 1;
+    unsigned char h2 = (unsigned char)(hash & 0x7F);
+    size_t pos = (size_t)(hash >> 7) & mask;
+    bool has_free_slot = false;
+    for (size_t step = GROUP_SIZE;; pos = (pos + step) & mask, step += GROUP_SIZE) {
+        unsigned char const* group = map->ctrl + pos;
+        for (unsigned match = group_match(group, h2); match != 0; match &= match - 1) {
+            size_t slot = (pos + lowest_bit(match)) & mask;
+            StrView slot_key = map->entries[slot].key;
+            if (map->ignore_case ? jvstr_equal_icase(slot_key, key) : jvstr_equal(slot_key, key))
+                return slot;
+        }
+        if (free_slot != NULL && !has_free_slot) {
+            unsigned free_mask = group_match_free(group);
+            if (free_mask != 0) {
+                *free_slot = (pos + lowest_bit(free_mask)) & mask;
+                has_free_slot = true;
+            }
+        }
+        if (group_match(group, CTRL_EMPTY) != 0) // the key would have been inserted here
+            return (size_t)-1;
+    }
+}
+
+// First empty or deleted slot in the probe sequence of `hash`.
+static size_t find_free_slot(StrMap const* map, uint64_t hash) {
+    size_t mask = map->nb_slots - 1;
+    size_t pos = (size_t)(hash >> 7) & mask;
+    for (size_t step = GROUP_SIZE;; pos = (pos + step) & mask, step += GROUP_SIZE) {
+        unsigned free_mask = group_match_free(map->ctrl + pos);
+        if (free_mask != 0)
+            return (pos + lowest_bit(free_mask)) & mask;
+    }
+}
+
+// Move all entries to a new storage for `nb_entries` entries, dropping deleted slots.
+static bool rehash(StrMap* map, size_t nb_entries) {
+    StrMap bigger;
+    if (!jvstr_map_init(&bigger, nb_entries))
+        return false;
+    bigger.seed = map->seed;
+    bigger.ignore_case = map->ignore_case;
+    size_t pos = 0;
+    for (StrMapEntry* entry; (entry = jvstr_map_next(map, &pos)) != NULL;) {
+        uint64_t hash = hash_key(&bigger, entry->key);
+        size_t slot = find_free_slot(&bigger, hash); // keys are distinct, no need to compare them
+        set_ctrl(&bigger, slot, (unsigned char)(hash & 0x7F));
+        bigger.entries[slot] = *entry;
+    }
+    bigger.size = map->size;
+    bigger.growth_left -= map->size;
+    jvstr_map_free(map);
+    *map = bigger;
+    return true;
+}
+
+// Find the entry of `key`, NULL if not found.
+StrMapEntry* jvstr_map_find(StrMap const* map, StrView key) {
+    size_t slot = probe(map, key, hash_key(map, key), NULL);
+    return slot == (size_t)-1 ? NULL : &map->entries[slot];
+}
+
+// Find or insert `key`, and return the address of its value, which is NULL when inserted.
+void** jvstr_map_insert(StrMap* map, StrView key, bool* inserted) {
+    uint64_t hash = hash_key(map, key);
+    size_t free_slot;
+    size_t slot = probe(map, key, hash, &free_slot);
+    if (inserted != NULL)
+        *inserted = slot == (size_t)-1;
+    if (slot != (size_t)-1)
+        return &map->entries[slot].value;
+    
+    if (map->ctrl[free_slot] == CTRL_EMPTY) {
+        if (map->growth_left == 0) {
+            if (!map->owns_memory || !rehash(map, 2 * (map->size + 1)))
+                return NULL;
+            free_slot = find_free_slot(map, hash);
+        }
+        map->growth_left -= 1;
+    }
+    set_ctrl(map, free_slot, (unsigned char)(hash & 0x7F));
+    map->entries[free_slot].key = key;
+    map->entries[free_slot].value = NULL;
+    map->size += 1;
+    return &map->entries[free_slot].value;
+}
+
+// Remove the entry of `key`, return whether it was present.
+bool jvstr_map_remove(StrMap* map, StrView key) {
+    size_t slot = probe(map, key, hash_key(map, key), NULL);
+    if (slot == (size_t)-1)
+        return false;
+    // Deleted rather than empty, so that probing continues past it for the other keys.
+    set_ctrl(map, slot, CTRL_DELETED);
+    map->size -= 1;
+    return true;
+}
+
+// Iterate over the entries, in no particular order. `*pos` must be 0 at first.
+StrMapEntry* jvstr_map_next(StrMap const* map, size_t* pos) {
+    for (; *pos < map->nb_slots; ++*pos) {
+        if ((map->ctrl[*pos] & 0x80) == 0)
+            return &map->entries[(*pos)++];
+    }
+    return NULL;
+}
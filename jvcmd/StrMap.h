@@ -0,0 +1,106 @@
+/*
+This is the C header for the StrMap structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef JVSTR_STRMAP
+#define JVSTR_STRMAP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "StrView.h"
+
+/*
+StrMap is a hash map from StrView keys to `void*` values, with open addressing (Swiss table).
+One control byte per slot holds 7 bits of the hash of its key, so a probe compares 16 slots at once
+and keys are only compared when these 7 bits match.
+Keys are not copied: the bytes they point to must outlive the map.
+
+The storage is a single block of memory: either allocated by the map which then grows as needed,
+or given by the user (i.e. from an arena) with a fixed capacity.
+Usage:
+    StrMap map;
+    jvstr_map_init(&map, 0);
+    *jvstr_map_insert(&map, STRVIEW_MAKE("key"), NULL) = value;
+    StrMapEntry* entry = jvstr_map_find(&map, STRVIEW_MAKE("key"));
+    jvstr_map_free(&map);
+*/
+typedef struct StrMapEntry {
+    StrView key;
+    void* value;
+} StrMapEntry;
+
+typedef struct StrMap {
+    unsigned char* ctrl;  // nb_slots + 16 control bytes, the last 16 mirroring the first 16
+    StrMapEntry* entries; // nb_slots entries, only meaningful when their control byte is full
+    size_t nb_slots;      // power of two, at least 16
+    size_t size;          // number of entries
+    size_t growth_left;   // number of entries which can be inserted before the map is too loaded
+    uint64_t seed;
+    bool owns_memory;     // whether the storage was allocated by the map, then it grows
+    bool ignore_case;     // keys compared and hashed ignoring ASCII case, can only be set while the map is empty
+} StrMap;
+
+// Number of bytes of storage needed by jvstr_map_init_in to hold `nb_entries` entries.
+size_t jvstr_map_memory_size(size_t nb_entries);
+
+// Initialize an empty map storing at most `nb_entries` entries in `memory` (aligned for pointers),
+// which must be at least jvstr_map_memory_size(nb_entries) bytes. The map does not grow nor free memory.
+void jvstr_map_init_in(StrMap* map, void* memory, size_t nb_entries, uint64_t seed);
+
+// Initialize an empty map with room for `nb_entries` entries, growing as needed.
+// Returns false if there is not enough memory.
+bool jvstr_map_init(StrMap* map, size_t nb_entries);
+
+// Release memory allocated by the map.
+void jvstr_map_free(StrMap* map);
+
+// Find the entry of `key`, NULL if not found.
+StrMapEntry* jvstr_map_find(StrMap const* map, StrView key);
+
+// Find or insert `key`, and return the address of its value, which is NULL when inserted.
+// `*inserted` is set to whether the key was absent, if `inserted` is not NULL.
+// Returns NULL if there is not enough memory, or if a map with fixed storage is full.
+void** jvstr_map_insert(StrMap* map, StrView key, bool* inserted);
+
+// Remove the entry of `key`, return whether it was present.
+bool jvstr_map_remove(StrMap* map, StrView key);
+
+// Iterate over the entries, in no particular order. `*pos` must be 0 at first.
+// Returns NULL once all entries were visited.
+StrMapEntry* jvstr_map_next(StrMap const* map, size_t* pos);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
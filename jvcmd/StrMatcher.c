@@ -0,0 +1,340 @@
+/*
+This is the C implementation for the StrMatcher structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+#include "StrMatcher.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define NO_STATE UINT32_MAX
+#define NB_BUCKETS 8
+#define MAX_PREFILTER_BYTES 3
+#define MAX_FIRST_BYTES 16
+
+struct StrMatcher {
+    uint8_t byte_class[256]; /* bytes not used by the patterns share the class 0 */
+    uint32_t nb_classes;
+    uint32_t nb_states;
+    uint32_t const* transitions;   /* [state * nb_classes + class], state 0 is the start, matching nothing */
+    uint32_t const* dict_link;     /* [state] nearest state on the failure chain with patterns ending there, 0 if none */
+    uint32_t const* outputs_begin; /* [state] patterns ending at the state are output_ids[outputs_begin[state]..outputs_begin[state+1]] */
+    uint32_t const* output_ids;
+    size_t const* pattern_sizes;
+    bool const* has_output;        /* [state] whether any pattern ends at the state or along its failure chain */
+    
+    /* Prefilter: an occurrence can only start at a position where the first bytes match some pattern.
+       Patterns are split into buckets, and for the k-th byte the bit of a bucket is set in
+       nibbles[k][0][low nibble] and nibbles[k][1][high nibble] if the k-th byte of one of its patterns has them.
+       A position is a candidate if a bucket bit remains after AND-ing these bits for all k. */
+    int nb_prefilter_bytes;
+    unsigned char nibbles[MAX_PREFILTER_BYTES][2][16];
+    /* Without SSSE3, the first bytes are compared one by one when there are few of them. */
+    int nb_first_bytes; /* 0 if more than MAX_FIRST_BYTES */
+    unsigned char first_bytes[MAX_FIRST_BYTES];
+};
+
+// Release memory of a matcher returned by jvstr_matcher_compile.
+void jvstr_matcher_free(StrMatcher* matcher) {
+    free(matcher); /* tables are in the same allocation */
+}
+
+// Compile the patterns, which are not needed anymore afterwards.
+StrMatcher* jvstr_matcher_compile(StrView const* patterns, size_t nb_patterns) {
+    bool is_used[256] = {0};
+    size_t total_size = 0, min_size = SIZE_MAX;
+    for (size_t i = 0; i < nb_patterns; ++i) {
+        if (patterns[i].size == 0)
+            continue;
+        total_size += patterns[i].size;
+        if (patterns[i].size < min_size)
+            min_size = patterns[i].size;
+        for (size_t j = 0; j < patterns[i].size; ++j)
+            is_used[(unsigned char)patterns[i].begin[j]] = true;
+    }
+    uint8_t byte_class[256];
+    uint32_t nb_classes = 1;
+    for (int b = 0; b < 256; ++b)
+        byte_class[b] = is_used[b] ? (uint8_t)nb_classes++ : 0;
+    if (total_size >= UINT32_MAX / nb_classes || nb_patterns >= UINT32_MAX)
+        return NULL;
+    
+    /* 1. Trie of the patterns, with room for the worst case where no prefix is shared. */
+    size_t max_states = total_size + 1;
+    uint32_t* trie = (uint32_t*)malloc(max_states * nb_classes * sizeof(uint32_t));
+    uint32_t* end_states = (uint32_t*)malloc((nb_patterns + 1) * sizeof(uint32_t));
+    if (trie == NULL || end_states == NULL) {
+        free(trie);
+        free(end_states);
+        return NULL;
+    }
+    memset(trie, 0xFF, max_states * nb_classes * sizeof(uint32_t)); /* NO_STATE */
+    uint32_t nb_states = 1;
+    for (size_t i = 0; i < nb_patterns; ++i) {
+        uint32_t state = 0;
+        for (size_t j = 0; j < patterns[i].size; ++j) {
+            uint32_t* next = &trie[(size_t)state * nb_classes + byte_class[(unsigned char)patterns[i].begin[j]]];
+            if (*next == NO_STATE)
+                *next = nb_states++;
+            state = *next;
+        }
+        end_states[i] = patterns[i].size > 0 ? state : NO_STATE;
+    }
+    
+    /* 2. Final tables, in the same allocation as the structure. */
+    size_t table_size = (size_t)nb_states * nb_classes;
+    size_t memory_size = sizeof(StrMatcher) + nb_patterns * sizeof(size_t)
+                       + (table_size + 2 * (size_t)nb_states + 1 + nb_patterns) * sizeof(uint32_t)
+                       + nb_states * sizeof(bool);
+    StrMatcher* matcher = (StrMatcher*)malloc(memory_size);
+    uint32_t* fail = (uint32_t*)malloc(nb_states * sizeof(uint32_t));
+    uint32_t* queue = (uint32_t*)malloc(nb_states * sizeof(uint32_t));
+    if (matcher == NULL || fail == NULL || queue == NULL) {
+        free(matcher);
+        free(fail);
+        free(queue);
+        free(trie);
+        free(end_states);
+        return NULL;
+    }
+    size_t* pattern_sizes = (size_t*)(matcher + 1);
+    uint32_t* transitions = (uint32_t*)(pattern_sizes + nb_patterns);
+    uint32_t* dict_link = transitions + table_size;
+    uint32_t* outputs_begin = dict_link + nb_states;
+    uint32_t* output_ids = outputs_begin + nb_states + 1;
+    bool* has_output = (bool*)(output_ids + nb_patterns);
+    
+    memcpy(matcher->byte_class, byte_class, sizeof(byte_class));
+    matcher->nb_classes = nb_classes;
+    matcher->nb_states = nb_states;
+    memcpy(transitions, trie, table_size * sizeof(uint32_t));
+    free(trie);
+    
+    /* Patterns grouped by end state (counting sort), keeping the order of their ids. */
+    memset(outputs_begin, 0, (nb_states + 1) * sizeof(uint32_t));
+    for (size_t i = 0; i < nb_patterns; ++i) {
+        pattern_sizes[i] = patterns[i].size;
+        if (end_states[i] != NO_STATE)
+            outputs_begin[end_states[i] + 1] += 1;
+    }
+    for (uint32_t state = 0; state < nb_states; ++state)
+        outputs_begin[state + 1] += outputs_begin[state];
+    memcpy(fail, outputs_begin, nb_states * sizeof(uint32_t)); /* used as insertion cursors */
+    for (size_t i = 0; i < nb_patterns; ++i)
+        if (end_states[i] != NO_STATE)
+            output_ids[fail[end_states[i]]++] = (uint32_t)i;
+    free(end_states);
+    
+    /* 3. Failure links in breadth-first order, completing the missing transitions into a DFA:
+          the transition of a state is the one of its failure state, already complete as it is less deep. */
+    size_t head = 0, tail = 0;
+    fail[0] = 0;
+    dict_link[0] = 0;
+    for (uint32_t c = 0; c < nb_classes; ++c) {
+        uint32_t child = transitions[c];
+        if (child == NO_STATE) {
+            transitions[c] = 0;
+        } else {
+            fail[child] = 0;
+            dict_link[child] = 0;
+            queue[tail++] = child;
+        }
+    }
+    while (head < tail) {
+        uint32_t state = queue[head++];
+        uint32_t const* fail_row = &transitions[(size_t)fail[state] * nb_classes];
+        uint32_t* row = &transitions[(size_t)state * nb_classes];
+        for (uint32_t c = 0; c < nb_classes; ++c) {
+            uint32_t child = row[c];
+            if (child == NO_STATE) {
+                row[c] = fail_row[c];
+            } else {
+                uint32_t child_fail = fail_row[c];
+                fail[child] = child_fail;
+                bool fail_has_patterns = outputs_begin[child_fail] != outputs_begin[child_fail + 1];
+                dict_link[child] = fail_has_patterns ? child_fail : dict_link[child_fail];
+                queue[tail++] = child;
+            }
+        }
+    }
+    for (uint32_t state = 0; state < nb_states; ++state)
+        has_output[state] = outputs_begin[state] != outputs_begin[state + 1] || dict_link[state] != 0;
+    free(fail);
+    free(queue);
+    
+    matcher->transitions = transitions;
+    matcher->dict_link = dict_link;
+    matcher->outputs_begin = outputs_begin;
+    matcher->output_ids = output_ids;
+    matcher->pattern_sizes = pattern_sizes;
+    matcher->has_output = has_output;
+    
+    /* 4. Prefilter on the first bytes, patterns with the same first byte sharing a bucket. */
+    matcher->nb_prefilter_bytes = min_size == SIZE_MAX ? 0 : min_size < MAX_PREFILTER_BYTES ? (int)min_size : MAX_PREFILTER_BYTES;
+    memset(matcher->nibbles, 0, sizeof(matcher->nibbles));
+    matcher->nb_first_bytes = 0;
+    bool is_first_byte[256] = {0};
+    for (size_t i = 0; i < nb_patterns; ++i) {
+        if (patterns[i].size == 0)
+            continue;
+        unsigned char const* p = (unsigned char const*)patterns[i].begin;
+        if (!is_first_byte[p[0]] && matcher->nb_first_bytes >= 0) {
+            is_first_byte[p[0]] = true;
+            if (matcher->nb_first_bytes < MAX_FIRST_BYTES)
+                matcher->first_bytes[matcher->nb_first_bytes++] = p[0];
+            else
+                matcher->nb_first_bytes = -1;
+        }
+        unsigned char bucket_bit = (unsigned char)(1u << (p[0] % NB_BUCKETS));
+        for (int k = 0; k < matcher->nb_prefilter_bytes; ++k) {
+            matcher->nibbles[k][0][p[k] & 0xF] |= bucket_bit;
+            matcher->nibbles[k][1][p[k] >> 4] |= bucket_bit;
+        }
+    }
+    if (matcher->nb_first_bytes < 0)
+        matcher->nb_first_bytes = 0;
+    return matcher;
+}
+
+// Whether an occurrence may start at `pos`, which is followed by at least nb_prefilter_bytes bytes.
+static bool is_candidate(StrMatcher const* matcher, unsigned char const* s, size_t pos) {
+    unsigned buckets = 0xFF;
+    for (int k = 0; k < matcher->nb_prefilter_bytes && buckets != 0; ++k) {
+        unsigned char c = s[pos + k];
+        buckets &= matcher->nibbles[k][0][c & 0xF] & matcher->nibbles[k][1][c >> 4];
+    }
+    return buckets != 0;
+}
+
+// First position at or after `pos` where an occurrence may start, `size` if none.
+static size_t next_candidate(StrMatcher const* matcher, unsigned char const* s, size_t size, size_t pos) {
+    int nb_bytes = matcher->nb_prefilter_bytes;
+    if (nb_bytes == 0 || size < (size_t)nb_bytes || pos > size - nb_bytes)
+        return size;
+    size_t end = size - nb_bytes + 1; /* positions before `end` have enough bytes to be checked */
+#if defined(__AVX2__)
+    const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+    for (; pos + 32 <= end; pos += 32) {
+        __m256i buckets = _mm256_set1_epi8(-1);
+        for (int k = 0; k < nb_bytes; ++k) {
+            __m256i x = _mm256_loadu_si256((__m256i const*)(s + pos + k));
+            __m256i table_low = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const*)matcher->nibbles[k][0]));
+            __m256i table_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const*)matcher->nibbles[k][1]));
+            __m256i low = _mm256_shuffle_epi8(table_low, _mm256_and_si256(x, low_nibble));
+            __m256i high = _mm256_shuffle_epi8(table_high, _mm256_and_si256(_mm256_srli_epi16(x, 4), low_nibble));
+            buckets = _mm256_and_si256(buckets, _mm256_and_si256(low, high));
+        }
+        unsigned candidates = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(buckets, _mm256_setzero_si256()));
+        if (candidates != 0)
+            return pos + __builtin_ctz(candidates);
+    }
+#elif defined(__SSSE3__)
+    const __m128i low_nibble = _mm_set1_epi8(0x0F);
+    for (; pos + 16 <= end; pos += 16) {
+        __m128i buckets = _mm_set1_epi8(-1);
+        for (int k = 0; k < nb_bytes; ++k) {
+            __m128i x = _mm_loadu_si128((__m128i const*)(s + pos + k));
+            __m128i low = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)matcher->nibbles[k][0]), _mm_and_si128(x, low_nibble));
+            __m128i high = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)matcher->nibbles[k][1]),
+                                            _mm_and_si128(_mm_srli_epi16(x, 4), low_nibble));
+            buckets = _mm_and_si128(buckets, _mm_and_si128(low, high));
+        }
+        unsigned candidates = 0xFFFFu & ~(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(buckets, _mm_setzero_si128()));
+        if (candidates != 0)
+            return pos + __builtin_ctz(candidates);
+    }
+#elif defined(__SSE2__)
+    if (matcher->nb_first_bytes > 0) {
+        for (; pos + 16 <= end; pos += 16) {
+            __m128i x = _mm_loadu_si128((__m128i const*)(s + pos));
+            __m128i is_first = _mm_setzero_si128();
+            for (int i = 0; i < matcher->nb_first_bytes; ++i)
+                is_first = _mm_or_si128(is_first, _mm_cmpeq_epi8(x, _mm_set1_epi8((char)matcher->first_bytes[i])));
+            for (unsigned mask = (unsigned)_mm_movemask_epi8(is_first); mask != 0; mask &= mask - 1) {
+                size_t candidate = pos + __builtin_ctz(mask);
+                if (is_candidate(matcher, s, candidate))
+                    return candidate;
+            }
+        }
+    }
+#endif
+    for (; pos < end; ++pos) {
+        if (is_candidate(matcher, s, pos))
+            return pos;
+    }
+    return size;
+}
+
+// Report every occurrence of the patterns in text to `callback`.
+size_t jvstr_matcher_scan(StrMatcher const* matcher, StrView text, StrMatchCallback callback, void* userdata) {
+    unsigned char const* s = (unsigned char const*)text.begin;
+    size_t nb_matches = 0;
+    uint32_t state = 0;
+    for (size_t pos = 0; pos < text.size;) {
+        if (state == 0) {
+            // nothing partially matched: occurrences can only start at candidates
+            pos = next_candidate(matcher, s, text.size, pos);
+            if (pos == text.size)
+                break;
+        }
+        state = matcher->transitions[(size_t)state * matcher->nb_classes + matcher->byte_class[s[pos]]];
+        pos += 1;
+        if (!matcher->has_output[state])
+            continue;
+        for (uint32_t output = state; output != 0; output = matcher->dict_link[output]) {
+            for (uint32_t i = matcher->outputs_begin[output]; i < matcher->outputs_begin[output + 1]; ++i) {
+                uint32_t id = matcher->output_ids[i];
+                StrMatch match = { id, pos - matcher->pattern_sizes[id] };
+                nb_matches += 1;
+                if (!callback(userdata, match))
+                    return nb_matches;
+            }
+        }
+    }
+    return nb_matches;
+}
+
+static bool keep_first_match(void* userdata, StrMatch match) {
+    *(StrMatch*)userdata = match;
+    return false;
+}
+
+// Find the first occurrence (by end) of any pattern in text.
+bool jvstr_matcher_find(StrMatcher const* matcher, StrView text, StrMatch* match) {
+    return jvstr_matcher_scan(matcher, text, &keep_first_match, match) > 0;
+}
@@ -0,0 +1,79 @@
+/*
+This is the C header for the StrMatcher structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef JVSTR_STRMATCHER
+#define JVSTR_STRMATCHER
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "StrView.h"
+
+/*
+StrMatcher finds all occurrences of many substrings at once, in a single linear pass over the text.
+It is an Aho-Corasick automaton compiled into a dense DFA over the bytes which appear in the patterns,
+so each byte of text costs one table lookup. While no pattern is partially matched,
+the text is skipped with a SIMD prefilter comparing the first bytes of the patterns 16 or 32 positions at once.
+The DFA has one row per distinct prefix of the patterns, and one column per distinct byte used by the patterns:
+it is intended for up to a few thousand patterns.
+*/
+typedef struct StrMatcher StrMatcher;
+
+typedef struct StrMatch {
+    size_t pattern_id; // index of the pattern in the array given to jvstr_matcher_compile
+    size_t pos;        // location of the occurrence in the text
+} StrMatch;
+
+// Called for each occurrence, in order of their end in the text, longest first for a same end.
+// Returns false to stop the scan.
+typedef bool (*StrMatchCallback)(void* userdata, StrMatch match);
+
+// Compile the patterns, which are not needed anymore afterwards. Empty patterns never match.
+// Returns NULL if there is not enough memory.
+StrMatcher* jvstr_matcher_compile(StrView const* patterns, size_t nb_patterns);
+
+// Release memory of a matcher returned by jvstr_matcher_compile. NULL is accepted.
+void jvstr_matcher_free(StrMatcher* matcher);
+
+// Report every occurrence of the patterns in text to `callback`, overlapping ones included.
+// Returns the number of occurrences reported.
+size_t jvstr_matcher_scan(StrMatcher const* matcher, StrView text, StrMatchCallback callback, void* userdata);
+
+// Find the first occurrence (by end) of any pattern in text, returns false if there is none.
+bool jvstr_matcher_find(StrMatcher const* matcher, StrView text, StrMatch* match);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,648 @@
+/*
+This is the C implementation for the StrPattern structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+#include "StrPattern.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define REPEAT_INFINITE -1
+#define MAX_REPEAT 1000
+#define MAX_NFA_STATES 16384
+#define MAX_DFA_STATES 4096
+
+
+typedef struct ByteSet {
+    uint8_t bits[32];
+} ByteSet;
+
+static void byteset_add(ByteSet* set, unsigned char b) {
+    set->bits[b >> 3] |= (uint8_t)(1u << (b & 7));
+}
+
+static bool byteset_has(ByteSet const* set, unsigned char b) {
+    return (set->bits[b >> 3] >> (b & 7)) & 1;
+}
+
+static void byteset_add_range(ByteSet* set, unsigned char first, unsigned char last) {
+    for (unsigned b = first; b <= last; ++b)
+        byteset_add(set, (unsigned char)b);
+}
+
+static void byteset_invert(ByteSet* set) {
+    for (int i = 0; i < 32; ++i)
+        set->bits[i] = (uint8_t)~set->bits[i];
+}
+
+
+/* PARSING: The pattern is parsed into a tree of nodes, stored in an array and referenced by index. */
+
+enum NodeType { NODE_EMPTY, NODE_SET, NODE_CONCAT, NODE_ALT, NODE_REPEAT };
+
+typedef struct Node {
+    int type;
+    int left, right; /* children, 'left' only for NODE_REPEAT */
+    int min, max;    /* for NODE_REPEAT, max may be REPEAT_INFINITE */
+    ByteSet set;     /* for NODE_SET */
+} Node;
+
+typedef struct Parser {
+    StrView pattern;
+    size_t pos;
+    Node* nodes;
+    int nb_nodes, capacity;
+    char const* error;
+    size_t error_pos;
+} Parser;
+
+static int fail(Parser* p, char const* error, size_t error_pos) {
+    if (p->error == NULL) {
+        p->error = error;
+        p->error_pos = error_pos;
+    }
+    return -1;
+}
+
+static int new_node(Parser* p, int type, int left, int right) {
+    if (p->nb_nodes == p->capacity) {
+        int capacity = p->capacity == 0 ? 16 : 2 * p->capacity;
+        Node* nodes = (Node*)realloc(p->nodes, capacity * sizeof(Node));
+        if (nodes == NULL)
+            return fail(p, "not enough memory", p->pos);
+        p->nodes = nodes;
+        p->capacity = capacity;
+    }
+    Node* node = &p->nodes[p->nb_nodes];
+    memset(node, 0, sizeof(Node));
+    node->type = type;
+    node->left = left;
+    node->right = right;
+    return p->nb_nodes++;
+}
+
+static bool at_end(Parser const* p) {
+    return p->pos >= p->pattern.size;
+}
+
+static char peek(Parser const* p) {
+    return p->pattern.begin[p->pos];
+}
+
+// Fill `set` if `c` is the letter of a class escape (\d, \w, \s and their complements).
+static bool escape_set(char c, ByteSet* set) {
+    memset(set, 0, sizeof(ByteSet));
+    switch (c) {
+    case 'd': case 'D':
+        byteset_add_range(set, '0', '9');
+        break;
+    case 'w': case 'W':
+        byteset_add_range(set, 'a', 'z');
+        byteset_add_range(set, 'A', 'Z');
+        byteset_add_range(set, '0', '9');
+        byteset_add(set, '_');
+        break;
+    case 's': case 'S':
+        byteset_add_range(set, '\t', '\r'); /* \t \n \v \f \r */
+        byteset_add(set, ' ');
+        break;
+    default:
+        return false;
+    }
+    if (c == 'D' || c == 'W' || c == 'S')
+        byteset_invert(set);
+    return true;
+}
+
+static unsigned char escape_literal(char c) {
+    switch (c) {
+    case 'n': return '\n';
+    case 'r': return '\r';
+    case 't': return '\t';
+    default:  return (unsigned char)c;
+    }
+}
+
+static int parse_alternation(Parser* p);
+
+static int parse_set(Parser* p) {
+    size_t start = p->pos++; /* '[' */
+    int node = new_node(p, NODE_SET, -1, -1);
+    if (node < 0)
+        return -1;
+    ByteSet set = {{0}};
+    bool negate = !at_end(p) && peek(p) == '^';
+    if (negate)
+        ++p->pos;
+    bool first = true;
+    while (true) {
+        if (at_end(p))
+            return fail(p, "missing ']'", start);
+        char c = peek(p);
+        if (c == ']' && !first) {
+            ++p->pos;
+            break;
+        }
+        first = false;
+        unsigned char lo = (unsigned char)c;
+        ++p->pos;
+        if (c == '\\') {
+            if (at_end(p))
+                return fail(p, "trailing '\\'", p->pos - 1);
+            ByteSet escaped;
+            char e = p->pattern.begin[p->pos++];
+            if (escape_set(e, &escaped)) {
+                for (int i = 0; i < 32; ++i)
+                    set.bits[i] |= escaped.bits[i];
+                continue;
+            }
+            lo = escape_literal(e);
+        }
+        if (p->pos + 1 < p->pattern.size && peek(p) == '-' && p->pattern.begin[p->pos + 1] != ']') {
+            size_t range_pos = p->pos++;
+            unsigned char hi = (unsigned char)p->pattern.begin[p->pos++];
+            if (hi == '\\') {
+                ByteSet escaped;
+                if (at_end(p) || escape_set(peek(p), &escaped))
+                    return fail(p, "invalid range", range_pos);
+                hi = escape_literal(p->pattern.begin[p->pos++]);
+            }
+            if (hi < lo)
+                return fail(p, "invalid range", range_pos);
+            byteset_add_range(&set, lo, hi);
+        } else {
+            byteset_add(&set, lo);
+        }
+    }
+    if (negate)
+        byteset_invert(&set);
+    p->nodes[node].set = set;
+    return node;
+}
+
+static int parse_atom(Parser* p) {
+    if (at_end(p))
+        return fail(p, "expected an expression", p->pos);
+    char c = peek(p);
+    switch (c) {
+    case '(': {
+        size_t start = p->pos++;
+        int node = parse_alternation(p);
+        if (node < 0)
+            return -1;
+        if (at_end(p) || peek(p) != ')')
+            return fail(p, "missing ')'", start);
+        ++p->pos;
+        return node;
+    }
+    case '[':
+        return parse_set(p);
+    case '*': case '+': case '?': case '{':
+        return fail(p, "nothing to repeat", p->pos);
+    default:
+        break;
+    }
+    int node = new_node(p, NODE_SET, -1, -1);
+    if (node < 0)
+        return -1;
+    ++p->pos;
+    if (c == '.') {
+        memset(&p->nodes[node].set, 0xFF, sizeof(ByteSet));
+    } else if (c == '\\') {
+        if (at_end(p))
+            return fail(p, "trailing '\\'", p->pos - 1);
+        char e = p->pattern.begin[p->pos++];
+        if (!escape_set(e, &p->nodes[node].set))
+            byteset_add(&p->nodes[node].set, escape_literal(e));
+    } else {
+        byteset_add(&p->nodes[node].set, (unsigned char)c);
+    }
+    return node;
+}
+
+// Parse a decimal number of repetitions, -1 if there is no digit.
+static int parse_count(Parser* p) {
+    if (at_end(p) || peek(p) < '0' || peek(p) > '9')
+        return -1;
+    int count = 0;
+    while (!at_end(p) && peek(p) >= '0' && peek(p) <= '9') {
+        if (count <= MAX_REPEAT)
+            count = count * 10 + (peek(p) - '0');
+        ++p->pos;
+    }
+    return count;
+}
+
+static int parse_repetition(Parser* p) {
+    int node = parse_atom(p);
+    while (node >= 0 && !at_end(p)) {
+        size_t start = p->pos;
+        int min, max;
+        switch (peek(p)) {
+        case '*': min = 0; max = REPEAT_INFINITE; ++p->pos; break;
+        case '+': min = 1; max = REPEAT_INFINITE; ++p->pos; break;
+        case '?': min = 0; max = 1;               ++p->pos; break;
+        case '{':
+            ++p->pos;
+            min = max = parse_count(p);
+            if (min < 0)
+                return fail(p, "invalid repetition", start);
+            if (!at_end(p) && peek(p) == ',') {
+                ++p->pos;
+                max = parse_count(p); /* -1 == REPEAT_INFINITE if omitted */
+            }
+            if (at_end(p) || peek(p) != '}')
+                return fail(p, "invalid repetition", start);
+            ++p->pos;
+            if (min > MAX_REPEAT || max > MAX_REPEAT)
+                return fail(p, "repetition is too large", start);
+            if (max != REPEAT_INFINITE && max < min)
+                return fail(p, "invalid repetition", start);
+            break;
+        default:
+            return node;
+        }
+        int repeat = new_node(p, NODE_REPEAT, node, -1);
+        if (repeat < 0)
+            return -1;
+        p->nodes[repeat].min = min;
+        p->nodes[repeat].max = max;
+        node = repeat;
+    }
+    return node;
+}
+
+static int parse_concatenation(Parser* p) {
+    int node = -1;
+    while (!at_end(p) && peek(p) != '|' && peek(p) != ')') {
+        int next = parse_repetition(p);
+        if (next < 0)
+            return -1;
+        node = node < 0 ? next : new_node(p, NODE_CONCAT, node, next);
+        if (node < 0)
+            return -1;
+    }
+    return node < 0 ? new_node(p, NODE_EMPTY, -1, -1) : node;
+}
+
+static int parse_alternation(Parser* p) {
+    int node = parse_concatenation(p);
+    while (node >= 0 && !at_end(p) && peek(p) == '|') {
+        ++p->pos;
+        int next = parse_concatenation(p);
+        if (next < 0)
+            return -1;
+        node = new_node(p, NODE_ALT, node, next);
+    }
+    return node;
+}
+
+
+/* NFA: Thompson construction, each fragment has a single entry and a single exit state. */
+
+typedef struct NfaState {
+    int set;       /* node holding the ByteSet of the transition to 'out', -1 for epsilon transitions */
+    int out, out1; /* next states, -1 if none. 'out1' is only used by epsilon transitions. */
+} NfaState;
+
+typedef struct Nfa {
+    NfaState* states;
+    int nb_states, capacity;
+    bool failed;
+} Nfa;
+
+typedef struct Fragment {
+    int start, end;
+} Fragment;
+
+static int new_state(Nfa* nfa, int set, int out, int out1) {
+    if (nfa->failed)
+        return 0;
+    if (nfa->nb_states == nfa->capacity) {
+        int capacity = nfa->capacity == 0 ? 64 : 2 * nfa->capacity;
+        NfaState* states = capacity > MAX_NFA_STATES ? NULL : (NfaState*)realloc(nfa->states, capacity * sizeof(NfaState));
+        if (states == NULL) {
+            nfa->failed = true;
+            return 0;
+        }
+        nfa->states = states;
+        nfa->capacity = capacity;
+    }
+    nfa->states[nfa->nb_states] = (NfaState){ set, out, out1 };
+    return nfa->nb_states++;
+}
+
+static Fragment build_fragment(Nfa* nfa, Node const* nodes, int index) {
+    Node const* node = &nodes[index];
+    Fragment frag;
+    switch (node->type) {
+    case NODE_SET:
+        frag.end = new_state(nfa, -1, -1, -1);
+        frag.start = new_state(nfa, index, frag.end, -1);
+        return frag;
+    case NODE_CONCAT: {
+        Fragment left = build_fragment(nfa, nodes, node->left);
+        Fragment right = build_fragment(nfa, nodes, node->right);
+        if (!nfa->failed)
+            nfa->states[left.end].out = right.start;
+        return (Fragment){ left.start, right.end };
+    }
+    case NODE_ALT: {
+        Fragment left = build_fragment(nfa, nodes, node->left);
+        Fragment right = build_fragment(nfa, nodes, node->right);
+        frag.start = new_state(nfa, -1, left.start, right.start);
+        frag.end = new_state(nfa, -1, -1, -1);
+        if (!nfa->failed)
+            nfa->states[left.end].out = nfa->states[right.end].out = frag.end;
+        return frag;
+    }
+    case NODE_REPEAT: {
+        /* x{2,4} is built as x x (x (x)?)? and x{2,} as x x x* */
+        frag.start = new_state(nfa, -1, -1, -1);
+        frag.end = new_state(nfa, -1, -1, -1);
+        int last = frag.start;
+        for (int i = 0; i < node->min && !nfa->failed; ++i) {
+            Fragment copy = build_fragment(nfa, nodes, node->left);
+            nfa->states[last].out = copy.start;
+            last = copy.end;
+        }
+        if (node->max == REPEAT_INFINITE) {
+            Fragment copy = build_fragment(nfa, nodes, node->left);
+            int loop = new_state(nfa, -1, copy.start, frag.end);
+            if (!nfa->failed) {
+                nfa->states[copy.end].out = loop;
+                nfa->states[last].out = loop;
+            }
+            return frag;
+        }
+        for (int i = node->min; i < node->max && !nfa->failed; ++i) {
+            Fragment copy = build_fragment(nfa, nodes, node->left);
+            int split = new_state(nfa, -1, copy.start, frag.end);
+            nfa->states[last].out = split;
+            last = copy.end;
+        }
+        if (!nfa->failed)
+            nfa->states[last].out = frag.end;
+        return frag;
+    }
+    default: /* NODE_EMPTY */
+        frag.start = frag.end = new_state(nfa, -1, -1, -1);
+        return frag;
+    }
+}
+
+
+/* DFA: subset construction, over classes of bytes which are not distinguished by any ByteSet. */
+
+struct StrPattern {
+    uint8_t byte_class[256];
+    int nb_classes;
+    uint16_t const* transitions; /* [state * nb_classes + class], state 0 rejects everything, state 1 is the start */
+    bool const* accepting;       /* [state] */
+    
+    /* Fast path for patterns being a single ByteSet, possibly repeated, i.e. [a-z0-9-]{1,63}, scanned with SIMD */
+    bool is_single_set;
+    StrCharset single_set;
+    size_t min_size, max_size;
+};
+
+// Add `state` and all states reachable with epsilon transitions to `set`.
+static void add_closure(Nfa const* nfa, uint64_t* set, int state, int* stack) {
+    int nb_stack = 0;
+    stack[nb_stack++] = state;
+    while (nb_stack > 0) {
+        int s = stack[--nb_stack];
+        if (s < 0 || (set[s / 64] >> (s % 64)) & 1)
+            continue;
+        set[s / 64] |= (uint64_t)1 << (s % 64);
+        if (nfa->states[s].set < 0) {
+            stack[nb_stack++] = nfa->states[s].out;
+            stack[nb_stack++] = nfa->states[s].out1;
+        }
+    }
+}
+
+// DFA tables under construction, grown as states are added.
+typedef struct Dfa {
+    uint64_t* sets;        /* NFA states of each DFA state, 'words' per state, plus the candidate next state */
+    uint16_t* transitions; /* 'nb_classes' per state */
+    bool* accepting;
+    int capacity;          /* number of states the tables have room for */
+} Dfa;
+
+// Room for 'nb_states' states in the tables, zero-initialized, or false if there is not enough memory.
+static bool reserve_dfa_states(Dfa* dfa, int nb_states, int words, int nb_classes) {
+    if (nb_states <= dfa->capacity)
+        return true;
+    int capacity = dfa->capacity == 0 ? 16 : 2 * dfa->capacity;
+    if (capacity < nb_states)
+        capacity = nb_states;
+    size_t old_capacity = (size_t)dfa->capacity;
+    uint64_t* sets = (uint64_t*)realloc(dfa->sets, (size_t)capacity * words * sizeof(uint64_t));
+    if (sets != NULL)
+        dfa->sets = sets;
+    uint16_t* transitions = (uint16_t*)realloc(dfa->transitions, (size_t)capacity * nb_classes * sizeof(uint16_t));
+    if (transitions != NULL)
+        dfa->transitions = transitions;
+    bool* accepting = (bool*)realloc(dfa->accepting, (size_t)capacity * sizeof(bool));
+    if (accepting != NULL)
+        dfa->accepting = accepting;
+    if (sets == NULL || transitions == NULL || accepting == NULL)
+        return false; // the buffers which grew are released by the caller
+    memset(sets + old_capacity * words, 0, (capacity - old_capacity) * words * sizeof(uint64_t));
+    memset(transitions + old_capacity * nb_classes, 0, (capacity - old_capacity) * nb_classes * sizeof(uint16_t));
+    memset(accepting + old_capacity, 0, (capacity - old_capacity) * sizeof(bool));
+    dfa->capacity = capacity;
+    return true;
+}
+
+// Fill DFA tables, returns the number of DFA states, or -1 with 'error' if there are more than MAX_DFA_STATES
+// or not enough memory.
+static int build_dfa_states(Nfa const* nfa, Node const* nodes, Fragment frag, StrPattern const* pattern,
+                            Dfa* dfa, int* stack, char const** error) {
+    unsigned char representative[256];
+    for (int b = 255; b >= 0; --b)
+        representative[pattern->byte_class[b]] = (unsigned char)b;
+    
+    int words = (nfa->nb_states + 63) / 64;
+    int nb_classes = pattern->nb_classes;
+    int nb_dfa_states = 2; /* state 0: empty set, i.e. rejecting */
+    *error = "not enough memory";
+    if (!reserve_dfa_states(dfa, nb_dfa_states + 1, words, nb_classes))
+        return -1;
+    add_closure(nfa, dfa->sets + words, frag.start, stack);
+    for (int d = 1; d < nb_dfa_states; ++d) {
+        dfa->accepting[d] = (dfa->sets[(size_t)d * words + frag.end / 64] >> (frag.end % 64)) & 1;
+        for (int c = 0; c < nb_classes; ++c) {
+            // room for the candidate next state after the existing ones, the tables may move
+            if (!reserve_dfa_states(dfa, nb_dfa_states + 1, words, nb_classes))
+                return -1;
+            uint64_t const* set = dfa->sets + (size_t)d * words;
+            uint64_t* next = dfa->sets + (size_t)nb_dfa_states * words;
+            memset(next, 0, words * sizeof(uint64_t));
+            bool is_empty = true;
+            for (int s = 0; s < nfa->nb_states; ++s) {
+                NfaState const* state = &nfa->states[s];
+                if ((set[s / 64] >> (s % 64)) & 1 && state->set >= 0
+                    && byteset_has(&nodes[state->set].set, representative[c])) {
+                    add_closure(nfa, next, state->out, stack);
+                    is_empty = false;
+                }
+            }
+            int found = 0;
+            for (int e = 1; e < nb_dfa_states && !is_empty && found == 0; ++e)
+                if (memcmp(dfa->sets + (size_t)e * words, next, words * sizeof(uint64_t)) == 0)
+                    found = e;
+            if (found == 0 && !is_empty) {
+                if (nb_dfa_states == MAX_DFA_STATES) {
+                    *error = "pattern is too complex";
+                    return -1;
+                }
+                found = nb_dfa_states++;
+            }
+            dfa->transitions[d * nb_classes + c] = (uint16_t)found;
+        }
+    }
+    return nb_dfa_states;
+}
+
+static StrPattern* build_dfa(Nfa const* nfa, Node const* nodes, int nb_nodes, Fragment frag, char const** error) {
+    StrPattern pattern;
+    memset(&pattern, 0, sizeof(pattern));
+    
+    /* Splitting classes of bytes with each ByteSet, so that all bytes of a class have the same transitions. */
+    pattern.nb_classes = 1;
+    for (int n = 0; n < nb_nodes; ++n) {
+        if (nodes[n].type != NODE_SET)
+            continue;
+        int remap[256][2];
+        memset(remap, -1, sizeof(remap));
+        int nb_classes = 0;
+        for (int b = 0; b < 256; ++b) {
+            int* new_class = &remap[pattern.byte_class[b]][byteset_has(&nodes[n].set, (unsigned char)b)];
+            if (*new_class < 0)
+                *new_class = nb_classes++;
+            pattern.byte_class[b] = (uint8_t)*new_class;
+        }
+        pattern.nb_classes = nb_classes;
+    }
+    
+    Dfa dfa = { NULL, NULL, NULL, 0 };
+    int* stack = (int*)malloc(2 * nfa->nb_states * sizeof(int) + sizeof(int));
+    
+    StrPattern* result = NULL;
+    int nb_dfa_states = -1;
+    *error = "not enough memory";
+    if (stack != NULL)
+        nb_dfa_states = build_dfa_states(nfa, nodes, frag, &pattern, &dfa, stack, error);
+    if (nb_dfa_states > 0) {
+        /* Single allocation for the structure and its tables */
+        size_t transitions_size = (size_t)nb_dfa_states * pattern.nb_classes * sizeof(uint16_t);
+        result = (StrPattern*)malloc(sizeof(StrPattern) + transitions_size + nb_dfa_states * sizeof(bool));
+        if (result != NULL) {
+            *result = pattern;
+            uint16_t* result_transitions = (uint16_t*)(result + 1);
+            bool* result_accepting = (bool*)((char*)result_transitions + transitions_size);
+            memcpy(result_transitions, dfa.transitions, transitions_size);
+            memcpy(result_accepting, dfa.accepting, nb_dfa_states * sizeof(bool));
+            result->transitions = result_transitions;
+            result->accepting = result_accepting;
+        }
+    }
+    free(dfa.sets);
+    free(dfa.transitions);
+    free(dfa.accepting);
+    free(stack);
+    return result;
+}
+
+
+StrPattern* jvstr_pattern_compile(StrView pattern, char const** error, size_t* error_pos) {
+    Parser p;
+    memset(&p, 0, sizeof(p));
+    p.pattern = pattern;
+    int root = parse_alternation(&p);
+    if (root >= 0 && !at_end(&p))
+        root = fail(&p, "unmatched ')'", p.pos);
+    
+    StrPattern* result = NULL;
+    Nfa nfa = { NULL, 0, 0, false };
+    if (root >= 0) {
+        Fragment frag = build_fragment(&nfa, p.nodes, root);
+        if (nfa.failed)
+            fail(&p, "pattern is too complex", 0);
+        else if ((result = build_dfa(&nfa, p.nodes, p.nb_nodes, frag, &p.error)) == NULL)
+            p.error_pos = 0;
+    }
+    
+    if (result != NULL) {
+        Node const* node = &p.nodes[root];
+        size_t min = 1, max = 1;
+        if (node->type == NODE_REPEAT && p.nodes[node->left].type == NODE_SET) {
+            min = node->min;
+            max = node->max == REPEAT_INFINITE ? (size_t)-1 : (size_t)node->max;
+            node = &p.nodes[node->left];
+        }
+        if (node->type == NODE_SET) {
+            char members[256];
+            size_t nb_members = 0;
+            for (int b = 0; b < 256; ++b)
+                if (byteset_has(&node->set, (unsigned char)b))
+                    members[nb_members++] = (char)b;
+            result->is_single_set = true;
+            result->single_set = jvstr_charset_make((StrView){ members, nb_members });
+            result->min_size = min;
+            result->max_size = max;
+        }
+    } else {
+        *error = p.error;
+        *error_pos = p.error_pos;
+    }
+    free(p.nodes);
+    free(nfa.states);
+    return result;
+}
+
+void jvstr_pattern_free(StrPattern* pattern) {
+    free(pattern); /* tables are in the same allocation */
+}
+
+bool jvstr_pattern_match(StrPattern const* pattern, StrView str) {
+    if (pattern->is_single_set) {
+        if (str.size < pattern->min_size || str.size > pattern->max_size)
+            return false;
+        return jvstr_while_in_set(str, &pattern->single_set, 0) == str.size;
+    }
+    int nb_classes = pattern->nb_classes;
+    unsigned state = 1;
+    for (size_t i = 0; i < str.size && state != 0; ++i)
+        state = pattern->transitions[state * nb_classes + pattern->byte_class[(unsigned char)str.begin[i]]];
+    return pattern->accepting[state];
+}
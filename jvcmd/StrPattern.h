@@ -0,0 +1,72 @@
+/*
+This is the C header for the StrPattern structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef JVSTR_STRPATTERN
+#define JVSTR_STRPATTERN
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "StrView.h"
+
+/*
+StrPattern is a regular expression compiled into a DFA, so matching is a linear-time table walk.
+Only the whole string can match, as if the pattern was surrounded by ^ and $.
+Supported syntax, which works on bytes:
+    x           literal byte, special characters must be escaped with '\'
+    .           any byte
+    [a-z0-9_]   byte in the set, [^...] for byte not in the set
+    \d \w \s    digit, word character [A-Za-z0-9_], whitespace. \D \W \S are their complements.
+    xy          x followed by y
+    x|y         x or y
+    (x)         grouping
+    x* x+ x?    repetition: 0 or more, 1 or more, 0 or 1
+    x{n} x{n,} x{n,m}   repetition: exactly n, n or more, between n and m (at most 1000)
+*/
+typedef struct StrPattern StrPattern;
+
+// Compile `pattern`. Returns NULL if the pattern is invalid or too complex,
+// then `*error` is set to a static message and `*error_pos` to the offset of the error in pattern.
+StrPattern* jvstr_pattern_compile(StrView pattern, char const** error, size_t* error_pos);
+
+// Release memory of a pattern returned by jvstr_pattern_compile. NULL is accepted.
+void jvstr_pattern_free(StrPattern* pattern);
+
+// Check if the whole `str` matches the pattern.
+bool jvstr_pattern_match(StrPattern const* pattern, StrView str);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,138 @@
+/*
+This is the C implementation for the StrPool structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+#include "StrPool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Chunks double in size up to this limit, longer strings get a chunk of their own. */
+enum { FIRST_CHUNK_SIZE = 4096, MAX_CHUNK_SIZE = 1 << 20 };
+
+typedef struct StrPoolChunk {
+    struct StrPoolChunk* next;
+    size_t size; // number of bytes following the header
+} StrPoolChunk;
+
+bool jvstr_pool_init(StrPool* pool) {
+    memset(pool, 0, sizeof(*pool));
+    return jvstr_map_init(&pool->index, 0);
+}
+
+void jvstr_pool_free(StrPool* pool) {
+    StrPoolChunk* chunk = pool->chunks;
+    while (chunk != NULL) {
+        StrPoolChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(pool->strings);
+    jvstr_map_free(&pool->index);
+    memset(pool, 0, sizeof(*pool));
+}
+
+// Return `size` bytes of storage which will never move, NULL if there is not enough memory.
+static char* allocate(StrPool* pool, size_t size) {
+    if (size > pool->chunk_left) {
+        size_t chunk_size = FIRST_CHUNK_SIZE;
+        if (pool->chunks != NULL && pool->chunks->size < MAX_CHUNK_SIZE)
+            chunk_size = pool->chunks->size * 2;
+        else if (pool->chunks != NULL)
+            chunk_size = MAX_CHUNK_SIZE;
+        if (chunk_size < size)
+            chunk_size = size;
+        StrPoolChunk* chunk = (StrPoolChunk*)malloc(sizeof(StrPoolChunk) + chunk_size);
+        if (chunk == NULL)
+            return NULL;
+        chunk->size = chunk_size;
+        if (size == chunk_size && pool->chunks != NULL) {
+            // Dedicated chunk: keep filling the current one.
+            chunk->next = pool->chunks->next;
+            pool->chunks->next = chunk;
+            return (char*)(chunk + 1);
+        }
+        chunk->next = pool->chunks;
+        pool->chunks = chunk;
+        pool->chunk_free = (char*)(chunk + 1);
+        pool->chunk_left = chunk_size;
+    }
+    char* result = pool->chunk_free;
+    pool->chunk_free += size;
+    pool->chunk_left -= size;
+    return result;
+}
+
+StrView jvstr_pool_intern(StrPool* pool, StrView str, uint32_t* id) {
+    StrView interned = jvstr_pool_find(pool, str, id);
+    if (interned.begin != NULL)
+        return interned;
+    if (pool->size == pool->capacity) {
+        uint32_t capacity = pool->capacity == 0 ? 64 : pool->capacity * 2;
+        if (capacity <= pool->capacity)
+            return interned; // every id is used
+        StrView* strings = (StrView*)realloc(pool->strings, capacity * sizeof(StrView));
+        if (strings == NULL)
+            return interned;
+        pool->strings = strings;
+        pool->capacity = capacity;
+    }
+    char* copy = allocate(pool, str.size + 1);
+    if (copy == NULL)
+        return interned;
+    if (str.size != 0)
+        memcpy(copy, str.begin, str.size);
+    copy[str.size] = '\0';
+
+    StrView key = { copy, str.size };
+    void** value = jvstr_map_insert(&pool->index, key, NULL);
+    if (value == NULL)
+        return interned; // the copy stays unused until the pool is freed
+    *value = (void*)(uintptr_t)pool->size;
+    pool->strings[pool->size] = key;
+    if (id != NULL)
+        *id = pool->size;
+    pool->size += 1;
+    return key;
+}
+
+StrView jvstr_pool_find(StrPool const* pool, StrView str, uint32_t* id) {
+    StrMapEntry* entry = jvstr_map_find(&pool->index, str);
+    if (entry == NULL) {
+        StrView not_found = { NULL, 0 };
+        return not_found;
+    }
+    if (id != NULL)
+        *id = (uint32_t)(uintptr_t)entry->value;
+    return entry->key;
+}
+
+StrView jvstr_pool_get(StrPool const* pool, uint32_t id) {
+    return pool->strings[id];
+}
@@ -0,0 +1,91 @@
+/*
+This is the C header for the StrPool structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef JVSTR_STRPOOL
+#define JVSTR_STRPOOL
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "StrMap.h"
+
+/*
+StrPool interns strings: each distinct string is copied once into the pool,
+and interning an equal string again gives back the same StrView and the same id.
+So two strings interned in the same pool are equal if and only if their `begin` pointers
+(or their ids) are equal, and no byte needs to be compared.
+Ids are consecutive from 0, in order of first interning, so they can index user arrays.
+
+Copies are NUL-terminated, stored in chunks which are never moved: interned views stay valid
+until jvstr_pool_free. A StrMap indexes the copies to find existing strings.
+Usage:
+    StrPool pool;
+    jvstr_pool_init(&pool);
+    uint32_t id;
+    StrView a = jvstr_pool_intern(&pool, STRVIEW_MAKE("eu-west-1"), &id);
+    StrView b = jvstr_pool_intern(&pool, StrView_make(argv[1]), NULL);
+    if (a.begin == b.begin) ...
+    jvstr_pool_free(&pool);
+*/
+typedef struct StrPool {
+    StrMap index;              // interned strings, with their id as value
+    StrView* strings;          // interned strings by id
+    uint32_t size;             // number of interned strings
+    uint32_t capacity;         // number of elements of `strings`
+    struct StrPoolChunk* chunks; // chunks of storage, the most recent first
+    char* chunk_free;          // first free byte in the most recent chunk
+    size_t chunk_left;         // number of free bytes in the most recent chunk
+} StrPool;
+
+// Initialize an empty pool. Returns false if there is not enough memory.
+bool jvstr_pool_init(StrPool* pool);
+
+// Release all memory of the pool, interned views become invalid.
+void jvstr_pool_free(StrPool* pool);
+
+// Return the interned copy of `str`, copying it on first use, and set `*id` if `id` is not NULL.
+// The returned view is NUL-terminated. Its `begin` is NULL if there is not enough memory.
+StrView jvstr_pool_intern(StrPool* pool, StrView str, uint32_t* id);
+
+// Find the interned copy of `str` without interning it, and set `*id` if `id` is not NULL.
+// Its `begin` is NULL if `str` was never interned.
+StrView jvstr_pool_find(StrPool const* pool, StrView str, uint32_t* id);
+
+// Return the interned string of identifier `id`, which must be less than pool->size.
+StrView jvstr_pool_get(StrPool const* pool, uint32_t id);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,204 @@
+/*
+This is the C implementation for the StrSwitch structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+#include "StrSwitch.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Hash and displace: the hash of a case selects a bucket, and each bucket stores the displacement `d`
+which sends all its cases to free slots: slot = (h1 + d * h2) mod nb_slots.
+As h2 is odd and nb_slots a power of two, the slots tried for one case cover the whole table,
+so buckets are placed from the largest to the smallest while there is room to choose.
+The hash is FNV-1a, simple enough to be computed by constexpr functions (see jvcmd::make_switch),
+which build the same tables as jvstr_switch_compile.
+*/
+enum { MAX_SEEDS = 64 };
+
+uint64_t jvstr_switch_hash(StrView str, uint64_t seed, bool ignore_case) {
+    uint64_t hash = 0xcbf29ce484222325u ^ seed;
+    for (size_t i = 0; i < str.size; ++i) {
+        unsigned char c = (unsigned char)str.begin[i];
+        if (ignore_case && c >= 'A' && c <= 'Z')
+            c = (unsigned char)(c - 'A' + 'a');
+        hash = (hash ^ c) * 0x100000001b3u;
+    }
+    return hash ^ (hash >> 29);
+}
+
+static uint32_t bucket_of(StrSwitch const* sw, uint64_t hash) {
+    return (uint32_t)((hash >> 32) % sw->nb_buckets);
+}
+
+static uint32_t slot_of(StrSwitch const* sw, uint64_t hash, uint32_t displacement) {
+    uint32_t h1 = (uint32_t)hash, h2 = (uint32_t)(hash >> 16) | 1;
+    return (h1 + displacement * h2) & (sw->nb_slots - 1);
+}
+
+static bool switch_equal(StrSwitch const* sw, StrView a, StrView b) {
+    return sw->ignore_case ? jvstr_equal_icase(a, b) : jvstr_equal(a, b);
+}
+
+// Try to place all cases with sw->seed into `displacements` and `slots`,
+// using `hashes`, `order`, `bucket_start` and `bucket_order` as storage.
+static bool place_cases(StrSwitch const* sw, uint32_t* displacements, uint32_t* slots, StrView const* cases,
+                        uint64_t* hashes, uint32_t* order, uint32_t* bucket_start, uint32_t* bucket_order) {
+    uint32_t nb_buckets = sw->nb_buckets, nb_cases = sw->nb_cases;
+    memset(displacements, 0, nb_buckets * sizeof(uint32_t)); // empty buckets are never placed, but are read by find
+    memset(slots, 0, sw->nb_slots * sizeof(uint32_t));
+    // Counting sort of the cases by bucket, in index order within a bucket so that duplicates come after the first.
+    memset(bucket_start, 0, (nb_buckets + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < nb_cases; ++i) {
+        hashes[i] = jvstr_switch_hash(cases[i], sw->seed, sw->ignore_case);
+        bucket_start[bucket_of(sw, hashes[i]) + 1] += 1;
+    }
+    uint32_t max_size = 0;
+    for (uint32_t b = 0; b < nb_buckets; ++b) {
+        if (bucket_start[b + 1] > max_size)
+            max_size = bucket_start[b + 1];
+        bucket_start[b + 1] += bucket_start[b];
+    }
+    for (uint32_t i = 0; i < nb_cases; ++i)
+        order[bucket_start[bucket_of(sw, hashes[i])]++] = i;
+    for (uint32_t b = nb_buckets; b > 0; --b)
+        bucket_start[b] = bucket_start[b - 1];
+    bucket_start[0] = 0;
+    // Buckets from the largest to the smallest, empty ones are skipped.
+    uint32_t nb_ordered = 0;
+    for (uint32_t size = max_size; size > 0; --size)
+        for (uint32_t b = 0; b < nb_buckets; ++b)
+            if (bucket_start[b + 1] - bucket_start[b] == size)
+                bucket_order[nb_ordered++] = b;
+
+    for (uint32_t k = 0; k < nb_ordered; ++k) {
+        uint32_t bucket = bucket_order[k];
+        uint32_t const* members = order + bucket_start[bucket];
+        uint32_t nb_members = bucket_start[bucket + 1] - bucket_start[bucket];
+        uint32_t displacement = 0;
+        for (;; ++displacement) {
+            if (displacement == sw->nb_slots)
+                return false; // cases of the bucket cannot be separated with this seed, larger ones repeat the same slots
+            bool is_free = true;
+            for (uint32_t i = 0; i < nb_members && is_free; ++i) {
+                uint32_t slot = slot_of(sw, hashes[members[i]], displacement);
+                is_free = slots[slot] == 0;
+                // Two cases of the bucket in the same slot: fine only if they are equal, then the first is kept.
+                for (uint32_t j = 0; j < i && is_free; ++j) {
+                    if (slot_of(sw, hashes[members[j]], displacement) == slot)
+                        is_free = hashes[members[j]] == hashes[members[i]] && switch_equal(sw, cases[members[j]], cases[members[i]]);
+                }
+            }
+            if (is_free)
+                break;
+        }
+        displacements[bucket] = displacement;
+        for (uint32_t i = 0; i < nb_members; ++i) {
+            uint32_t* slot = &slots[slot_of(sw, hashes[members[i]], displacement)];
+            if (*slot == 0)
+                *slot = members[i] + 1;
+        }
+    }
+    return true;
+}
+
+StrSwitch* jvstr_switch_compile(StrView const* cases, size_t nb_cases, bool ignore_case, char const** error) {
+    if (nb_cases > INT32_MAX / 2) {
+        *error = "too many cases";
+        return NULL;
+    }
+    size_t nb_slots = 2;
+    while (nb_slots < 2 * nb_cases)
+        nb_slots *= 2;
+    size_t nb_buckets = nb_cases > 0 ? nb_cases : 1;
+
+    // The switch and its tables are in the same allocation, the cases first as they are the most aligned.
+    size_t size = sizeof(StrSwitch) + nb_cases * sizeof(StrView) + (nb_buckets + nb_slots) * sizeof(uint32_t);
+    StrSwitch* sw = (StrSwitch*)malloc(size);
+    size_t temp_size = nb_cases * (sizeof(uint64_t) + sizeof(uint32_t)) + (2 * nb_buckets + 1) * sizeof(uint32_t);
+    void* temp = malloc(temp_size);
+    if (sw == NULL || temp == NULL) {
+        free(sw);
+        free(temp);
+        *error = "not enough memory";
+        return NULL;
+    }
+    StrView* sw_cases = (StrView*)(sw + 1);
+    uint32_t* displacements = (uint32_t*)(sw_cases + nb_cases);
+    uint32_t* slots = displacements + nb_buckets;
+    if (nb_cases > 0)
+        memcpy(sw_cases, cases, nb_cases * sizeof(StrView));
+    sw->nb_buckets = (uint32_t)nb_buckets;
+    sw->nb_slots = (uint32_t)nb_slots;
+    sw->displacements = displacements;
+    sw->slots = slots;
+    sw->cases = sw_cases;
+    sw->nb_cases = (uint32_t)nb_cases;
+    sw->ignore_case = ignore_case;
+    sw->is_allocated = true;
+    uint64_t* hashes = (uint64_t*)temp;
+    uint32_t* order = (uint32_t*)(hashes + nb_cases);
+    uint32_t* bucket_start = order + nb_cases;
+    uint32_t* bucket_order = bucket_start + nb_buckets + 1;
+
+    bool placed = false;
+    for (sw->seed = 0; sw->seed < MAX_SEEDS; ++sw->seed) {
+        placed = place_cases(sw, displacements, slots, sw_cases, hashes, order, bucket_start, bucket_order);
+        if (placed)
+            break;
+    }
+    free(temp);
+    if (!placed) {
+        free(sw);
+        *error = "no seed of the perfect hash separates the cases";
+        return NULL;
+    }
+    return sw;
+}
+
+void jvstr_switch_free(StrSwitch* sw) {
+    if (sw != NULL && sw->is_allocated)
+        free(sw); /* tables are in the same allocation */
+}
+
+int jvstr_switch_candidate(StrSwitch const* sw, StrView str) {
+    uint64_t hash = jvstr_switch_hash(str, sw->seed, sw->ignore_case);
+    uint32_t index = sw->slots[slot_of(sw, hash, sw->displacements[bucket_of(sw, hash)])];
+    if (index == 0 || index > sw->nb_cases) // slots loaded from a file are not trusted
+        return -1;
+    return (int)index - 1;
+}
+
+int jvstr_switch_find(StrSwitch const* sw, StrView str) {
+    int index = jvstr_switch_candidate(sw, str);
+    if (index < 0 || !switch_equal(sw, sw->cases[index], str))
+        return -1;
+    return index;
+}
@@ -0,0 +1,102 @@
+/*
+This is the C header for the StrSwitch structure of the jvstr library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It contains both the API and the documentation.
+jvstr is a library to manipulate strings in the C language.
+The library is available under the Boost Software License 1.0, whose terms are below:
+
+Boost Software License - Version 1.0 - August 17th, 2003
+
+Permission is hereby granted, free of charge, to any person or organization
+obtaining a copy of the software and accompanying documentation covered by
+this license (the "Software") to use, reproduce, display, distribute,
+execute, and transmit the Software, and to prepare derivative works of the
+Software, and to permit third-parties to whom the Software is furnished to
+do so, all subject to the following:
+
+The copyright notices in the Software and this entire statement, including
+the above license grant, this restriction and the following disclaimer,
+must be included in all copies of the Software, in whole or in part, and
+all derivative works of the Software, unless such copies or derivative
+works are solely in the form of machine-executable object code generated by
+a source language processor.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef JVSTR_STRSWITCH
+#define JVSTR_STRSWITCH
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "StrView.h"
+
+/*
+StrSwitch maps a string to its index in a fixed list of cases, to dispatch on strings like a C switch on integers.
+The cases are indexed by a perfect hash, built once by jvstr_switch_compile: each case has its own slot,
+so a lookup is one hash and one comparison with the single candidate, whatever the number of cases.
+Cases are not copied: the bytes they point to must outlive the switch.
+Usage:
+    enum { OP_ADD, OP_SUB, OP_MULT, OP_DIV };
+    static StrView const operations[] = { STRVIEW_INIT("add"), STRVIEW_INIT("sub"), STRVIEW_INIT("mult"), STRVIEW_INIT("div") };
+    char const* error;
+    StrSwitch* sw = jvstr_switch_compile(operations, 4, false, &error);
+    switch (jvstr_switch_find(sw, StrView_make(argv[1]))) {
+    case OP_ADD: ...
+    case -1: // not a case
+    }
+    jvstr_switch_free(sw);
+
+The tables are public so that they can also be built ahead of time, with the same hash and builder:
+by tools/jvcmd-gen.c in generated sources, by jvcmd::make_switch and jvcmd::make_spec of <jvcmd/jvcmd.hpp>
+at compile time, and in the files of <jvcmd/jvspec.h>.
+    hash        FNV-1a of the bytes, ASCII-lowercase if ignore_case, whose offset basis is xored with 'seed',
+                then `hash ^= hash >> 29`
+    bucket      (hash >> 32) % nb_buckets, with nb_buckets = max(nb_cases, 1)
+    slot        ((uint32_t)hash + d * ((uint32_t)(hash >> 16) | 1)) % nb_slots, with d the displacement of the bucket
+                and nb_slots the smallest power of 2 >= 2 * nb_cases, at least 2
+    builder     buckets from the largest to the smallest (by index if equal), each with the smallest displacement
+                sending its cases to free slots; equal cases may share a slot, the first one is kept.
+                The seed is the first of 0, 1... 63 with which every bucket is placed.
+*/
+typedef struct StrSwitch {
+    uint64_t seed;
+    uint32_t nb_buckets, nb_slots;
+    uint32_t const* displacements; // [nb_buckets]
+    uint32_t const* slots;         // [nb_slots], index + 1 of the case in each slot, 0 if empty
+    StrView const* cases;          // [nb_cases], compared by jvstr_switch_find. May be NULL if only candidates are used.
+    uint32_t nb_cases;
+    bool ignore_case;
+    bool is_allocated;             // built by jvstr_switch_compile, else jvstr_switch_free does nothing
+} StrSwitch;
+
+// Build the switch of `nb_cases` cases, compared ignoring ASCII case if `ignore_case`.
+// If several cases are equal, the first one is found. Returns NULL if there is not enough memory,
+// or if no seed of the hash gives each case its own slot (not seen in practice), then `*error` is set to a static message.
+StrSwitch* jvstr_switch_compile(StrView const* cases, size_t nb_cases, bool ignore_case, char const** error);
+
+// Release memory of a switch returned by jvstr_switch_compile. NULL and switches built ahead of time are accepted.
+void jvstr_switch_free(StrSwitch* sw);
+
+// Index in the cases of the one equal to `str`, -1 if there is none.
+int jvstr_switch_find(StrSwitch const* sw, StrView str);
+
+// Index of the only case which may be equal to `str`, -1 if there is none: the caller compares them.
+int jvstr_switch_candidate(StrSwitch const* sw, StrView str);
+
+// Hash of `str` described above.
+uint64_t jvstr_switch_hash(StrView str, uint64_t seed, bool ignore_case);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -28,150 +28,1335 @@ FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
 ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 DEALINGS IN THE SOFTWARE.
 */
+#define JVSTR_INLINE_DEFINITIONS
 #include "StrView.h"
 
 #include <string.h>
+#include <stdlib.h>
 #include <assert.h>
+#include <stdint.h>
+
+#if defined(_GNU_SOURCE) && defined(__GLIBC__)
+#define JVSTR_HAS_MEMRCHR
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 static size_t min_size(size_t a, size_t b) {
     return a < b ? a : b;
 }
 
+// ASCII lowercase of a byte, other bytes are unchanged.
+static unsigned char fold_case(unsigned char c) {
+    return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
 
-StrView StrView_make(char const* nt_str) {
-    return (StrView){.begin = nt_str, .size = strlen(nt_str)};
+#if defined(__AVX2__)
+static __m256i fold_case32(__m256i x) {
+    // signed comparisons: bytes >= 0x80 are negative so never in 'A'..'Z'
+    __m256i is_upper = _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8('A' - 1)),
+                                        _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), x));
+    return _mm256_or_si256(x, _mm256_and_si256(is_upper, _mm256_set1_epi8(0x20)));
 }
+#endif
+#if defined(__SSE2__)
+static __m128i fold_case16(__m128i x) {
+    __m128i is_upper = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('A' - 1)),
+                                     _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), x));
+    return _mm_or_si128(x, _mm_and_si128(is_upper, _mm_set1_epi8(0x20)));
+}
+#endif
 
-char jvstr_extract_first(StrView* view) {
-    --view->size;
-    return *(view->begin++);
+// Index of the first byte differing between a and b ignoring ASCII case, `size` if none.
+static size_t mismatch_icase(unsigned char const* a, unsigned char const* b, size_t size) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= size; i += 32) {
+        __m256i va = fold_case32(_mm256_loadu_si256((__m256i const*)(a + i)));
+        __m256i vb = fold_case32(_mm256_loadu_si256((__m256i const*)(b + i)));
+        unsigned equal = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+        if (equal != 0xFFFFFFFFu)
+            return i + __builtin_ctz(~equal);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= size; i += 16) {
+        __m128i va = fold_case16(_mm_loadu_si128((__m128i const*)(a + i)));
+        __m128i vb = fold_case16(_mm_loadu_si128((__m128i const*)(b + i)));
+        unsigned equal = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+        if (equal != 0xFFFFu)
+            return i + __builtin_ctz(~equal);
+    }
+#endif
+    while (i < size && fold_case(a[i]) == fold_case(b[i]))
+        ++i;
+    return i;
 }
 
-char jvstr_extract_last(StrView* view) {
-    --view->size;
-    return *(view->begin + view->size);
+// Check if a and b are equal, ignoring ASCII case.
+bool jvstr_equal_icase(StrView a, StrView b) {
+    if (a.size != b.size)
+        return false;
+    return mismatch_icase((unsigned char const*)a.begin, (unsigned char const*)b.begin, a.size) == a.size;
 }
 
+// Compare a and b lexicographically as if ASCII uppercase letters were lowercase.
+int jvstr_compare_icase(StrView a, StrView b) {
+    size_t minsize = min_size(a.size, b.size);
+    size_t i = mismatch_icase((unsigned char const*)a.begin, (unsigned char const*)b.begin, minsize);
+    if (i < minsize)
+        return (int)fold_case((unsigned char)a.begin[i]) - (int)fold_case((unsigned char)b.begin[i]);
+    return a.size < b.size ? -1 : a.size > b.size ? 1 : 0;
+}
 
-// Return first part and write second part in view.
-StrView jvstr_split(StrView* view, size_t where, size_t nb_discarded) {
-    nb_discarded = min_size(nb_discarded, view->size - where); // prevent overflow
-    StrView retview = { .begin = view->begin, .size = where };
-    view->begin += where + nb_discarded;
-    view->size -= where + nb_discarded;
-    return retview;
+size_t jvstr_find(StrView str, char ch) {
+    char const* ch_found = (char const*)memchr(str.begin, ch, str.size);
+    return ch_found != NULL ? (size_t)(ch_found - str.begin) : str.size;
 }
 
+#if defined(__SSE2__)
+// Masks of the bytes equal to `a` and to `b` in a block of 64 bytes.
+static void block_masks64(unsigned char const* block, char a, char b, uint64_t* mask_a, uint64_t* mask_b) {
+#if defined(__AVX2__)
+    const __m256i va = _mm256_set1_epi8(a), vb = _mm256_set1_epi8(b);
+    __m256i lo = _mm256_loadu_si256((__m256i const*)block), hi = _mm256_loadu_si256((__m256i const*)(block + 32));
+    *mask_a = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, va))
+        | (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, va)) << 32;
+    *mask_b = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, vb))
+        | (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, vb)) << 32;
+#else
+    const __m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b);
+    *mask_a = *mask_b = 0;
+    for (int i = 0; i < 64; i += 16) {
+        __m128i x = _mm_loadu_si128((__m128i const*)(block + i));
+        *mask_a |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, va)) << i;
+        *mask_b |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, vb)) << i;
+    }
+#endif
+}
 
+// Mask of the bytes preceded by an odd number of escapers (same technique as simdjson).
+// `prev_escaped` is 1 if the first byte of the block is escaped, and is updated for the next block.
+static uint64_t find_escaped64(uint64_t escaper, uint64_t* prev_escaped) {
+    const uint64_t even_bits = 0x5555555555555555u;
+    escaper &= ~*prev_escaped; // an escaped escaper does not start a run
+    uint64_t follows_escape = (escaper << 1) | *prev_escaped;
+    uint64_t odd_run_starts = escaper & ~even_bits & ~follows_escape;
+    uint64_t runs_starting_on_even_bits = odd_run_starts + escaper;
+    *prev_escaped = runs_starting_on_even_bits < escaper; // carry of the addition
+    uint64_t invert_mask = runs_starting_on_even_bits << 1;
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+#endif
 
-// Check if two StrView's content are equals.
-bool jvstr_equal(StrView a, StrView b) {
-    if (a.size != b.size) {
-        return false;
+// Find first occurrence of `ch` which is not preceded by an odd number of `escaper`.
+size_t jvstr_find_unescaped(StrView str, char ch, char escaper) {
+#if defined(__SSE2__)
+    size_t i = 0;
+    uint64_t prev_escaped = 0;
+    unsigned char const* s = (unsigned char const*)str.begin;
+    uint64_t mask_ch, mask_escaper;
+    for (; i + 64 <= str.size; i += 64) {
+        block_masks64(s + i, ch, escaper, &mask_ch, &mask_escaper);
+        if (mask_escaper == 0 && prev_escaped == 0) {
+            // most blocks: nothing is escaped
+            if (mask_ch != 0)
+                return i + __builtin_ctzll(mask_ch);
+            continue;
+        }
+        uint64_t found = mask_ch & ~find_escaped64(mask_escaper, &prev_escaped);
+        if (found != 0)
+            return i + __builtin_ctzll(found);
     }
-    return jvstr_compare(a, b) == 0;
+    if (i < str.size) {
+        // last partial block, copied so that the loads stay within bounds
+        unsigned char tail[64] = {0};
+        size_t rest = str.size - i;
+        memcpy(tail, s + i, rest);
+        block_masks64(tail, ch, escaper, &mask_ch, &mask_escaper);
+        uint64_t in_bounds = ((uint64_t)1 << rest) - 1;
+        uint64_t found = mask_ch & in_bounds & ~find_escaped64(mask_escaper & in_bounds, &prev_escaped);
+        if (found != 0)
+            return i + __builtin_ctzll(found);
+    }
+    return str.size;
+#else
+    bool escaped = false;
+    for (size_t i = 0; i < str.size; ++i) {
+        char c = str.begin[i];
+        if (c == ch && !escaped)
+            return i;
+        escaped = !escaped && c == escaper;
+    }
+    return str.size;
+#endif
 }
 
-// Compare two StrView lexicographically. Returns negative if a < b, positive if a > b, 0 if a == b.
-int jvstr_compare(StrView a, StrView b) {
-    size_t minsize = min_size(a.size, b.size);
-    int result = memcmp(a.begin, b.begin, minsize);
-    // comparing size. if a is empty: negative, if b is empty: positive, both: 0
-    return result != 0 ? result : (int)(a.size - b.size);
+// Find last occurrence of `ch`, -1 if not found.
+size_t jvstr_rfind(StrView str, char ch) {
+#if defined(JVSTR_HAS_MEMRCHR)
+    char const* found = (char const*)memrchr(str.begin, ch, str.size);
+    return found != NULL ? (size_t)(found - str.begin) : (size_t)-1;
+#else
+    size_t end = str.size; // bytes before `end` remain to be checked
+#if defined(__AVX2__)
+    const __m256i target = _mm256_set1_epi8(ch);
+    for (; end >= 32; end -= 32) {
+        unsigned mask = (unsigned)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(target, _mm256_loadu_si256((__m256i const*)(str.begin + end - 32))));
+        if (mask != 0)
+            return end - 32 + (31 - __builtin_clz(mask));
+    }
+#elif defined(__SSE2__)
+    const __m128i target = _mm_set1_epi8(ch);
+    for (; end >= 16; end -= 16) {
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(target, _mm_loadu_si128((__m128i const*)(str.begin + end - 16))));
+        if (mask != 0)
+            return end - 16 + (31 - __builtin_clz(mask));
+    }
+#endif
+    while (end > 0) {
+        if (str.begin[--end] == ch)
+            return end;
+    }
+    return -1;
+#endif
 }
 
+// Build the set of bytes contained in `chars`.
+StrCharset jvstr_charset_make(StrView chars) {
+    StrCharset set;
+    memset(&set, 0, sizeof(set));
+    for (size_t i = 0; i < chars.size; ++i) {
+        unsigned char b = (unsigned char)chars.begin[i];
+        set.bitmap[b >> 3] |= (unsigned char)(1u << (b & 7));
+        set.nibbles[b >> 7][b & 15] |= (unsigned char)(1u << ((b >> 4) & 7));
+    }
+    return set;
+}
 
-// Check if str starts with prefix.
-bool jvstr_starts_with(StrView str, StrView prefix, size_t starting_pos) {
-    if (str.size < starting_pos + prefix.size) {
-        return false;
+#if defined(__AVX2__)
+// Bit i of the result is set if byte i of `block` is in the set. Tables are duplicated in both 128-bit lanes.
+static unsigned charset_mask32(__m256i block, __m256i table_low, __m256i table_high) {
+    const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                          1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    __m256i low_nibble = _mm256_and_si256(block, _mm256_set1_epi8(0x0F));
+    __m256i high_nibble = _mm256_and_si256(_mm256_srli_epi16(block, 4), _mm256_set1_epi8(0x0F));
+    __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(table_low, low_nibble),
+                                     _mm256_shuffle_epi8(table_high, low_nibble), block); // by bit 7 of block
+    __m256i bit = _mm256_shuffle_epi8(bits, high_nibble);
+    return (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit));
+}
+#elif defined(__SSSE3__)
+// Bit i of the result is set if byte i of `block` is in the set.
+static unsigned charset_mask16(__m128i block, __m128i table_low, __m128i table_high) {
+    const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    __m128i low_nibble = _mm_and_si128(block, _mm_set1_epi8(0x0F));
+    __m128i high_nibble = _mm_and_si128(_mm_srli_epi16(block, 4), _mm_set1_epi8(0x0F));
+    __m128i is_high = _mm_cmplt_epi8(block, _mm_setzero_si128()); // bytes >= 0x80
+    __m128i row = _mm_or_si128(_mm_andnot_si128(is_high, _mm_shuffle_epi8(table_low, low_nibble)),
+                               _mm_and_si128(is_high, _mm_shuffle_epi8(table_high, low_nibble)));
+    __m128i bit = _mm_shuffle_epi8(bits, high_nibble);
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(row, bit), bit));
+}
+#endif
+
+// Index of the first byte from starting_pos whose membership differs from `in_set`, str.size if none.
+static size_t scan_charset(StrView str, StrCharset const* set, size_t starting_pos, bool in_set) {
+    size_t i = starting_pos;
+    unsigned char const* s = (unsigned char const*)str.begin;
+#if defined(__AVX2__)
+    __m256i table_low = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const*)set->nibbles[0]));
+    __m256i table_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const*)set->nibbles[1]));
+    for (; i + 32 <= str.size; i += 32) {
+        unsigned mask = charset_mask32(_mm256_loadu_si256((__m256i const*)(s + i)), table_low, table_high);
+        if (in_set)
+            mask = ~mask;
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
     }
-    return strncmp(str.begin + starting_pos, prefix.begin, prefix.size) == 0;
+#elif defined(__SSSE3__)
+    __m128i table_low = _mm_loadu_si128((__m128i const*)set->nibbles[0]);
+    __m128i table_high = _mm_loadu_si128((__m128i const*)set->nibbles[1]);
+    for (; i + 16 <= str.size; i += 16) {
+        unsigned mask = charset_mask16(_mm_loadu_si128((__m128i const*)(s + i)), table_low, table_high);
+        if (in_set)
+            mask = ~mask & 0xFFFF;
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+#endif
+    while (i < str.size && ((set->bitmap[s[i] >> 3] >> (s[i] & 7)) & 1) == in_set)
+        ++i;
+    return i;
 }
 
-// Check if str ends with suffix.
-bool jvstr_ends_with(StrView str, StrView suffix) {
-    if (str.size < suffix.size) {
-        return false;
+// Index of the first char at or after 'starting_pos' which is not in the set, str.size if none.
+size_t jvstr_while_in_set(StrView str, StrCharset const* set, size_t starting_pos) {
+    return scan_charset(str, set, starting_pos, true);
+}
+
+// Index of the first char at or after 'starting_pos' which is in the set, str.size if none.
+size_t jvstr_until_in_set(StrView str, StrCharset const* set, size_t starting_pos) {
+    return scan_charset(str, set, starting_pos, false);
+}
+
+// Find last char which is in the set, -1 if not found.
+size_t jvstr_rfind_in_set(StrView str, StrCharset const* set) {
+    unsigned char const* s = (unsigned char const*)str.begin;
+    size_t end = str.size; // bytes before `end` remain to be checked
+#if defined(__AVX2__)
+    __m256i table_low = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const*)set->nibbles[0]));
+    __m256i table_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const*)set->nibbles[1]));
+    for (; end >= 32; end -= 32) {
+        unsigned mask = charset_mask32(_mm256_loadu_si256((__m256i const*)(s + end - 32)), table_low, table_high);
+        if (mask != 0)
+            return end - 32 + (31 - __builtin_clz(mask));
     }
-    return strncmp(str.begin + str.size - suffix.size, suffix.begin, suffix.size) == 0;
+#elif defined(__SSSE3__)
+    __m128i table_low = _mm_loadu_si128((__m128i const*)set->nibbles[0]);
+    __m128i table_high = _mm_loadu_si128((__m128i const*)set->nibbles[1]);
+    for (; end >= 16; end -= 16) {
+        unsigned mask = charset_mask16(_mm_loadu_si128((__m128i const*)(s + end - 16)), table_low, table_high);
+        if (mask != 0)
+            return end - 16 + (31 - __builtin_clz(mask));
+    }
+#endif
+    while (end > 0) {
+        --end;
+        if ((set->bitmap[s[end] >> 3] >> (s[end] & 7)) & 1)
+            return end;
+    }
+    return -1;
 }
 
-size_t jvstr_find(StrView str, char ch) {
-    char const* ch_found = (char const*)memchr(str.begin, ch, str.size);
-    return ch_found != NULL ? (size_t)(ch_found - str.begin) : str.size;
+// Find last char which is in charset, -1 if not found.
+size_t jvstr_rfind_any(StrView str, StrView charset) {
+    if (charset.size == 1)
+        return jvstr_rfind(str, charset.begin[0]);
+    StrCharset set = jvstr_charset_make(charset);
+    return jvstr_rfind_in_set(str, &set);
 }
 
-// Find first occurrence of `ch` which is not preceded by `escaper`
-size_t jvstr_find_unescaped(StrView str, char ch, char escaper) {
-    size_t ch_found = jvstr_find(str, ch);
-    if (ch_found == 0) {
-        return ch_found;
+// Number of consecutive chars at beginning of str which are all in charset.
+size_t jvstr_while_in(StrView str, StrView charset, size_t starting_pos) {
+    StrCharset set = jvstr_charset_make(charset);
+    return jvstr_while_in_set(str, &set, starting_pos);
+}
+
+// Number of consecutive chars at beginning of str which are all NOT in charset.
+size_t jvstr_until_in(StrView str, StrView charset, size_t starting_pos) {
+    StrCharset set = jvstr_charset_make(charset);
+    return jvstr_until_in_set(str, &set, starting_pos);
+}
+
+// Byte i of a string of `size` bytes, counting from the end if `backward`.
+static unsigned char byte_at(unsigned char const* s, size_t size, size_t i, bool backward) {
+    return backward ? s[size - 1 - i] : s[i];
+}
+
+// Two-Way string matching (Crochemore and Perrin, 1991): linear time and constant space.
+// Returns the critical position of the needle, and writes its period in `*period`.
+static size_t critical_factorization(unsigned char const* needle, size_t size, bool backward, size_t* period) {
+    size_t max_suffix[2], periods[2];
+    for (int inverse_order = 0; inverse_order < 2; ++inverse_order) {
+        // maximal suffix for the lexicographic order, then for the inverse order
+        size_t ms = (size_t)-1, j = 0, k = 1, p = 1;
+        while (j + k < size) {
+            unsigned char a = byte_at(needle, size, j + k, backward), b = byte_at(needle, size, ms + k, backward);
+            if (inverse_order ? b < a : a < b) {
+                j += k;
+                k = 1;
+                p = j - ms;
+            } else if (a == b) {
+                if (k != p) {
+                    ++k;
+                } else {
+                    j += p;
+                    k = 1;
+                }
+            } else {
+                ms = j++;
+                k = p = 1;
+            }
+        }
+        max_suffix[inverse_order] = ms + 1;
+        periods[inverse_order] = p;
     }
-    while (ch_found != str.size && str.begin[ch_found-1] == escaper) {
-        ++ch_found;
-        ch_found += jvstr_find((StrView){str.begin+ch_found,str.size-ch_found}, ch); 
+    int chosen = max_suffix[1] > max_suffix[0];
+    *period = periods[chosen];
+    return max_suffix[chosen];
+}
+
+// First location of substr in str, str.size if not found.
+// If `backward`, both strings are read from their end, so it is the last location counted from the end.
+static size_t two_way_search(StrView str, StrView substr, bool backward) {
+    unsigned char const* hay = (unsigned char const*)str.begin;
+    unsigned char const* needle = (unsigned char const*)substr.begin;
+    size_t n = str.size, m = substr.size, period;
+#define HAY(i) byte_at(hay, n, (i), backward)
+#define NEEDLE(i) byte_at(needle, m, (i), backward)
+    size_t suffix = critical_factorization(needle, m, backward, &period);
+    size_t j = 0;
+    bool is_periodic = true;
+    for (size_t i = 0; i < suffix && is_periodic; ++i)
+        is_periodic = NEEDLE(i) == NEEDLE(i + period);
+    if (is_periodic) {
+        // remembering the prefix already matched after a shift by the period
+        size_t memory = 0;
+        while (j + m <= n) {
+            size_t i = suffix > memory ? suffix : memory;
+            while (i < m && NEEDLE(i) == HAY(i + j))
+                ++i;
+            if (i < m) {
+                j += i - suffix + 1;
+                memory = 0;
+                continue;
+            }
+            i = suffix - 1;
+            while (memory < i + 1 && NEEDLE(i) == HAY(i + j))
+                --i;
+            if (i + 1 < memory + 1)
+                return j;
+            j += period;
+            memory = m - period;
+        }
+    } else {
+        period = (suffix > m - suffix ? suffix : m - suffix) + 1;
+        while (j + m <= n) {
+            size_t i = suffix;
+            while (i < m && NEEDLE(i) == HAY(i + j))
+                ++i;
+            if (i < m) {
+                j += i - suffix + 1;
+                continue;
+            }
+            i = suffix - 1;
+            while (i != (size_t)-1 && NEEDLE(i) == HAY(i + j))
+                --i;
+            if (i == (size_t)-1)
+                return j;
+            j += period;
+        }
     }
-    return ch_found;
+#undef HAY
+#undef NEEDLE
+    return n;
 }
 
-// Find last occurrence of `ch`, -1 if not found.
-size_t jvstr_rfind(StrView str, char ch) {
-    // Cannot use strrchr because not null-terminated, and memrchr does not exist.
-    while (str.size > 0) {
-        if (jvstr_extract_last(&str) == ch) {
+// Find first location of substr in str, str.size if not found.
+// Candidates are positions where both the first and last bytes of substr match, found 16 or 32 at once with SIMD,
+// and verified with memcmp. If too many candidates fail, the search continues with Two-Way to stay linear.
+size_t jvstr_search(StrView str, StrView substr) {
+    if (substr.size == 0)
+        return 0;
+    if (substr.size > str.size)
+        return str.size;
+    if (substr.size == 1)
+        return jvstr_find(str, substr.begin[0]);
+    
+    size_t m = substr.size;
+    size_t last = str.size - m; // last possible location
+    char first_char = substr.begin[0], last_char = substr.begin[m - 1];
+    size_t verified = 0; // number of bytes compared by failed verifications
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+#if defined(__AVX2__)
+    enum { BLOCK = 32 };
+    const __m256i first_block = _mm256_set1_epi8(first_char), last_block = _mm256_set1_epi8(last_char);
+#define JVSTR_CANDIDATES(p) (unsigned)_mm256_movemask_epi8(_mm256_and_si256( \
+        _mm256_cmpeq_epi8(first_block, _mm256_loadu_si256((__m256i const*)(p))), \
+        _mm256_cmpeq_epi8(last_block, _mm256_loadu_si256((__m256i const*)((p) + m - 1)))))
+#else
+    enum { BLOCK = 16 };
+    const __m128i first_block = _mm_set1_epi8(first_char), last_block = _mm_set1_epi8(last_char);
+#define JVSTR_CANDIDATES(p) (unsigned)_mm_movemask_epi8(_mm_and_si128( \
+        _mm_cmpeq_epi8(first_block, _mm_loadu_si128((__m128i const*)(p))), \
+        _mm_cmpeq_epi8(last_block, _mm_loadu_si128((__m128i const*)((p) + m - 1)))))
+#endif
+    for (; i + BLOCK - 1 <= last; i += BLOCK) {
+        for (unsigned mask = JVSTR_CANDIDATES(str.begin + i); mask != 0; mask &= mask - 1) {
+            size_t candidate = i + __builtin_ctz(mask);
+            if (memcmp(str.begin + candidate + 1, substr.begin + 1, m - 2) == 0)
+                return candidate;
+            verified += m;
+        }
+        if (verified > 2 * i + 256)
+            break;
+    }
+#undef JVSTR_CANDIDATES
+#endif
+    while (i <= last && verified <= 2 * i + 256) {
+        char const* found = (char const*)memchr(str.begin + i, first_char, last + 1 - i);
+        if (found == NULL)
             return str.size;
+        i = found - str.begin;
+        if (str.begin[i + m - 1] == last_char) {
+            if (memcmp(str.begin + i + 1, substr.begin + 1, m - 2) == 0)
+                return i;
+            verified += m;
         }
+        ++i;
     }
-    return -1;
+    if (i > last)
+        return str.size;
+    // Too much time was spent on verifications: continuing with guaranteed linear time.
+    StrView rest = { str.begin + i, str.size - i };
+    size_t found = two_way_search(rest, substr, false);
+    return found == rest.size ? str.size : i + found;
 }
 
-// Number of consecutive chars at beginning of str which are all in charset.
-size_t jvstr_while_in(StrView str, StrView charset, size_t starting_pos) {
-    char const* begin = str.begin;
-    jvstr_split(&str, starting_pos, 0);
-    while (str.size > 0) {
-        char ch = jvstr_extract_first(&str);
-        if (jvstr_find(charset, ch) == charset.size) { // if not found
-            --str.begin; // correcting last extraction
+// Find last location of substr in str, -1 if not found.
+// Same strategy as jvstr_search, scanning blocks from the end.
+size_t jvstr_rsearch(StrView str, StrView substr) {
+    if (substr.size == 0)
+        return str.size;
+    if (substr.size > str.size)
+        return -1;
+    if (substr.size == 1)
+        return jvstr_rfind(str, substr.begin[0]);
+    
+    size_t m = substr.size;
+    size_t end = str.size - m + 1; // locations before `end` remain to be checked
+    size_t nb_locations = end;
+    char first_char = substr.begin[0], last_char = substr.begin[m - 1];
+    size_t verified = 0; // number of bytes compared by failed verifications
+#if defined(__AVX2__) || defined(__SSE2__)
+#if defined(__AVX2__)
+    enum { BLOCK = 32 };
+    const __m256i first_block = _mm256_set1_epi8(first_char), last_block = _mm256_set1_epi8(last_char);
+#define JVSTR_CANDIDATES(p) (unsigned)_mm256_movemask_epi8(_mm256_and_si256( \
+        _mm256_cmpeq_epi8(first_block, _mm256_loadu_si256((__m256i const*)(p))), \
+        _mm256_cmpeq_epi8(last_block, _mm256_loadu_si256((__m256i const*)((p) + m - 1)))))
+#else
+    enum { BLOCK = 16 };
+    const __m128i first_block = _mm_set1_epi8(first_char), last_block = _mm_set1_epi8(last_char);
+#define JVSTR_CANDIDATES(p) (unsigned)_mm_movemask_epi8(_mm_and_si128( \
+        _mm_cmpeq_epi8(first_block, _mm_loadu_si128((__m128i const*)(p))), \
+        _mm_cmpeq_epi8(last_block, _mm_loadu_si128((__m128i const*)((p) + m - 1)))))
+#endif
+    for (; end >= BLOCK && verified <= 2 * (nb_locations - end) + 256; end -= BLOCK) {
+        size_t start = end - BLOCK;
+        for (unsigned mask = JVSTR_CANDIDATES(str.begin + start); mask != 0;) {
+            unsigned highest = 31 - __builtin_clz(mask);
+            if (memcmp(str.begin + start + highest + 1, substr.begin + 1, m - 2) == 0)
+                return start + highest;
+            verified += m;
+            mask ^= 1u << highest;
+        }
+    }
+#undef JVSTR_CANDIDATES
+#endif
+    while (end > 0 && verified <= 2 * (nb_locations - end) + 256) {
+        --end;
+        if (str.begin[end] == first_char && str.begin[end + m - 1] == last_char) {
+            if (memcmp(str.begin + end + 1, substr.begin + 1, m - 2) == 0)
+                return end;
+            verified += m;
+        }
+    }
+    if (end == 0)
+        return -1;
+    // Too much time was spent on verifications: continuing with guaranteed linear time.
+    StrView rest = { str.begin, end - 1 + m };
+    size_t found = two_way_search(rest, substr, true);
+    return found == rest.size ? (size_t)-1 : rest.size - found - m;
+}
+
+// Little-endian reads, so that hashes are the same on all platforms.
+static uint64_t read_le64(unsigned char const* p) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+#else
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24
+         | (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 | (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+#endif
+}
+
+static uint64_t read_le32(unsigned char const* p) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+#else
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 | (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24;
+#endif
+}
+
+// ASCII lowercase of the 8 bytes of x at once.
+static uint64_t fold_case64(uint64_t x) {
+    const uint64_t ones = 0x0101010101010101u, high_bits = 0x8080808080808080u;
+    uint64_t low7 = x & ~high_bits;
+    uint64_t from_A = low7 + (0x80 - 'A') * ones;     // high bit set if low7 >= 'A'
+    uint64_t after_Z = low7 + (0x80 - 'Z' - 1) * ones; // high bit set if low7 > 'Z'
+    uint64_t is_upper = from_A & ~after_Z & ~x & high_bits;
+    return x | (is_upper >> 2);
+}
+
+// Reads for the hash, case-folded if `icase`.
+static uint64_t hash_read64(unsigned char const* p, bool icase) {
+    return icase ? fold_case64(read_le64(p)) : read_le64(p);
+}
+
+static uint64_t hash_read32(unsigned char const* p, bool icase) {
+    return icase ? fold_case64(read_le32(p)) : read_le32(p);
+}
+
+static uint64_t hash_read8(unsigned char const* p, bool icase) {
+    return icase ? fold_case(*p) : *p;
+}
+
+// 128-bit product of *a and *b: low half written in *a, high half in *b.
+static void hash_multiply(uint64_t* a, uint64_t* b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), carry = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    carry += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+// 128-bit product of a and b, folded by XOR of its halves.
+static uint64_t hash_mix(uint64_t a, uint64_t b) {
+    hash_multiply(&a, &b);
+    return a ^ b;
+}
+
+// Seeded 64-bit hash of the bytes of str (wyhash algorithm), as if ASCII letters were lowercase if `icase`.
+static uint64_t hash_bytes(StrView str, uint64_t seed, bool icase) {
+    static const uint64_t secret[4] = {
+        0x2d358dccaa6c78a5u, 0x8bb84b93962eacc9u, 0x4b33a62ed433d4a3u, 0x4d5a2da51de1aa47u
+    };
+    unsigned char const* p = (unsigned char const*)str.begin;
+    size_t len = str.size;
+    uint64_t a, b;
+    seed ^= hash_mix(seed ^ secret[0], secret[1]);
+    if (len <= 16) {
+        // short keys: a few overlapping reads, without loop
+        if (len >= 4) {
+            size_t shift = (len >> 3) << 2;
+            a = (hash_read32(p, icase) << 32) | hash_read32(p + shift, icase);
+            b = (hash_read32(p + len - 4, icase) << 32) | hash_read32(p + len - 4 - shift, icase);
+        } else if (len > 0) {
+            a = (hash_read8(p, icase) << 16) | (hash_read8(p + (len >> 1), icase) << 8) | hash_read8(p + len - 1, icase);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = hash_mix(hash_read64(p, icase) ^ secret[1], hash_read64(p + 8, icase) ^ seed);
+                see1 = hash_mix(hash_read64(p + 16, icase) ^ secret[2], hash_read64(p + 24, icase) ^ see1);
+                see2 = hash_mix(hash_read64(p + 32, icase) ^ secret[3], hash_read64(p + 40, icase) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = hash_mix(hash_read64(p, icase) ^ secret[1], hash_read64(p + 8, icase) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = hash_read64(p + i - 16, icase);
+        b = hash_read64(p + i - 8, icase);
+    }
+    a ^= secret[1];
+    b ^= seed;
+    hash_multiply(&a, &b);
+    return hash_mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+// Seeded 64-bit hash of the bytes of str (wyhash algorithm).
+uint64_t jvstr_hash(StrView str, uint64_t seed) {
+    return hash_bytes(str, seed, false);
+}
+
+// Seeded 64-bit hash ignoring ASCII case, i.e. equal to jvstr_hash of the lowercase string.
+uint64_t jvstr_hash_icase(StrView str, uint64_t seed) {
+    return hash_bytes(str, seed, true);
+}
+
+// Start an iteration over the non-overlapping occurrences of substr in str.
+jvSearchIter jvstr_search_all(StrView str, StrView substr) {
+    jvSearchIter iter = { str, substr, 0 };
+    return iter;
+}
+
+// Write the location of the next occurrence in `*found`, return false if there is none.
+bool jvstr_search_next(jvSearchIter* iter, size_t* found) {
+    if (iter->pos > iter->str.size)
+        return false;
+    StrView rest = { iter->str.begin + iter->pos, iter->str.size - iter->pos };
+    size_t location = jvstr_search(rest, iter->substr);
+    if (location == rest.size && iter->substr.size > 0) {
+        iter->pos = iter->str.size + 1;
+        return false;
+    }
+    *found = iter->pos + location;
+    // An empty substr is found at each location, including str.size
+    iter->pos = *found + (iter->substr.size > 0 ? iter->substr.size : 1);
+    return true;
+}
+
+// Start an iteration over the tokens of str separated by `delimiter`.
+jvSplitIter jvstr_split_all(StrView str, char delimiter, bool skip_empty) {
+    jvSplitIter iter = jvstr_split_all_any(str, (StrView){ &delimiter, 1 }, skip_empty);
+    return iter;
+}
+
+// Start an iteration over the tokens of str separated by any char of `delimiters`.
+jvSplitIter jvstr_split_all_any(StrView str, StrView delimiters, bool skip_empty) {
+    jvSplitIter iter;
+    iter.str = str;
+    iter.delimiters = jvstr_charset_make(delimiters);
+    iter.pos = 0;
+    iter.block_pos = 0;
+    iter.mask = 0;
+    iter.is_single = delimiters.size == 1;
+    iter.delimiter = iter.is_single ? delimiters.begin[0] : '\0';
+    iter.skip_empty = skip_empty;
+    return iter;
+}
+
+// Mask of the delimiters in a block of 64 bytes.
+static uint64_t delimiter_mask64(jvSplitIter const* iter, unsigned char const* block) {
+    uint64_t mask = 0;
+#if defined(__SSE2__)
+    if (iter->is_single) {
+        const __m128i target = _mm_set1_epi8(iter->delimiter);
+        for (int i = 0; i < 64; i += 16)
+            mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(target, _mm_loadu_si128((__m128i const*)(block + i)))) << i;
+        return mask;
+    }
+#endif
+#if defined(__AVX2__)
+    __m256i table_low = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const*)iter->delimiters.nibbles[0]));
+    __m256i table_high = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const*)iter->delimiters.nibbles[1]));
+    for (int i = 0; i < 64; i += 32)
+        mask |= (uint64_t)charset_mask32(_mm256_loadu_si256((__m256i const*)(block + i)), table_low, table_high) << i;
+#elif defined(__SSSE3__)
+    __m128i table_low = _mm_loadu_si128((__m128i const*)iter->delimiters.nibbles[0]);
+    __m128i table_high = _mm_loadu_si128((__m128i const*)iter->delimiters.nibbles[1]);
+    for (int i = 0; i < 64; i += 16)
+        mask |= (uint64_t)charset_mask16(_mm_loadu_si128((__m128i const*)(block + i)), table_low, table_high) << i;
+#else
+    unsigned char const* bitmap = iter->delimiters.bitmap;
+    for (int i = 0; i < 64; ++i)
+        mask |= (uint64_t)((bitmap[block[i] >> 3] >> (block[i] & 7)) & 1) << i;
+#endif
+    return mask;
+}
+
+// Index of the lowest bit set in a non-zero mask.
+static unsigned lowest_bit64(uint64_t mask) {
+#if defined(__GNUC__)
+    return (unsigned)__builtin_ctzll(mask);
+#else
+    unsigned i = 0;
+    while (((mask >> i) & 1) == 0)
+        ++i;
+    return i;
+#endif
+}
+
+// Write the next token in `*token`, return false if there is none.
+bool jvstr_split_next(jvSplitIter* iter, StrView* token) {
+    size_t size = iter->str.size;
+    while (iter->pos <= size) {
+        while (iter->mask == 0) {
+            if (iter->block_pos >= size) {
+                // last token, up to the end of str
+                *token = (StrView){ iter->str.begin + iter->pos, size - iter->pos };
+                iter->pos = size + 1;
+                return !(iter->skip_empty && token->size == 0);
+            }
+            unsigned char const* block = (unsigned char const*)iter->str.begin + iter->block_pos;
+            if (size - iter->block_pos >= 64) {
+                iter->mask = delimiter_mask64(iter, block);
+            } else {
+                // last partial block, copied so that the loads stay within bounds
+                unsigned char tail[64] = {0};
+                size_t rest = size - iter->block_pos;
+                memcpy(tail, block, rest);
+                iter->mask = delimiter_mask64(iter, tail) & (((uint64_t)1 << rest) - 1);
+            }
+            iter->block_pos += 64;
+        }
+        size_t delimiter_pos = iter->block_pos - 64 + lowest_bit64(iter->mask);
+        iter->mask &= iter->mask - 1;
+        *token = (StrView){ iter->str.begin + iter->pos, delimiter_pos - iter->pos };
+        iter->pos = delimiter_pos + 1;
+        if (!(iter->skip_empty && token->size == 0))
+            return true;
+    }
+    return false;
+}
+
+// Write up to `capacity` next tokens in `tokens`, return how many were written.
+size_t jvstr_split_batch(jvSplitIter* iter, StrView* tokens, size_t capacity) {
+    size_t count = 0;
+    while (count < capacity && jvstr_split_next(iter, &tokens[count]))
+        ++count;
+    return count;
+}
+
+
+// Number of bytes of the valid UTF-8 sequence starting at the beginning of str, 0 if invalid.
+static size_t utf8_sequence_size(unsigned char const* s, size_t size) {
+    unsigned char c = s[0];
+    if (c < 0x80)
+        return 1;
+    size_t seq_size;
+    unsigned char min2 = 0x80, max2 = 0xBF; // allowed range for the second byte
+    if (c >= 0xC2 && c <= 0xDF) {
+        seq_size = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        seq_size = 3;
+        if (c == 0xE0) min2 = 0xA0; // overlong
+        if (c == 0xED) max2 = 0x9F; // surrogates
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        seq_size = 4;
+        if (c == 0xF0) min2 = 0x90; // overlong
+        if (c == 0xF4) max2 = 0x8F; // above U+10FFFF
+    } else {
+        return 0;
+    }
+    if (size < seq_size || s[1] < min2 || s[1] > max2)
+        return 0;
+    for (size_t i = 2; i < seq_size; ++i)
+        if ((s[i] & 0xC0) != 0x80)
+            return 0;
+    return seq_size;
+}
+
+// Index of the first byte >= 0x80 starting from i, or size if there is none.
+static size_t skip_ascii(unsigned char const* s, size_t i, size_t size) {
+#if defined(__SSE2__)
+    while (i + 16 <= size) {
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_loadu_si128((__m128i const*)(s + i)));
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+        i += 16;
+    }
+    if (i < size && size >= 16) { // remaining bytes with a last block overlapping already checked bytes
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_loadu_si128((__m128i const*)(s + size - 16)));
+        mask &= ~0u << (i - (size - 16)); // ignoring bytes before i
+        return mask == 0 ? size : size - 16 + __builtin_ctz(mask);
+    }
+#endif
+    while (i + 8 <= size) {
+        uint64_t word;
+        memcpy(&word, s + i, 8);
+        if ((word & 0x8080808080808080u) != 0)
             break;
+        i += 8;
+    }
+    while (i < size && s[i] < 0x80)
+        ++i;
+    return i;
+}
+
+static size_t find_invalid_utf8_scalar(StrView str) {
+    unsigned char const* s = (unsigned char const*)str.begin;
+    size_t i = skip_ascii(s, 0, str.size);
+    while (i < str.size) {
+        size_t seq_size = utf8_sequence_size(s + i, str.size - i);
+        if (seq_size == 0)
+            return i;
+        i += seq_size;
+        if (i < str.size && s[i] < 0x80) // back to ASCII
+            i = skip_ascii(s, i, str.size);
+    }
+    return str.size;
+}
+
+#if defined(__SSSE3__)
+// Errors of a block of 16 bytes, given the previous block, with the lookup algorithm of
+// Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte" (2021).
+// Each table sets bits for the errors which are possible given the high/low nibble of a byte,
+// an error is present when the three tables agree.
+static __m128i utf8_block_errors(__m128i input, __m128i prev_input) {
+    enum {
+        TOO_SHORT = 1 << 0, TOO_LONG = 1 << 1, OVERLONG_3 = 1 << 2, TOO_LARGE = 1 << 3,
+        SURROGATE = 1 << 4, OVERLONG_2 = 1 << 5, TOO_LARGE_1000 = 1 << 6, OVERLONG_4 = 1 << 6,
+        TWO_CONTS = 1 << 7, CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS,
+    };
+    const __m128i byte_1_high_table = _mm_setr_epi8(
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2, TOO_SHORT, TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+    const __m128i byte_1_low_table = _mm_setr_epi8(
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, CARRY | OVERLONG_2, CARRY, CARRY,
+        CARRY | TOO_LARGE, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE, CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000);
+    const __m128i byte_2_high_table = _mm_setr_epi8(
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+    const __m128i low_nibble = _mm_set1_epi8(0x0F);
+    
+    __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+    __m128i byte_1_high = _mm_shuffle_epi8(byte_1_high_table, _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble));
+    __m128i byte_1_low = _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, low_nibble));
+    __m128i byte_2_high = _mm_shuffle_epi8(byte_2_high_table, _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+    __m128i special_cases = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+    
+    // Third and fourth bytes of 3 and 4-byte sequences must be continuations (TWO_CONTS is expected there).
+    __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+    __m128i is_third_byte = _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80)));
+    __m128i is_fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80)));
+    __m128i must_be_continuation = _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte), _mm_set1_epi8((char)0x80));
+    return _mm_xor_si128(must_be_continuation, special_cases);
+}
+#endif
+
+// Find first byte which does not belong to a valid UTF-8 sequence, str.size if str is valid UTF-8.
+size_t jvstr_find_invalid_utf8(StrView str) {
+#if defined(__SSSE3__)
+    // Blocks are checked with SIMD, the exact error location is then found with the scalar version.
+    // Bytes of prev_incomplete are non-zero if the previous block ends with a sequence needing more bytes.
+    const __m128i incomplete_threshold = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                       (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+    __m128i prev_input = _mm_setzero_si128(), prev_incomplete = _mm_setzero_si128(), error = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i < str.size; i += 16) {
+        __m128i input;
+        if (i + 16 <= str.size) {
+            input = _mm_loadu_si128((__m128i const*)(str.begin + i));
+        } else { // last block padded with zeros, which detects an incomplete last sequence
+            char padded[16] = {0};
+            memcpy(padded, str.begin + i, str.size - i);
+            input = _mm_loadu_si128((__m128i const*)padded);
         }
+        if (_mm_movemask_epi8(input) == 0)
+            error = _mm_or_si128(error, prev_incomplete);
+        else
+            error = _mm_or_si128(error, utf8_block_errors(input, prev_input));
+        prev_incomplete = _mm_subs_epu8(input, incomplete_threshold);
+        prev_input = input;
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF)
+            return find_invalid_utf8_scalar(str);
     }
-    return str.begin - begin;
+    if (str.size % 16 == 0 && _mm_movemask_epi8(_mm_cmpeq_epi8(prev_incomplete, _mm_setzero_si128())) != 0xFFFF)
+        return find_invalid_utf8_scalar(str);
+    return str.size;
+#else
+    return find_invalid_utf8_scalar(str);
+#endif
 }
 
-// Number of consecutive chars at beginning of str which are all NOT in charset.
-size_t jvstr_until_in(StrView str, StrView charset, size_t starting_pos) {
-    char const* begin = str.begin;
-    jvstr_split(&str, starting_pos, 0);
-    while (str.size > 0) {
-        char ch = jvstr_extract_first(&str);
-        if (jvstr_find(charset, ch) != charset.size) { // if found
-            --str.begin; // correcting last extraction
+
+// Number of code points in str, i.e. number of bytes which are not UTF-8 continuation bytes.
+size_t jvstr_utf8_count(StrView str) {
+    size_t count = 0, i = 0;
+    // continuation bytes 0x80..0xBF are the signed bytes below -64
+#if defined(__AVX2__)
+    for (; i + 32 <= str.size; i += 32) {
+        __m256i x = _mm256_loadu_si256((__m256i const*)(str.begin + i));
+        count += __builtin_popcount((unsigned)_mm256_movemask_epi8(_mm256_cmpgt_epi8(x, _mm256_set1_epi8(-65))));
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= str.size; i += 16) {
+        __m128i x = _mm_loadu_si128((__m128i const*)(str.begin + i));
+        count += __builtin_popcount((unsigned)_mm_movemask_epi8(_mm_cmpgt_epi8(x, _mm_set1_epi8(-65))));
+    }
+#endif
+    for (; i < str.size; ++i)
+        count += ((unsigned char)str.begin[i] & 0xC0) != 0x80;
+    return count;
+}
+
+// Ranges of code points, each packed as (first << 11) | (last - first), sorted by first.
+// Generated from the Unicode 14.0 database: zero width are the categories Mn, Me and Cf,
+// Hangul medial vowels and final consonants, and U+200B; wide are East Asian Wide and Fullwidth,
+// plus the unassigned code points of the CJK blocks. Planes 2 and 3 are handled separately.
+static const uint32_t zero_width_ranges[316] = {
+    0x00056800, 0x0018006F, 0x00241806, 0x002C882C, 0x002DF800, 0x002E0801, 0x002E2001, 0x002E3800,
+    0x00300005, 0x0030800A, 0x0030E000, 0x00325814, 0x00338000, 0x0036B007, 0x0036F805, 0x00373801,
+    0x00375003, 0x00387800, 0x00388800, 0x0039801A, 0x003D300A, 0x003F5808, 0x003FE800, 0x0040B003,
+    0x0040D808, 0x00412802, 0x00414804, 0x0042C802, 0x0044800F, 0x00465038, 0x0049D000, 0x0049E000,
+    0x004A0807, 0x004A6800, 0x004A8806, 0x004B1001, 0x004C0800, 0x004DE000, 0x004E0803, 0x004E6800,
+    0x004F1001, 0x004FF004, 0x0051E000, 0x00520810, 0x00538001, 0x0053A800, 0x00540801, 0x0055E000,
+    0x00560807, 0x00566800, 0x00571001, 0x0057D007, 0x0059E000, 0x0059F800, 0x005A0803, 0x005A6809,
+    0x005B1001, 0x005C1000, 0x005E0000, 0x005E6800, 0x00600000, 0x00602000, 0x0061E000, 0x0061F002,
+    0x00623010, 0x00631001, 0x00640800, 0x0065E000, 0x0065F800, 0x00663000, 0x00666001, 0x00671001,
+    0x00680001, 0x0069D801, 0x006A0803, 0x006A6800, 0x006B1001, 0x006C0800, 0x006E5000, 0x006E9004,
+    0x00718800, 0x0071A006, 0x00723807, 0x00758800, 0x0075A008, 0x00764005, 0x0078C001, 0x0079A800,
+    0x0079B800, 0x0079C800, 0x007B880D, 0x007C0004, 0x007C3001, 0x007C682F, 0x007E3000, 0x00816803,
+    0x00819005, 0x0081C801, 0x0081E801, 0x0082C001, 0x0082F002, 0x00838803, 0x00841000, 0x00842801,
+    0x00846800, 0x0084E800, 0x008B009F, 0x009AE802, 0x00B89002, 0x00B99001, 0x00BA9001, 0x00BB9001,
+    0x00BDA001, 0x00BDB806, 0x00BE3000, 0x00BE480A, 0x00BEE800, 0x00C05804, 0x00C42801, 0x00C54800,
+    0x00C90002, 0x00C93801, 0x00C99000, 0x00C9C802, 0x00D0B801, 0x00D0D800, 0x00D2B000, 0x00D2C008,
+    0x00D31000, 0x00D32807, 0x00D3980C, 0x00D58053, 0x00D9A000, 0x00D9B004, 0x00D9E000, 0x00DA1000,
+    0x00DB5808, 0x00DC0001, 0x00DD1003, 0x00DD4001, 0x00DD5802, 0x00DF3000, 0x00DF4001, 0x00DF6800,
+    0x00DF7802, 0x00E16007, 0x00E1B001, 0x00E68002, 0x00E6A00C, 0x00E71006, 0x00E76800, 0x00E7A000,
+    0x00E7C001, 0x00EE003F, 0x01005804, 0x01015004, 0x0103000F, 0x01068020, 0x01677802, 0x016BF800,
+    0x016F001F, 0x01815003, 0x0184C801, 0x05337803, 0x0533A009, 0x0534F001, 0x05378001, 0x05401000,
+    0x05403000, 0x05405800, 0x05412801, 0x05416000, 0x05462001, 0x05470011, 0x0547F800, 0x05493007,
+    0x054A380A, 0x054C0002, 0x054D9800, 0x054DB003, 0x054DE001, 0x054F2800, 0x05514805, 0x05518801,
+    0x0551A801, 0x05521800, 0x05526000, 0x0553E000, 0x05558000, 0x05559002, 0x0555B801, 0x0555F001,
+    0x05560800, 0x05576001, 0x0557B000, 0x055F2800, 0x055F4000, 0x055F6800, 0x07D8F000, 0x07F0000F,
+    0x07F1000F, 0x07F7F800, 0x07FFC802, 0x080FE800, 0x08170000, 0x081BB004, 0x0850080E, 0x0851C007,
+    0x08572801, 0x08692003, 0x08755801, 0x087A300A, 0x087C1003, 0x08800800, 0x0881C00E, 0x08838000,
+    0x08839801, 0x0883F802, 0x08859803, 0x0885C801, 0x0885E800, 0x0886100B, 0x08880002, 0x08893804,
+    0x08896807, 0x088B9800, 0x088C0001, 0x088DB008, 0x088E4803, 0x088E7800, 0x08917802, 0x0891A000,
+    0x0891B001, 0x0891F000, 0x0896F800, 0x08971807, 0x08980001, 0x0899D801, 0x089A0000, 0x089B300E,
+    0x08A1C007, 0x08A21002, 0x08A23000, 0x08A2F000, 0x08A59805, 0x08A5D000, 0x08A5F801, 0x08A61001,
+    0x08AD9003, 0x08ADE001, 0x08ADF801, 0x08AEE001, 0x08B19807, 0x08B1E800, 0x08B1F801, 0x08B55800,
+    0x08B56800, 0x08B58005, 0x08B5B800, 0x08B8E802, 0x08B91003, 0x08B93804, 0x08C17808, 0x08C1C801,
+    0x08C9D801, 0x08C9F000, 0x08CA1800, 0x08CEA007, 0x08CF0000, 0x08D00809, 0x08D19805, 0x08D1D803,
+    0x08D23800, 0x08D28805, 0x08D2C802, 0x08D4500C, 0x08D4C001, 0x08E1800D, 0x08E1F800, 0x08E49015,
+    0x08E55006, 0x08E59001, 0x08E5A801, 0x08E98814, 0x08EA3800, 0x08EC8001, 0x08ECA800, 0x08ECB800,
+    0x08F79801, 0x09A18008, 0x0B578004, 0x0B598006, 0x0B7A7800, 0x0B7C7803, 0x0B7F2000, 0x0DE4E801,
+    0x0DE50003, 0x0E780046, 0x0E8B3802, 0x0E8B980F, 0x0E8C2806, 0x0E8D5003, 0x0E921002, 0x0ED00036,
+    0x0ED1D831, 0x0ED3A800, 0x0ED42000, 0x0ED4D814, 0x0F00002A, 0x0F098006, 0x0F157000, 0x0F176003,
+    0x0F468006, 0x0F4A2006, 0x7000087E, 0x700800EF,
+};
+static const uint32_t wide_ranges[103] = {
+    0x0088005F, 0x0118D001, 0x01194801, 0x011F4803, 0x011F8000, 0x011F9800, 0x012FE801, 0x0130A001,
+    0x0132400B, 0x0133F800, 0x01349800, 0x01350800, 0x01355001, 0x0135E801, 0x01362001, 0x01367000,
+    0x0136A000, 0x01375000, 0x01379001, 0x0137A800, 0x0137D000, 0x0137E800, 0x01382800, 0x01385001,
+    0x01394000, 0x013A6000, 0x013A7000, 0x013A9802, 0x013AB800, 0x013CA802, 0x013D8000, 0x013DF800,
+    0x0158D801, 0x015A8000, 0x015AA800, 0x017401BE, 0x01820A06, 0x019287FF, 0x01D287FF, 0x021287FF,
+    0x0252836F, 0x027007FF, 0x02B007FF, 0x02F007FF, 0x033007FF, 0x037007FF, 0x03B007FF, 0x03F007FF,
+    0x043007FF, 0x047007FF, 0x04B007FF, 0x04F006C6, 0x054B001C, 0x056007FF, 0x05A007FF, 0x05E007FF,
+    0x062007FF, 0x066007FF, 0x06A003A3, 0x07C801FF, 0x07F08009, 0x07F1803B, 0x07F8085F, 0x07FF0006,
+    0x0B7F07FF, 0x0BBF07FF, 0x0BFF07FF, 0x0C3F0528, 0x0D7F830B, 0x0F802000, 0x0F867800, 0x0F8C7000,
+    0x0F8C8809, 0x0F900065, 0x0F980020, 0x0F996808, 0x0F99B845, 0x0F9BF015, 0x0F9D002A, 0x0F9E7804,
+    0x0F9F0010, 0x0F9FA000, 0x0F9FC046, 0x0FA20000, 0x0FA210BA, 0x0FA7F83E, 0x0FAA5803, 0x0FAA8017,
+    0x0FABD000, 0x0FACA801, 0x0FAD2000, 0x0FAFD854, 0x0FB40045, 0x0FB66000, 0x0FB68002, 0x0FB6A80A,
+    0x0FB75801, 0x0FB7A008, 0x0FBF0010, 0x0FC8602E, 0x0FC9E009, 0x0FCA38B8, 0x0FD38086,
+};
+
+static bool in_packed_ranges(uint32_t const* ranges, size_t nb_ranges, uint32_t cp) {
+    // last range whose first code point is at most cp
+    size_t low = 0, high = nb_ranges;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if ((ranges[middle] >> 11) <= cp)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low > 0 && cp - (ranges[low - 1] >> 11) <= (ranges[low - 1] & 0x7FF);
+}
+
+// Number of terminal columns used by a code point.
+static size_t code_point_width(uint32_t cp) {
+    if (cp < 0x20 || (cp >= 0x7F && cp < 0xA0))
+        return 0; // control characters
+    if (cp < 0x300)
+        return 1;
+    if (in_packed_ranges(zero_width_ranges, sizeof(zero_width_ranges) / sizeof(uint32_t), cp))
+        return 0;
+    if ((cp >= 0x20000 && cp <= 0x3FFFD) || in_packed_ranges(wide_ranges, sizeof(wide_ranges) / sizeof(uint32_t), cp))
+        return 2;
+    return 1;
+}
+
+// Number of terminal columns used to display str.
+size_t jvstr_display_width(StrView str) {
+    unsigned char const* s = (unsigned char const*)str.begin;
+    size_t width = 0, i = 0;
+    while (i < str.size) {
+#if defined(__SSE2__)
+        // runs of ASCII, 16 bytes at once: one column per byte, except control characters
+        for (; i + 16 <= str.size; i += 16) {
+            __m128i x = _mm_loadu_si128((__m128i const*)(s + i));
+            if (_mm_movemask_epi8(x) != 0)
+                break;
+            __m128i controls = _mm_or_si128(_mm_cmplt_epi8(x, _mm_set1_epi8(0x20)), _mm_cmpeq_epi8(x, _mm_set1_epi8(0x7F)));
+            width += 16 - __builtin_popcount((unsigned)_mm_movemask_epi8(controls));
+        }
+        if (i == str.size)
             break;
+#endif
+        unsigned char c = s[i];
+        if (c < 0x80) {
+            width += c >= 0x20 && c != 0x7F;
+            i += 1;
+            continue;
         }
+        size_t seq_size = utf8_sequence_size(s + i, str.size - i);
+        if (seq_size == 0) { // invalid byte, displayed as a replacement character
+            width += 1;
+            i += 1;
+            continue;
+        }
+        uint32_t cp = c & (0x7F >> seq_size);
+        for (size_t k = 1; k < seq_size; ++k)
+            cp = (cp << 6) | (s[i + k] & 0x3F);
+        width += code_point_width(cp);
+        i += seq_size;
     }
-    return str.begin - begin;
+    return width;
 }
 
-// Find first location of substr in str, str.size if not found.
-size_t jvstr_search(StrView str, StrView substr) {
-    if (substr.size == 0) {
-        return 0;    
+/* Sorting.
+   jvstr_sort is a multikey quicksort (Bentley and Sedgewick) which compares 8 bytes at a time:
+   each string is paired with its 8 bytes from the current depth, packed big-endian in an integer,
+   so partitioning compares integers and only reads the strings when going one level deeper. */
+typedef struct SortItem {
+    uint64_t key;
+    StrView str;
+} SortItem;
+
+enum { SORT_INSERTION_THRESHOLD = 16 };
+
+// The 8 bytes of str from `depth`, big-endian so that integer order is byte order, completed with zeros.
+static uint64_t sort_key(StrView str, size_t depth) {
+    unsigned char const* p = (unsigned char const*)str.begin + depth;
+    size_t remaining = str.size - depth;
+    if (remaining >= 8) {
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        uint64_t v;
+        memcpy(&v, p, 8);
+        return __builtin_bswap64(v);
+#elif defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        uint64_t v;
+        memcpy(&v, p, 8);
+        return v;
+#endif
     }
-    StrView original_str = str;
-    char substr_first_char = jvstr_extract_first(&substr);
-    while (true) {
-        (void)jvstr_split(&str, jvstr_find(str, substr_first_char), 0);
-        if (str.size == 0) {
-            return original_str.size;
+    uint64_t key = 0;
+    for (size_t i = 0; i < 8; ++i)
+        key = key << 8 | (i < remaining ? p[i] : 0);
+    return key;
+}
+
+static void swap_items(SortItem* a, SortItem* b) {
+    SortItem tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+// Compare two strings whose first `depth` bytes are equal, and whose keys are at `depth`.
+static int compare_items(SortItem const* a, SortItem const* b, size_t depth) {
+    if (a->key != b->key)
+        return a->key < b->key ? -1 : 1;
+    if (a->str.size <= depth + 8 || b->str.size <= depth + 8)
+        return a->str.size < b->str.size ? -1 : a->str.size > b->str.size;
+    StrView rest_a = { a->str.begin + depth + 8, a->str.size - depth - 8 };
+    StrView rest_b = { b->str.begin + depth + 8, b->str.size - depth - 8 };
+    return jvstr_compare(rest_a, rest_b);
+}
+
+static void multikey_quicksort(SortItem* items, size_t count, size_t depth) {
+    while (count > 1) {
+        if (count < SORT_INSERTION_THRESHOLD) {
+            for (size_t i = 1; i < count; ++i)
+                for (size_t j = i; j > 0 && compare_items(&items[j - 1], &items[j], depth) > 0; --j)
+                    swap_items(&items[j - 1], &items[j]);
+            return;
         }
-        (void)jvstr_extract_first(&str);
-        if (jvstr_starts_with(str, substr, 0)) {
-            // Found, decrementing to get back first char
-            return (str.begin-1) - original_str.begin;
+        // Median of three as pivot.
+        uint64_t a = items[0].key, b = items[count / 2].key, c = items[count - 1].key;
+        uint64_t pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+        // Three-way partition: [0, lt) < pivot, [lt, i) == pivot, [gt, count) > pivot.
+        size_t lt = 0, i = 0, gt = count;
+        while (i < gt) {
+            if (items[i].key < pivot)
+                swap_items(&items[lt++], &items[i++]);
+            else if (items[i].key > pivot)
+                swap_items(&items[i], &items[--gt]);
+            else
+                ++i;
+        }
+        // The strings equal to the pivot share their first depth + 8 bytes.
+        // Those which end there come first, shortest first, as they are prefixes of the others.
+        SortItem* equal = items + lt;
+        size_t nb_equal = gt - lt;
+        size_t nb_ended = 0;
+        for (size_t k = 0; k < nb_equal; ++k)
+            if (equal[k].str.size <= depth + 8)
+                swap_items(&equal[nb_ended++], &equal[k]);
+        for (size_t remaining = 0, sorted = 0; remaining < 8 && sorted < nb_ended; ++remaining)
+            for (size_t k = sorted; k < nb_ended; ++k)
+                if (equal[k].str.size - depth == remaining)
+                    swap_items(&equal[sorted++], &equal[k]);
+        equal += nb_ended;
+        nb_equal -= nb_ended;
+        for (size_t k = 0; k < nb_equal; ++k)
+            equal[k].key = sort_key(equal[k].str, depth + 8);
+
+        // Recursing on the two smaller parts bounds the stack depth, the largest one is sorted by the loop.
+        SortItem* greater = items + gt;
+        size_t nb_greater = count - gt;
+        if (nb_equal >= lt && nb_equal >= nb_greater) {
+            multikey_quicksort(items, lt, depth);
+            multikey_quicksort(greater, nb_greater, depth);
+            items = equal;
+            count = nb_equal;
+            depth += 8;
+        } else if (lt >= nb_greater) {
+            multikey_quicksort(greater, nb_greater, depth);
+            multikey_quicksort(equal, nb_equal, depth + 8);
+            count = lt;
+        } else {
+            multikey_quicksort(items, lt, depth);
+            multikey_quicksort(equal, nb_equal, depth + 8);
+            items = greater;
+            count = nb_greater;
+        }
+    }
+}
+
+bool jvstr_sort(StrView* strings, size_t count) {
+    if (count < 2)
+        return true;
+    SortItem* items = (SortItem*)malloc(count * sizeof(SortItem));
+    if (items == NULL)
+        return false;
+    for (size_t i = 0; i < count; ++i) {
+        items[i].key = sort_key(strings[i], 0);
+        items[i].str = strings[i];
+    }
+    multikey_quicksort(items, count, 0);
+    for (size_t i = 0; i < count; ++i)
+        strings[i] = items[i].str;
+    free(items);
+    return true;
+}
+
+void jvstr_sort_partition(StrView* strings, size_t count, size_t bounds[258]) {
+    // In-place counting sort on the first byte, empty strings being group 0.
+    size_t next[257] = { 0 };
+    for (size_t i = 0; i < count; ++i)
+        next[strings[i].size == 0 ? 0 : (unsigned char)strings[i].begin[0] + 1] += 1;
+    size_t total = 0;
+    for (int group = 0; group < 257; ++group) {
+        bounds[group] = total;
+        total += next[group];
+        next[group] = bounds[group];
+    }
+    bounds[257] = count;
+    for (int group = 0; group < 257; ++group) {
+        size_t end = bounds[group + 1];
+        // Every misplaced string is swapped to the next free place of its group.
+        while (next[group] < end) {
+            StrView str = strings[next[group]];
+            int target = str.size == 0 ? 0 : (unsigned char)str.begin[0] + 1;
+            if (target == group) {
+                next[group] += 1;
+            } else {
+                strings[next[group]] = strings[next[target]];
+                strings[next[target]++] = str;
+            }
         }
     }
 }
 
+static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
 
+int jvstr_compare_natural(StrView a, StrView b) {
+    size_t i = 0, j = 0;
+    while (i < a.size && j < b.size) {
+        if (is_digit(a.begin[i]) && is_digit(b.begin[j])) {
+            // Numbers without their leading zeros compare by length, then digit by digit.
+            while (i < a.size && a.begin[i] == '0')
+                ++i;
+            while (j < b.size && b.begin[j] == '0')
+                ++j;
+            size_t end_a = i, end_b = j;
+            while (end_a < a.size && is_digit(a.begin[end_a]))
+                ++end_a;
+            while (end_b < b.size && is_digit(b.begin[end_b]))
+                ++end_b;
+            if (end_a - i != end_b - j)
+                return end_a - i < end_b - j ? -1 : 1;
+            int result = memcmp(a.begin + i, b.begin + j, end_a - i);
+            if (result != 0)
+                return result;
+            i = end_a;
+            j = end_b;
+        } else {
+            unsigned char ca = (unsigned char)a.begin[i], cb = (unsigned char)b.begin[j];
+            if (ca != cb)
+                return ca < cb ? -1 : 1;
+            ++i;
+            ++j;
+        }
+    }
+    if (i < a.size || j < b.size)
+        return i < a.size ? 1 : -1;
+    return jvstr_compare(a, b);
+}
+
+static void swap_views(StrView* a, StrView* b) {
+    StrView tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+void jvstr_sort_natural(StrView* strings, size_t count) {
+    while (count > 1) {
+        if (count < SORT_INSERTION_THRESHOLD) {
+            for (size_t i = 1; i < count; ++i)
+                for (size_t j = i; j > 0 && jvstr_compare_natural(strings[j - 1], strings[j]) > 0; --j)
+                    swap_views(&strings[j - 1], &strings[j]);
+            return;
+        }
+        // Median of three moved to the front as pivot, then three-way partition as in multikey_quicksort.
+        size_t mid = count / 2, last = count - 1;
+        if (jvstr_compare_natural(strings[mid], strings[0]) < 0)
+            swap_views(&strings[mid], &strings[0]);
+        if (jvstr_compare_natural(strings[last], strings[mid]) < 0) {
+            swap_views(&strings[last], &strings[mid]);
+            if (jvstr_compare_natural(strings[mid], strings[0]) < 0)
+                swap_views(&strings[mid], &strings[0]);
+        }
+        StrView pivot = strings[mid];
+        size_t lt = 0, i = 0, gt = count;
+        while (i < gt) {
+            int result = jvstr_compare_natural(strings[i], pivot);
+            if (result < 0)
+                swap_views(&strings[lt++], &strings[i++]);
+            else if (result > 0)
+                swap_views(&strings[i], &strings[--gt]);
+            else
+                ++i;
+        }
+        // Recursing on the smaller side bounds the stack depth.
+        if (lt < count - gt) {
+            jvstr_sort_natural(strings, lt);
+            strings += gt;
+            count -= gt;
+        } else {
+            jvstr_sort_natural(strings + gt, count - gt);
+            count = lt;
+        }
+    }
+}
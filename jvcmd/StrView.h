@@ -38,10 +38,24 @@ extern "C" {
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
 
 
+/*
+The small functions below marked JVSTR_INLINE (StrView_make, jvstr_extract_first, jvstr_equal...) are called
+for each token or even each byte by parsers, where the call costs more than the function itself.
+Defining JVSTR_HEADER_ONLY (before including this header, or for the whole build) turns them into
+`static inline` definitions in this header, so they are inlined without link-time optimization.
+Otherwise StrView.c defines them out-of-line, as usual, so the ABI does not depend on the macro.
+*/
+#if defined(JVSTR_HEADER_ONLY)
+#define JVSTR_INLINE static inline
+#else
+#define JVSTR_INLINE
+#endif
+
 // Usage: `printf("my_strview = '" STRVIEW_FORMAT "'.\n", STRVIEW_ARGS(my_strview));`
 #define STRVIEW_FORMAT "%.*s"
 #define STRVIEW_ARGS(view) (int)view.size, view.begin
@@ -67,47 +81,227 @@ typedef struct StrView {
 
 // Construct StrView from null-terminated string.
 // If construction from literal string, you may instead use STRVIEW_MAKE.
-StrView StrView_make(char const* nt_str);
+JVSTR_INLINE StrView StrView_make(char const* nt_str);
 
 // Extract first char from the view.
-char jvstr_extract_first(StrView* view);
+JVSTR_INLINE char jvstr_extract_first(StrView* view);
 // Extract last char from the view.
-char jvstr_extract_last(StrView* view);
+JVSTR_INLINE char jvstr_extract_last(StrView* view);
 
 // Return first part and write second part in view.
 // If `where + nb_discarded >= view.size`, a copy of initial view is returned, and `view` is made empty.
-StrView jvstr_split(StrView* view, size_t where, size_t nb_discarded);
+JVSTR_INLINE StrView jvstr_split(StrView* view, size_t where, size_t nb_discarded);
 
 // Check if str starts with prefix.
-bool jvstr_starts_with(StrView str, StrView prefix, size_t starting_pos);
+JVSTR_INLINE bool jvstr_starts_with(StrView str, StrView prefix, size_t starting_pos);
 
 // Check if str ends with suffix.
-bool jvstr_ends_with(StrView str, StrView suffix);
+JVSTR_INLINE bool jvstr_ends_with(StrView str, StrView suffix);
 
 // Check if two StrView's content are equals.
-bool jvstr_equal(StrView a, StrView b);
+JVSTR_INLINE bool jvstr_equal(StrView a, StrView b);
 
 // Compare two StrView lexicographically. Returns negative if a < b, positive if a > b, 0 if a == b.
-int jvstr_compare(StrView a, StrView b);
+JVSTR_INLINE int jvstr_compare(StrView a, StrView b);
+
+// Check if a and b are equal, ignoring ASCII case: "Yes" and "YES" are equal, non-ASCII bytes must be identical.
+bool jvstr_equal_icase(StrView a, StrView b);
+
+// Compare a and b lexicographically as if ASCII uppercase letters were lowercase.
+int jvstr_compare_icase(StrView a, StrView b);
+
+// Compare a and b in natural order: runs of digits compare by their numeric value, so "file9" < "file10".
+// Other bytes compare as in jvstr_compare, which also breaks ties between equal numbers ("a01" < "a1").
+int jvstr_compare_natural(StrView a, StrView b);
 
 // Find first occurrence of `ch`, str.size if not found.
 size_t jvstr_find(StrView str, char ch);
 
-// Find first occurrence of `ch` which is not preceded by `escaper`, str.size if not found.
+// Find first occurrence of `ch` which is not escaped, str.size if not found.
+// `ch` is escaped when preceded by an odd number of `escaper`: with '\\', `\"` is escaped but `\\"` is not.
 size_t jvstr_find_unescaped(StrView str, char ch, char escaper);
 
 // Find last occurrence of `ch`, -1 if not found.
 size_t jvstr_rfind(StrView str, char ch);
 
-// Number of consecutive chars starting at 'starting_pos' which are all in charset.
+// Find last char which is in charset, -1 if not found.
+// i.e. the last path separator with jvstr_rfind_any(path, STRVIEW_MAKE("/\\"))
+size_t jvstr_rfind_any(StrView str, StrView charset);
+
+// Number of consecutive chars starting at 'starting_pos' which are all in charset, plus starting_pos.
+// i.e. index of the first char from starting_pos which is not in charset, str.size if none.
 size_t jvstr_while_in(StrView str, StrView charset, size_t starting_pos);
 
-// Number of consecutive chars starting at 'starting_pos' which are all NOT in charset.
+// Number of consecutive chars starting at 'starting_pos' which are all NOT in charset, plus starting_pos.
+// i.e. index of the first char from starting_pos which is in charset, str.size if none.
 size_t jvstr_until_in(StrView str, StrView charset, size_t starting_pos);
 
+// Precompiled set of chars, to scan strings 16 or 32 bytes at once when SSSE3 or AVX2 is enabled.
+// jvstr_while_in and jvstr_until_in build one on the fly, so prefer the *_in_set versions in loops.
+typedef struct StrCharset {
+    // bit (b & 7) of bitmap[b >> 3] is set if byte b is in the set
+    unsigned char bitmap[32];
+    // Same set, indexed by nibbles for SIMD shuffles (pshufb):
+    // bit ((b >> 4) & 7) of nibbles[b >> 7][b & 15] is set if byte b is in the set
+    unsigned char nibbles[2][16];
+} StrCharset;
+
+// Build the set of chars contained in `chars`.
+StrCharset jvstr_charset_make(StrView chars);
+
+// Check if `ch` is in the set.
+JVSTR_INLINE bool jvstr_charset_has(StrCharset const* set, char ch);
+
+// Index of the first char at or after 'starting_pos' which is not in the set, str.size if none.
+size_t jvstr_while_in_set(StrView str, StrCharset const* set, size_t starting_pos);
+
+// Index of the first char at or after 'starting_pos' which is in the set, str.size if none.
+size_t jvstr_until_in_set(StrView str, StrCharset const* set, size_t starting_pos);
+
+// Find last char which is in the set, -1 if not found.
+size_t jvstr_rfind_in_set(StrView str, StrCharset const* set);
+
 // Find first location of substr in str, str.size if not found.
+// Worst-case linear time, even for adversarial inputs such as str="aaa...a" and substr="aa...ab".
 size_t jvstr_search(StrView str, StrView substr);
 
+// Find last location of substr in str, -1 if not found. Worst-case linear time like jvstr_search.
+size_t jvstr_rsearch(StrView str, StrView substr);
+
+// Seeded 64-bit hash of the bytes of str (wyhash algorithm), not suitable for cryptography.
+// The result does not depend on the platform endianness.
+uint64_t jvstr_hash(StrView str, uint64_t seed);
+
+// Seeded 64-bit hash ignoring ASCII case, i.e. equal to jvstr_hash of the lowercase string.
+uint64_t jvstr_hash_icase(StrView str, uint64_t seed);
+
+// Iterator over the non-overlapping occurrences of a substring, from the beginning.
+// Usage:
+//     jvSearchIter iter = jvstr_search_all(log_line, STRVIEW_MAKE("ERROR"));
+//     for (size_t pos; jvstr_search_next(&iter, &pos);) { ... }
+typedef struct jvSearchIter {
+    StrView str;
+    StrView substr;
+    size_t pos; // where the next search starts
+} jvSearchIter;
+
+// Start an iteration over the non-overlapping occurrences of substr in str.
+jvSearchIter jvstr_search_all(StrView str, StrView substr);
+
+// Write the location of the next occurrence in `*found`, return false if there is none.
+bool jvstr_search_next(jvSearchIter* iter, size_t* found);
+
+// Iterator over the tokens of a string separated by delimiters, without copies.
+// Usage:
+//     jvSplitIter iter = jvstr_split_all_any(line, STRVIEW_MAKE(" \t"), true);
+//     for (StrView field; jvstr_split_next(&iter, &field);) { ... }
+typedef struct jvSplitIter {
+    StrView str;
+    StrCharset delimiters;
+    size_t pos;       // start of the next token, str.size + 1 once finished
+    size_t block_pos; // start of the next block of 64 bytes to scan for delimiters
+    uint64_t mask;    // delimiters not yet consumed in the block before block_pos
+    char delimiter;   // the delimiter, if it is the only one
+    bool is_single;
+    bool skip_empty;
+} jvSplitIter;
+
+// Start an iteration over the tokens of str separated by `delimiter`.
+// Without skip_empty, "a,,b" gives "a", "", "b" and the empty string gives one empty token.
+jvSplitIter jvstr_split_all(StrView str, char delimiter, bool skip_empty);
+
+// Start an iteration over the tokens of str separated by any char of `delimiters`.
+jvSplitIter jvstr_split_all_any(StrView str, StrView delimiters, bool skip_empty);
+
+// Write the next token in `*token`, return false if there is none.
+bool jvstr_split_next(jvSplitIter* iter, StrView* token);
+
+// Write up to `capacity` next tokens in `tokens`, return how many were written (less than capacity once finished).
+size_t jvstr_split_batch(jvSplitIter* iter, StrView* tokens, size_t capacity);
+
+// Find first byte which does not belong to a valid UTF-8 sequence, str.size if str is valid UTF-8.
+// Overlong encodings, surrogates and code points above U+10FFFF are invalid.
+size_t jvstr_find_invalid_utf8(StrView str);
+
+// Number of code points in str, if str is valid UTF-8.
+size_t jvstr_utf8_count(StrView str);
+
+// Number of terminal columns used to display str, which is UTF-8.
+// East Asian wide characters use 2 columns, combining marks and control characters 0, invalid bytes 1.
+size_t jvstr_display_width(StrView str);
+
+// Sort `strings` in the order of jvstr_compare. Returns false if there is not enough memory, then `strings` is unchanged.
+// It is a multikey quicksort on 8 bytes at a time, which are cached as an integer next to each string.
+bool jvstr_sort(StrView* strings, size_t count);
+
+// Sort `strings` in the order of jvstr_compare_natural.
+void jvstr_sort_natural(StrView* strings, size_t count);
+
+// Group `strings` by first byte, so that each group can then be sorted with jvstr_sort independently, i.e. in parallel.
+// The empty strings are in [bounds[0], bounds[1]), and the strings starting with byte `b` in [bounds[b+1], bounds[b+2]),
+// so bounds[257] is `count`. Once all groups are sorted, the whole array is sorted as with jvstr_sort.
+void jvstr_sort_partition(StrView* strings, size_t count, size_t bounds[258]);
+
+
+#if defined(JVSTR_HEADER_ONLY) || defined(JVSTR_INLINE_DEFINITIONS)
+/* Definitions of the JVSTR_INLINE functions, in StrView.c if JVSTR_HEADER_ONLY is not defined. */
+
+JVSTR_INLINE StrView StrView_make(char const* nt_str) {
+    StrView view = { nt_str, strlen(nt_str) };
+    return view;
+}
+
+JVSTR_INLINE char jvstr_extract_first(StrView* view) {
+    --view->size;
+    return *(view->begin++);
+}
+
+JVSTR_INLINE char jvstr_extract_last(StrView* view) {
+    --view->size;
+    return *(view->begin + view->size);
+}
+
+JVSTR_INLINE StrView jvstr_split(StrView* view, size_t where, size_t nb_discarded) {
+    if (nb_discarded > view->size - where)
+        nb_discarded = view->size - where; // prevent overflow
+    StrView retview = { view->begin, where };
+    view->begin += where + nb_discarded;
+    view->size -= where + nb_discarded;
+    return retview;
+}
+
+JVSTR_INLINE bool jvstr_starts_with(StrView str, StrView prefix, size_t starting_pos) {
+    if (str.size < starting_pos + prefix.size) {
+        return false;
+    }
+    return memcmp(str.begin + starting_pos, prefix.begin, prefix.size) == 0;
+}
+
+JVSTR_INLINE bool jvstr_ends_with(StrView str, StrView suffix) {
+    if (str.size < suffix.size) {
+        return false;
+    }
+    return memcmp(str.begin + str.size - suffix.size, suffix.begin, suffix.size) == 0;
+}
+
+JVSTR_INLINE bool jvstr_equal(StrView a, StrView b) {
+    return a.size == b.size && memcmp(a.begin, b.begin, a.size) == 0;
+}
+
+JVSTR_INLINE int jvstr_compare(StrView a, StrView b) {
+    size_t minsize = a.size < b.size ? a.size : b.size;
+    int result = memcmp(a.begin, b.begin, minsize);
+    // comparing size. if a is empty: negative, if b is empty: positive, both: 0
+    return result != 0 ? result : (int)(a.size - b.size);
+}
+
+JVSTR_INLINE bool jvstr_charset_has(StrCharset const* set, char ch) {
+    unsigned char b = (unsigned char)ch;
+    return (set->bitmap[b >> 3] >> (b & 7)) & 1;
+}
+
+#endif
+
 
 #ifdef __cplusplus
 }
@@ -30,6 +30,10 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#if !defined(_POSIX_C_SOURCE) && !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L /* for open() and mmap() */
+#endif
+
 #include "jvcmd.h"
 
 #include <stddef.h>
@@ -38,8 +42,25 @@ SOFTWARE.
 #include <errno.h>
 #include <stdarg.h>
 #include <limits.h>
+#include <stdint.h>
+#include <setjmp.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define JVCMD_HAS_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h> /* for the terminal width */
+#endif
 
 #include "StrView.h"
+#include "StrPattern.h"
+#include "JsonDoc.h"
+#include "StrMap.h"
+#include "StrBuf.h"
+#include "StrPool.h"
+#include "StrSwitch.h"
 
 static const int help_name_padding = 25;
 
@@ -47,128 +68,343 @@ static const int help_name_padding = 25;
 #define SET_IF_NULL(var, value) ((var) == NULL ? (var) = (value) : NULL)
 
 
-static void print_usage(FILE* f, jvParsingConfig const* config) {
-    fprintf(f, "USAGE: %s ", config->program_name);
+/* Output is assembled in a buffer on the stack, then written at once: most messages do not allocate. */
+enum { OUTPUT_STACK_SIZE = 4096 };
+
+static void append_str(StrBuf* out, char const* str) {
+    jvstr_buf_append(out, StrView_make(str));
+}
+
+static void append_usage(StrBuf* out, jvParsingConfig const* config) {
+    append_str(out, "USAGE: ");
+    append_str(out, config->program_name);
+    jvstr_buf_append_char(out, ' ');
+    if (config->usage != NULL) {
+        append_str(out, config->usage);
+        jvstr_buf_append_char(out, '\n');
+        return;
+    }
     jvArgument* const* options = config->options;
     for (jvArgument* option; (option = *options) != NULL; ++options) {
         if (!option->required)
-            fputs("[", f);
-        fprintf(f, "%s%s", config->options_prefix, option->name);
-        if (config->short_options_prefix[0] != '\0' && option->short_name != '\0')
-            fprintf(f, "|%s%c", config->short_options_prefix, option->short_name);
+            jvstr_buf_append_char(out, '[');
+        append_str(out, config->options_prefix);
+        append_str(out, option->name);
+        if (config->short_options_prefix[0] != '\0' && option->short_name != '\0') {
+            jvstr_buf_append_char(out, '|');
+            append_str(out, config->short_options_prefix);
+            jvstr_buf_append_char(out, option->short_name);
+        }
         if (option->need_value)
-            fputs(" ...", f);
+            append_str(out, " ...");
         if (!option->required)
-            fputs("]", f);
-        fputc(' ', f);
+            jvstr_buf_append_char(out, ']');
+        jvstr_buf_append_char(out, ' ');
     }
     
     if (config->no_more_options[0] != '\0') {
-        fprintf(f, "[%s] ", config->no_more_options);
+        jvstr_buf_append_char(out, '[');
+        append_str(out, config->no_more_options);
+        append_str(out, "] ");
     }
     
     jvArgument* const* pos_args = config->pos_args;
     int arg_pos = 0;
     for (jvArgument* arg; (arg = *pos_args) != NULL; ++pos_args) {
-        if (arg_pos < config->nb_pos_args_required)
-            fprintf(f, "<%s> ", arg->name);
-        else
-            fprintf(f, "[%s] ", arg->name);
+        bool is_required = arg_pos < config->nb_pos_args_required;
+        jvstr_buf_append_char(out, is_required ? '<' : '[');
+        append_str(out, arg->name);
+        append_str(out, is_required ? "> " : "] ");
+        if (arg->multiple)
+            append_str(out, "... ");
         ++arg_pos;
     }
-    fputc('\n', f);
+    jvstr_buf_append_char(out, '\n');
 }
 
+/* Number of columns of the terminal: $COLUMNS, else asked to the terminal, else 80. */
+static int terminal_width(void) {
+    char const* columns = getenv("COLUMNS");
+    if (columns != NULL && atoi(columns) > 0)
+        return atoi(columns);
+#if defined(TIOCGWINSZ)
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0)
+        return size.ws_col;
+#endif
+    return 80;
+}
 
-/* Print the command-line help to stdout and then call exit(0) */
-void jvcmd_exit_with_help(jvParsingConfig const* config) {
-    if (config->description != NULL)
-        puts(config->description);
-    print_usage(stdout, config);
+/* Append 'text' then a newline, wrapped at word boundaries so that lines do not exceed 'width' columns.
+   The cursor is at column 'position', and continuation lines start at column 'indent'. NULL is an empty text. */
+static void append_wrapped(StrBuf* out, char const* text, int position, int indent, int width) {
+    if (width - indent < 20) // too narrow to be readable, letting the terminal wrap
+        width = INT_MAX;
+    jvSplitIter lines = jvstr_split_all(StrView_make(text != NULL ? text : ""), '\n', false);
+    bool is_first_line = true;
+    for (StrView line; jvstr_split_next(&lines, &line);) {
+        if (!is_first_line) {
+            jvstr_buf_append_char(out, '\n');
+            jvstr_buf_append_repeat(out, ' ', (size_t)indent);
+            position = indent;
+        }
+        is_first_line = false;
+        bool is_line_start = true;
+        jvSplitIter words = jvstr_split_all(line, ' ', true);
+        for (StrView word; jvstr_split_next(&words, &word);) {
+            int word_width = (int)jvstr_display_width(word);
+            if (!is_line_start && position + 1 + word_width > width) {
+                jvstr_buf_append_char(out, '\n');
+                jvstr_buf_append_repeat(out, ' ', (size_t)indent);
+                position = indent;
+                is_line_start = true;
+            }
+            if (!is_line_start) {
+                jvstr_buf_append_char(out, ' ');
+                position += 1;
+            }
+            jvstr_buf_append(out, word);
+            position += word_width;
+            is_line_start = false;
+        }
+    }
+    jvstr_buf_append_char(out, '\n');
+}
+
+/* Write the whole buffer to the stream, then release it. */
+static void write_output(StrBuf* out, FILE* f) {
+    fwrite(out->begin, 1, out->size, f);
+    fflush(f);
+    jvstr_buf_free(out);
+}
+
+/* Lists of the arguments and epilog, as printed by --help after the usage. */
+static void append_arguments_help(StrBuf* out, jvParsingConfig const* config, int width) {
+    int help_column = 4 + help_name_padding + 1; /* where help texts start */
     
-    puts("\n  Positional Arguments:");
+    append_str(out, "\n  Positional Arguments:\n");
     jvArgument* const* pos_args = config->pos_args;
     int arg_pos = 0;
     for (jvArgument* arg; (arg = *pos_args) != NULL; ++pos_args) {
-        int nb_padding = help_name_padding - 3 - strlen(arg->name);
+        int name_width = (int)jvstr_display_width(StrView_make(arg->name));
+        int nb_padding = help_name_padding - 3 - name_width;
         if (nb_padding < 0)
             nb_padding = 0;
-            
-        if (arg_pos < config->nb_pos_args_required)
-            printf("    <%s> %*s %s\n", arg->name, nb_padding, "", arg->help);
-        else
-            printf("    [%s] %*s %s\n", arg->name, nb_padding, "", arg->help);
+        
+        bool is_required = arg_pos < config->nb_pos_args_required;
+        append_str(out, is_required ? "    <" : "    [");
+        append_str(out, arg->name);
+        append_str(out, is_required ? "> " : "] ");
+        jvstr_buf_append_repeat(out, ' ', (size_t)nb_padding + 1);
+        append_wrapped(out, arg->help, 4 + name_width + 2 + 1 + nb_padding + 1, help_column, width);
         ++arg_pos;
     }
     
-    puts("\n  Options:");
-    int short_prefix_length = strlen(config->short_options_prefix);
-    int long_prefix_length = strlen(config->options_prefix);
+    append_str(out, "\n  Options:\n");
+    int short_prefix_width = (int)jvstr_display_width(StrView_make(config->short_options_prefix));
+    int long_prefix_width = (int)jvstr_display_width(StrView_make(config->options_prefix));
     
-    printf("    --jvcmd%*s License attribution for the jvcmd library.\n", help_name_padding-7, "");
-    if (!config->no_help)
-        printf("    --help%*s Show this message.\n", help_name_padding-6, "");
+    append_str(out, "    --jvcmd");
+    jvstr_buf_append_repeat(out, ' ', (size_t)help_name_padding - 7 + 1);
+    append_str(out, "License attribution for the jvcmd library.\n");
+    if (!config->no_help) {
+        append_str(out, "    --help");
+        jvstr_buf_append_repeat(out, ' ', (size_t)help_name_padding - 6 + 1);
+        append_str(out, "Show this message.\n");
+    }
     
     
     jvArgument* const* options = config->options;
     for (jvArgument* option; (option = *options) != NULL; ++options) {
-        fputs("    ", stdout);
+        append_str(out, "    ");
         
         int nb_padding = help_name_padding;
         
         if (!option->required) {
-            fputs("[", stdout);
+            jvstr_buf_append_char(out, '[');
             nb_padding -= 1;
         }
         
-        printf("%s%s", config->options_prefix, option->name);
-        nb_padding -= long_prefix_length + strlen(option->name);
+        append_str(out, config->options_prefix);
+        append_str(out, option->name);
+        nb_padding -= long_prefix_width + (int)jvstr_display_width(StrView_make(option->name));
         
         if (config->short_options_prefix[0] != '\0' && option->short_name != '\0') {
-            printf("|%s%c", config->short_options_prefix, option->short_name);
-            nb_padding -= short_prefix_length + 2;
+            jvstr_buf_append_char(out, '|');
+            append_str(out, config->short_options_prefix);
+            jvstr_buf_append_char(out, option->short_name);
+            nb_padding -= short_prefix_width + 2;
         }
         
         if (option->need_value) {
-            fputs(" ...", stdout);
+            append_str(out, " ...");
             nb_padding -= 4;
         }
             
         if (!option->required) {
-            fputs("]", stdout);
+            jvstr_buf_append_char(out, ']');
             nb_padding -= 1;
         }
         
+        /* when the name is longer than the column, the help follows it */
+        int position = 4 + help_name_padding - nb_padding + 1;
         if (nb_padding < 0)
             nb_padding = 0;
-        printf("%*s %s\n", nb_padding, "", option->help);
+        jvstr_buf_append_repeat(out, ' ', (size_t)nb_padding + 1);
+        append_wrapped(out, option->help, position + nb_padding, help_column, width);
     }
     
-    puts("");
-    if (config->epilog != NULL)
-        puts(config->epilog);
+    jvstr_buf_append_char(out, '\n');
+    if (config->epilog != NULL) {
+        append_str(out, config->epilog);
+        jvstr_buf_append_char(out, '\n');
+    }
+}
+
+/* Print the command-line help to stdout and then call exit(0) */
+void jvcmd_exit_with_help(jvParsingConfig const* config) {
+    char stack_memory[OUTPUT_STACK_SIZE];
+    StrBuf out;
+    jvstr_buf_init_in(&out, stack_memory, sizeof(stack_memory));
+    
+    if (config->description != NULL) {
+        append_str(&out, config->description);
+        jvstr_buf_append_char(&out, '\n');
+    }
+    append_usage(&out, config);
     
+    if (config->help_text != NULL)
+        append_str(&out, config->help_text);
+    else
+        append_arguments_help(&out, config, terminal_width());
+    
+    write_output(&out, stdout);
     exit(0);
 }
 
+char* jvcmd_render_help(jvParsingConfig const* config, int width) {
+    static jvArgument* const null_arg = NULL;
+    jvParsingConfig defaults = *config;
+    SET_IF_NULL(defaults.short_options_prefix, "-");
+    SET_IF_NULL(defaults.options_prefix, "--");
+    SET_IF_NULL(defaults.options, &null_arg);
+    SET_IF_NULL(defaults.pos_args, &null_arg);
+    
+    StrBuf out;
+    jvstr_buf_init(&out);
+    append_arguments_help(&out, &defaults, width);
+    char* help = out.has_failed ? NULL : (char*)malloc(out.size + 1);
+    if (help != NULL)
+        memcpy(help, out.begin, out.size + 1);
+    jvstr_buf_free(&out);
+    return help;
+}
+
+// State of jvcmd_try_parse_arguments, errors jump back to it.
+typedef struct jvTryContext {
+    jmp_buf jump;
+    char* error;
+    size_t error_size;
+} jvTryContext;
+
 /* Print the error (formatted with printf) to stderr and then call exit(1) */
 void jvcmd_exit_with_error(jvParsingConfig const* config, char const* fmt, ...) {
-    fprintf(stderr, "ERROR!\n");
-    print_usage(stderr, config);
+    if (config->try_context != NULL) {
+        // jvcmd_try_parse_arguments: the message is returned instead of exiting.
+        jvTryContext* context = config->try_context;
+        va_list vlist;
+        va_start(vlist, fmt);
+        if (context->error_size > 0)
+            vsnprintf(context->error, context->error_size, fmt, vlist);
+        va_end(vlist);
+        free(config->option_index);
+        longjmp(context->jump, 1);
+    }
+    
+    char stack_memory[OUTPUT_STACK_SIZE];
+    StrBuf out;
+    jvstr_buf_init_in(&out, stack_memory, sizeof(stack_memory));
+    
+    append_str(&out, "ERROR!\n");
+    append_usage(&out, config);
     
     va_list vlist;
     va_start(vlist, fmt);
-    vfprintf(stderr, fmt, vlist);
+    jvstr_buf_append_vformat(&out, fmt, vlist);
     va_end(vlist);
     
     if (!config->no_help) {
-        fprintf(stderr, "\nType '%s --help' for more information.", config->program_name);
+        append_str(&out, "\nType '");
+        append_str(&out, config->program_name);
+        append_str(&out, " --help' for more information.");
     }
-    fputs("\n", stderr);
+    jvstr_buf_append_char(&out, '\n');
+    write_output(&out, stderr);
     exit(1);
 }
 
 
+/* Options by name, so that each argv is matched in constant time whatever the number of options. */
+typedef struct jvOptionIndex {
+    jvArgument* short_names[256]; /* indexed by the short name as unsigned char, NULL if unused */
+    StrMap long_names;            /* long name to jvArgument*, its storage follows the structure */
+} jvOptionIndex;
+
+static jvOptionIndex* build_option_index(jvParsingConfig* config) {
+    size_t nb_options = 0;
+    while (config->options[nb_options] != NULL)
+        ++nb_options;
+    jvOptionIndex* index = (jvOptionIndex*)malloc(sizeof(jvOptionIndex) + jvstr_map_memory_size(nb_options));
+    if (index == NULL)
+        jvcmd_exit_with_error(config, "Not enough memory to index the options.");
+    memset(index->short_names, 0, sizeof(index->short_names));
+    jvstr_map_init_in(&index->long_names, index + 1, nb_options, (uint64_t)(uintptr_t)index);
+    index->long_names.ignore_case = config->case_insensitive;
+    
+    for (size_t i = 0; i < nb_options; ++i) {
+        // the first option wins in case of duplicated names, as when options were compared in order
+        jvArgument* option = config->options[i];
+        void** value = jvstr_map_insert(&index->long_names, StrView_make(option->name), NULL);
+        if (*value == NULL)
+            *value = option;
+        unsigned char short_name = (unsigned char)option->short_name;
+        if (short_name != 0 && index->short_names[short_name] == NULL)
+            index->short_names[short_name] = option;
+    }
+    return index;
+}
+
+static jvArgument* find_long_option(jvParsingConfig const* config, StrView name) {
+    jvOptionLookup const* lookup = config->option_lookup;
+    if (lookup != NULL)
+        return lookup->find_long(lookup, name.begin, name.size, config->case_insensitive);
+    StrMapEntry* entry = jvstr_map_find(&config->option_index->long_names, name);
+    return entry != NULL ? (jvArgument*)entry->value : NULL;
+}
+
+static jvArgument* find_short_option(jvParsingConfig const* config, char short_name) {
+    if (config->option_lookup != NULL)
+        return config->option_lookup->short_names[(unsigned char)short_name];
+    return config->option_index->short_names[(unsigned char)short_name];
+}
+
+// Record a value of `arg`, the last one being in arg->value and all of them in arg->values if arg->multiple.
+static void set_value(jvParsingConfig const* config, jvArgument* arg, char const* value) {
+    arg->specified = true;
+    arg->value = value;
+    if (!arg->multiple)
+        return;
+    if (arg->nb_values == arg->values_capacity) {
+        int capacity = arg->values_capacity == 0 ? 8 : 2 * arg->values_capacity;
+        char const** values = (char const**)realloc((void*)arg->values, (size_t)capacity * sizeof(char const*));
+        if (values == NULL)
+            jvcmd_exit_with_error(config, "Not enough memory for the values of '%s'.", arg->name);
+        arg->values = values;
+        arg->values_capacity = capacity;
+    }
+    arg->values[arg->nb_values++] = value;
+}
+
 // Returns number of argv used, 'argv[0]' and 'argv[1]' must be defined
 static int check_long_options(char** argv, StrView prefix, jvParsingConfig const* config) {
     StrView arg = StrView_make(argv[0]);
@@ -176,33 +412,29 @@ static int check_long_options(char** argv, StrView prefix, jvParsingConfig const
         return 0;
     jvstr_split(&arg, 0, prefix.size); // discard prefix
     
-    if (jvstr_equal(arg, STRVIEW_MAKE("jvcmd"))) {
+    bool (*equal)(StrView, StrView) = config->case_insensitive ? &jvstr_equal_icase : &jvstr_equal;
+    if (equal(arg, STRVIEW_MAKE("jvcmd"))) {
         puts("Copyright (c) 2021 Julien Vernay ( jvernay.fr )");
         puts("This program uses jvcmd, a MIT-licensed C library, for its command-line interface.");
         puts("jvcmd repository: https://github.com/J-Vernay/jvcmd");
         exit(0);
     }
     
-    if (!config->no_help && jvstr_equal(arg, STRVIEW_MAKE("help")))
+    if (!config->no_help && equal(arg, STRVIEW_MAKE("help")))
         jvcmd_exit_with_help(config);
     
-    jvArgument* const* options = config->options;
-    for (jvArgument* option; (option = *options) != NULL; ++options) {
-        if (!jvstr_equal(arg, StrView_make(option->name)))
-            continue;
-        option->specified = 1;
-        if (option->need_value) {
-            if (argv[1] == NULL)
-                jvcmd_exit_with_error(config, "No value provided for option: %s", argv[0]);
-            option->value = argv[1];
-            return 2;
-        } else {
-            option->value = "";
-            return 1;
-        }
+    jvArgument* option = find_long_option(config, arg);
+    if (option == NULL)
+        jvcmd_exit_with_error(config, "Unknown option: %s", argv[0]);
+    if (option->need_value) {
+        if (argv[1] == NULL)
+            jvcmd_exit_with_error(config, "No value provided for option: %s", argv[0]);
+        set_value(config, option, argv[1]);
+        return 2;
+    } else {
+        set_value(config, option, "");
+        return 1;
     }
-    jvcmd_exit_with_error(config, "Unknown option: %s", argv[0]);
-    return 0; // never reached, but compiles don't know that.
 }
 
 // Returns number of argv used, 'argv[0]' and 'argv[1]' must be defined
@@ -219,36 +451,28 @@ static int check_short_options(char** argv, StrView prefix, jvParsingConfig cons
         if (!config->no_help && c == 'h')
             jvcmd_exit_with_help(config);
         
-        jvArgument* const* options = config->options;
-        jvArgument* option;
-        for (; (option = *options) != NULL; ++options) {
-            if (c != option->short_name)
-                continue;
-            jvstr_split(&arg, 0, 1); // remove short name (= 1 char)
-            
-            option->specified = true;
-            if (option->need_value) {
-                if (chained_short_names)
-                    jvcmd_exit_with_error(config, "%s%c requires a value, so it cannot be used in group, but you entered: %s",
-                                                  config->short_options_prefix, c, argv[0]);
-                if (arg.size > 0) { // current short_name was already removed with previous jvstr_split */
-                    option->value = arg.begin;
-                    return 1;
-                } else { // no remaining chars in current argv, using next argv (i.e. -L /usr/lib )
-                    if (argv[1] == NULL)
-                        jvcmd_exit_with_error(config, "No value provided for option: %s", argv[0]);
-                    option->value = argv[1];
-                    return 2;
-                }
-            } else {
-                option->value = "";
-                chained_short_names = true;
-                break; // continue with next char of arg (i.e. -xcf being equivalent to -x -c -f)
-            }
-        }
-        if (option == NULL) { // all options were compared, and none has matched
-            // unkown short argument
+        jvArgument* option = find_short_option(config, c);
+        if (option == NULL) // unkown short argument
             jvcmd_exit_with_error(config, "Unknown option: %s%c in %s", config->short_options_prefix, c, argv[0]);
+        jvstr_split(&arg, 0, 1); // remove short name (= 1 char)
+        
+        if (option->need_value) {
+            if (chained_short_names)
+                jvcmd_exit_with_error(config, "%s%c requires a value, so it cannot be used in group, but you entered: %s",
+                                              config->short_options_prefix, c, argv[0]);
+            if (arg.size > 0) { // current short_name was already removed with previous jvstr_split */
+                set_value(config, option, arg.begin);
+                return 1;
+            } else { // no remaining chars in current argv, using next argv (i.e. -L /usr/lib )
+                if (argv[1] == NULL)
+                    jvcmd_exit_with_error(config, "No value provided for option: %s", argv[0]);
+                set_value(config, option, argv[1]);
+                return 2;
+            }
+        } else {
+            set_value(config, option, "");
+            chained_short_names = true;
+            // continue with next char of arg (i.e. -xcf being equivalent to -x -c -f)
         }
     }
     return 1;
@@ -270,17 +494,118 @@ static int check_options(char** argv, StrView short_prefix, StrView long_prefix,
     return 0;
 }
 
-static bool is_in_space_delimited_list(StrView value, char const* values) {
-    StrView values_view = StrView_make(values);
-    do {
-        // iterating over values
-        StrView v = jvstr_split(&values_view, jvstr_find(values_view, ' '), 1);
-        if (jvstr_equal(value, v))
+static bool is_in_space_delimited_list(StrView value, char const* values, bool ignore_case) {
+    jvSplitIter iter = jvstr_split_all(StrView_make(values), ' ', true);
+    for (StrView v; jvstr_split_next(&iter, &v);) {
+        if (ignore_case ? jvstr_equal_icase(value, v) : jvstr_equal(value, v))
             return true;
-    } while (values_view.size > 0);
+    }
     return false;
 }
 
+
+/* Read-only mapping of the whole file, unmapped by unmap_file: views of the set point into it,
+   and the pages are shared with other processes using the same file. */
+static bool map_file(char const* path, StrView* content) {
+#ifdef JVCMD_HAS_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    void* data = MAP_FAILED;
+    if (ok && st.st_size > 0)
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (!ok)
+        return false;
+    if (st.st_size == 0) {
+        *content = STRVIEW_MAKE("");
+        return true;
+    }
+    if (data == MAP_FAILED)
+        return false;
+    *content = (StrView){ (char const*)data, (size_t)st.st_size };
+    return true;
+#else
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+        return false;
+    size_t size = 0, capacity = 4096;
+    char* data = (char*)malloc(capacity);
+    while (data != NULL) {
+        size += fread(data + size, 1, capacity - size, f);
+        if (size < capacity)
+            break;
+        capacity *= 2;
+        char* bigger = (char*)realloc(data, capacity);
+        if (bigger == NULL)
+            free(data);
+        data = bigger;
+    }
+    bool ok = data != NULL && !ferror(f);
+    fclose(f);
+    if (!ok) {
+        free(data);
+        return false;
+    }
+    *content = (StrView){ data, size };
+    return true;
+#endif
+}
+
+static void unmap_file(StrView content) {
+#ifdef JVCMD_HAS_MMAP
+    if (content.size > 0) // an empty file is not mapped
+        munmap((void*)content.begin, content.size);
+#else
+    free((void*)content.begin);
+#endif
+}
+
+static void load_allowed_values_file(jvParsingConfig* config, jvArgument* arg) {
+    if (arg->allowed_file_data != NULL) // read by a previous parse which could not index it
+        unmap_file((StrView){ arg->allowed_file_data, arg->allowed_file_size });
+    arg->allowed_file_data = NULL;
+    StrView content;
+    if (!map_file(arg->allowed_values_file, &content))
+        jvcmd_exit_with_error(config, "Cannot read allowed values of '%s' from '%s'.", arg->name, arg->allowed_values_file);
+    arg->allowed_file_data = content.begin; // released with the set, even if indexing it fails
+    arg->allowed_file_size = content.size;
+    
+    size_t nb_lines = 0;
+    jvSplitIter iter = jvstr_split_all(content, '\n', true);
+    for (StrView line; jvstr_split_next(&iter, &line);)
+        ++nb_lines;
+    // the map and its storage in a single allocation
+    StrMap* set = (StrMap*)malloc(sizeof(StrMap) + jvstr_map_memory_size(nb_lines));
+    if (set == NULL)
+        jvcmd_exit_with_error(config, "Not enough memory to index '%s'.", arg->allowed_values_file);
+    jvstr_map_init_in(set, set + 1, nb_lines, (uint64_t)(uintptr_t)set); // seed varying with address randomization
+    set->ignore_case = config->case_insensitive;
+    
+    iter = jvstr_split_all(content, '\n', true);
+    for (StrView line; jvstr_split_next(&iter, &line);) {
+        if (line.begin[line.size-1] == '\r')
+            line.size -= 1;
+        if (line.size > 0)
+            jvstr_map_insert(set, line, NULL);
+    }
+    arg->allowed_set = set;
+}
+
+// Release allowed_switch and allowed_set, built again at the next parse.
+static void free_allowed_indexes(jvArgument* arg) {
+    jvstr_switch_free(arg->allowed_switch);
+    arg->allowed_switch = NULL;
+    free(arg->allowed_set); // the map and its storage are a single allocation
+    arg->allowed_set = NULL;
+    if (arg->allowed_file_data != NULL)
+        unmap_file((StrView){ arg->allowed_file_data, arg->allowed_file_size });
+    arg->allowed_file_data = NULL;
+    arg->allowed_file_size = 0;
+}
+
 static void for_all_arguments(jvParsingConfig* config, void(*func)(jvParsingConfig* config, jvArgument* arg, bool is_pos_arg)) {
     jvArgument* const* options = config->options;
     for (jvArgument* option; (option = *options) != NULL; ++options)
@@ -291,26 +616,56 @@ static void for_all_arguments(jvParsingConfig* config, void(*func)(jvParsingConf
 }
 
 
-static void check_convert_value(jvParsingConfig* config, jvArgument* arg, bool is_pos_args) {
-    char const* prefix = is_pos_args ? "" : config->options_prefix;
-    if (!arg->specified) {
-        if (arg->need_value && arg->default_value != NULL) {
-            arg->value = arg->default_value;
-            arg->specified = true;
-        } else if (arg->required) {
-            jvcmd_exit_with_error(config, "Option '%s%s' is required but you did not specify it.", prefix, arg->name);
-        }else {
-            return;
-        }
-    }
+// Index 'allowed_values' in arg->allowed_switch, the cases pointing into 'allowed_values'.
+static void compile_allowed_values(jvParsingConfig* config, jvArgument* arg) {
+    size_t nb_values = 0;
+    jvSplitIter iter = jvstr_split_all(StrView_make(arg->allowed_values), ' ', true);
+    for (StrView v; jvstr_split_next(&iter, &v);)
+        ++nb_values;
+    StrView* values = (StrView*)malloc((nb_values + 1) * sizeof(StrView));
+    if (values == NULL)
+        jvcmd_exit_with_error(config, "Not enough memory to index the values of '%s'.", arg->name);
+    iter = jvstr_split_all(StrView_make(arg->allowed_values), ' ', true);
+    jvstr_split_batch(&iter, values, nb_values);
+    char const* error;
+    arg->allowed_switch = jvstr_switch_compile(values, nb_values, config->case_insensitive, &error);
+    free(values);
+    if (arg->allowed_switch == NULL)
+        jvcmd_exit_with_error(config, "Cannot index the allowed values of '%s': %s.", arg->name, error);
+}
+
+// Copy of `value` in config->value_pool.
+static char const* intern_value(jvParsingConfig const* config, char const* value, unsigned* id) {
+    uint32_t value_id = 0;
+    StrView interned = jvstr_pool_intern(config->value_pool, StrView_make(value), &value_id);
+    if (interned.begin == NULL)
+        jvcmd_exit_with_error(config, "Not enough memory to store '%s'.", value);
+    if (id != NULL)
+        *id = value_id;
+    return interned.begin;
+}
+
+// Check and convert arg->value.
+static void check_value(jvParsingConfig* config, jvArgument* arg, char const* prefix) {
+    if (config->value_pool != NULL && arg->value != NULL)
+        arg->value = intern_value(config, arg->value, &arg->value_id);
     if (arg->need_value) {
-        if (arg->allowed_values) {
-            bool is_allowed = is_in_space_delimited_list(StrView_make(arg->value), arg->allowed_values);
-            
-            if (!is_allowed)
+        if (arg->allowed_switch) {
+            arg->as_index = jvstr_switch_find(arg->allowed_switch, StrView_make(arg->value));
+            if (arg->as_index < 0)
                 jvcmd_exit_with_error(config, "Invalid value for option '%s%s', '%s' is not in '%s'.",
                                           prefix, arg->name, arg->value, arg->allowed_values);
         }
+        if (arg->allowed_set) {
+            if (jvstr_map_find(arg->allowed_set, StrView_make(arg->value)) == NULL)
+                jvcmd_exit_with_error(config, "Invalid value for option '%s%s', '%s' is not listed in '%s'.",
+                                          prefix, arg->name, arg->value, arg->allowed_values_file);
+        }
+        if (arg->compiled_pattern) {
+            if (!jvstr_pattern_match(arg->compiled_pattern, StrView_make(arg->value)))
+                jvcmd_exit_with_error(config, "Invalid value for option '%s%s', '%s' does not match '%s'.",
+                                          prefix, arg->name, arg->value, arg->pattern);
+        }
         char const* begin = arg->value;
         errno = 0;
         if (arg->is_int) {
@@ -332,14 +687,18 @@ static void check_convert_value(jvParsingConfig* config, jvArgument* arg, bool i
             char* end;
             float value = strtof(begin, &end);
             // if either limits or value is NaN, error
-            if (!(arg->float_min == arg->float_max) && (value < arg->float_min || value > arg->float_max)) 
-                jvcmd_exit_with_error(config, "Invalid value for option '%s%s', '%s' is out of range. (min value: %f, max value: %f)",
-                                          prefix, arg->name, arg->value, arg->float_min, arg->float_max);
+            if (!(arg->float_min == arg->float_max) && (value < arg->float_min || value > arg->float_max)) {
+                char min_value[JVSTR_FORMAT_SIZE], max_value[JVSTR_FORMAT_SIZE];
+                jvstr_format_float(min_value, arg->float_min);
+                jvstr_format_float(max_value, arg->float_max);
+                jvcmd_exit_with_error(config, "Invalid value for option '%s%s', '%s' is out of range. (min value: %s, max value: %s)",
+                                          prefix, arg->name, arg->value, min_value, max_value);
+            }
             arg->as_float = value;
         }
         if (arg->is_bool) {
-            bool is_false = is_in_space_delimited_list(StrView_make(arg->value), config->false_synonyms);
-            bool is_true = is_in_space_delimited_list(StrView_make(arg->value), config->true_synonyms);
+            bool is_false = is_in_space_delimited_list(StrView_make(arg->value), config->false_synonyms, config->case_insensitive);
+            bool is_true = is_in_space_delimited_list(StrView_make(arg->value), config->true_synonyms, config->case_insensitive);
             
             if (!is_false && !is_true) {
                 jvcmd_exit_with_error(config, "Invalid value for option %s%s, '%s' is not a boolean. (accepted: %s %s)",
@@ -347,6 +706,48 @@ static void check_convert_value(jvParsingConfig* config, jvArgument* arg, bool i
             }
             arg->as_bool = is_true;
         }
+        if (arg->is_json) {
+            if (arg->as_json != NULL) { // previous value, or previous parse
+                jvjson_free(arg->as_json);
+                free(arg->as_json);
+                arg->as_json = NULL;
+            }
+            char const* error;
+            size_t error_pos;
+            JsonDoc* doc = (JsonDoc*)malloc(sizeof(JsonDoc));
+            if (doc == NULL)
+                jvcmd_exit_with_error(config, "Not enough memory for option '%s%s'.", prefix, arg->name);
+            if (!jvjson_parse(doc, StrView_make(arg->value), &error, &error_pos)) {
+                jvjson_free(doc);
+                free(doc);
+                jvcmd_exit_with_error(config, "Invalid value for option '%s%s', it is not valid JSON: %s at byte %d.",
+                                          prefix, arg->name, error, (int)error_pos);
+            }
+            arg->as_json = doc;
+        }
+    }
+}
+
+static void check_convert_value(jvParsingConfig* config, jvArgument* arg, bool is_pos_args) {
+    char const* prefix = is_pos_args ? "" : config->options_prefix;
+    if (!arg->specified) {
+        if (arg->need_value && arg->default_value != NULL) {
+            set_value(config, arg, arg->default_value);
+        } else if (arg->required) {
+            jvcmd_exit_with_error(config, "Option '%s%s' is required but you did not specify it.", prefix, arg->name);
+        }else {
+            return;
+        }
+    }
+    if (arg->multiple) {
+        // Each value is checked, the conversions of the last one are kept.
+        for (int i = 0; i < arg->nb_values; ++i) {
+            arg->value = arg->values[i];
+            check_value(config, arg, prefix);
+            arg->values[i] = arg->value;
+        }
+    } else {
+        check_value(config, arg, prefix);
     }
     if (arg->action) {
         arg->action(config, arg);
@@ -354,38 +755,89 @@ static void check_convert_value(jvParsingConfig* config, jvArgument* arg, bool i
 }
 
 
-static void set_actual_need_value(jvParsingConfig* config, jvArgument* arg, bool is_pos_arg) {
+// OUTPUT fields of a previous parse, cleared before any argument is compiled so that an error leaves none of them.
+static void reset_output(jvParsingConfig* config, jvArgument* arg, bool is_pos_arg) {
     (void)config; (void)is_pos_arg;
-    arg->need_value = arg->need_value || arg->is_int || arg->is_float || arg->is_bool || (arg->allowed_values != NULL);
+    arg->value = NULL;
+    arg->specified = false;
+    arg->as_int = 0;
+    arg->as_float = 0;
+    arg->as_bool = false;
+    if (arg->as_json != NULL) {
+        jvjson_free(arg->as_json);
+        free(arg->as_json);
+        arg->as_json = NULL;
+    }
+    arg->as_index = -1;
+    arg->value_id = 0;
+    arg->nb_values = 0; // 'values' is kept to be reused
 }
 
-void jvcmd_parse_arguments(int argc, char** argv, jvParsingConfig config) {
+static void compile_argument(jvParsingConfig* config, jvArgument* arg, bool is_pos_arg) {
+    (void)is_pos_arg;
+    arg->need_value = arg->need_value || arg->is_int || arg->is_float || arg->is_bool || arg->is_json
+                   || (arg->allowed_values != NULL) || (arg->allowed_values_file != NULL) || (arg->pattern != NULL);
+    if (arg->indexed_ignore_case != config->case_insensitive) {
+        // the indexes hash the values with or without their case, as when they were built
+        free_allowed_indexes(arg);
+        arg->indexed_ignore_case = config->case_insensitive;
+    }
+    if (arg->allowed_values != NULL && arg->allowed_switch == NULL)
+        compile_allowed_values(config, arg);
+    if (arg->allowed_values_file != NULL && arg->allowed_set == NULL)
+        load_allowed_values_file(config, arg);
+    if (arg->pattern != NULL && arg->compiled_pattern == NULL) {
+        char const* error;
+        size_t error_pos;
+        arg->compiled_pattern = jvstr_pattern_compile(StrView_make(arg->pattern), &error, &error_pos);
+        if (arg->compiled_pattern == NULL)
+            jvcmd_exit_with_error(config, "Invalid pattern for '%s': %s at offset %d in '%s'.",
+                                      arg->name, error, (int)error_pos, arg->pattern);
+    }
+}
+
+static void parse_arguments(int argc, char** argv, jvParsingConfig* config) {
     static jvArgument* const null_arg = NULL;
 
-    if (config.program_name == NULL) {
-        config.program_name = argv[0];
+    int argv_offset = 0; /* index in original argv of argv[0] */
+    if (config->program_name == NULL) {
+        config->program_name = argv[0];
         argc -= 1;
         argv += 1;
+        argv_offset = 1;
     }
     
-    SET_IF_NULL(config.short_options_prefix, "-");
-    SET_IF_NULL(config.options_prefix, "--");
-    SET_IF_NULL(config.no_more_options, "--");
-    SET_IF_NULL(config.true_synonyms, "1 true True TRUE y Y yes Yes YES");
-    SET_IF_NULL(config.false_synonyms, "0 false False FALSE n N no No NO");
-    SET_IF_NULL(config.options, &null_arg);
-    SET_IF_NULL(config.pos_args, &null_arg);
+    SET_IF_NULL(config->short_options_prefix, "-");
+    SET_IF_NULL(config->options_prefix, "--");
+    SET_IF_NULL(config->no_more_options, "--");
+    SET_IF_NULL(config->true_synonyms, "1 true True TRUE y Y yes Yes YES");
+    SET_IF_NULL(config->false_synonyms, "0 false False FALSE n N no No NO");
+    SET_IF_NULL(config->options, &null_arg);
+    SET_IF_NULL(config->pos_args, &null_arg);
+    
+    if (config->strict_utf8) {
+        for (int i = 0; i < argc; ++i) {
+            StrView arg = StrView_make(argv[i]);
+            size_t invalid_pos = jvstr_find_invalid_utf8(arg);
+            if (invalid_pos != arg.size)
+                jvcmd_exit_with_error(config, "Argument %d is not valid UTF-8, invalid byte at offset %d.",
+                                          i + argv_offset, (int)invalid_pos);
+        }
+    }
     
-    StrView short_opt_prefix = StrView_make(config.short_options_prefix);
-    StrView opt_prefix = StrView_make(config.options_prefix);
-    StrView no_more_options = StrView_make(config.no_more_options);
+    StrView short_opt_prefix = StrView_make(config->short_options_prefix);
+    StrView opt_prefix = StrView_make(config->options_prefix);
+    StrView no_more_options = StrView_make(config->no_more_options);
     
     int nb_pos_args_total = 0;
-    if (config.pos_args != NULL)
-        while (config.pos_args[nb_pos_args_total] != NULL)
+    if (config->pos_args != NULL)
+        while (config->pos_args[nb_pos_args_total] != NULL)
             ++nb_pos_args_total;
             
-    for_all_arguments(&config, &set_actual_need_value);
+    for_all_arguments(config, &reset_output);
+    for_all_arguments(config, &compile_argument);
+    if (config->option_lookup == NULL)
+        config->option_index = build_option_index(config);
     
     int argument_pos = 0;
     bool no_more_options_encountered = false;
@@ -396,32 +848,80 @@ void jvcmd_parse_arguments(int argc, char** argv, jvParsingConfig config) {
                 no_more_options_encountered = true;
                 nb_argv_consumed = 1;
             } else {
-                nb_argv_consumed = check_options(argv + i, short_opt_prefix, opt_prefix, &config);
+                nb_argv_consumed = check_options(argv + i, short_opt_prefix, opt_prefix, config);
             }
         }
     
         if (nb_argv_consumed == 0) { 
             // checking positional argument
-            if (argument_pos >= nb_pos_args_total) { // no positional arguments were expected
-                if (config.action_extra_value == NULL)
-                    jvcmd_exit_with_error(&config, "Only %d positional arguments are accepted, but you gave '%s'", nb_pos_args_total, argv[i]);
-                config.action_extra_value(argv[i], config.userdata);
+            if (argument_pos >= nb_pos_args_total && nb_pos_args_total > 0 && config->pos_args[nb_pos_args_total - 1]->multiple) {
+                set_value(config, config->pos_args[nb_pos_args_total - 1], argv[i]); // variadic last positional argument
+            } else if (argument_pos >= nb_pos_args_total) { // no positional arguments were expected
+                if (config->action_extra_value == NULL)
+                    jvcmd_exit_with_error(config, "Only %d positional arguments are accepted, but you gave '%s'", nb_pos_args_total, argv[i]);
+                char const* extra_value = argv[i];
+                if (config->value_pool != NULL)
+                    extra_value = intern_value(config, extra_value, NULL);
+                config->action_extra_value(extra_value, config->userdata);
             } else {
-                config.pos_args[argument_pos]->specified = true;
-                config.pos_args[argument_pos]->value = argv[i];
+                set_value(config, config->pos_args[argument_pos], argv[i]);
             }
             nb_argv_consumed = 1;
             ++argument_pos;
-            if (config.stops_at_last_pos && argument_pos == nb_pos_args_total)
+            if (config->stops_at_last_pos && argument_pos == nb_pos_args_total) {
+                // a variadic last positional argument takes all the remaining values, even those looking like options
+                jvArgument* last_pos_arg = config->pos_args[nb_pos_args_total - 1];
+                if (last_pos_arg->multiple)
+                    for (int j = i + 1; j < argc; ++j)
+                        set_value(config, last_pos_arg, argv[j]);
                 break; // stop here
+            }
         }
         i += nb_argv_consumed;
     }
     
-    if (argument_pos < config.nb_pos_args_required)
-        jvcmd_exit_with_error(&config, "At least %d positional arguments are required, but you gave %d arguments.", config.nb_pos_args_required, argument_pos);
+    if (argument_pos < config->nb_pos_args_required)
+        jvcmd_exit_with_error(config, "At least %d positional arguments are required, but you gave %d arguments.", config->nb_pos_args_required, argument_pos);
     
-    for_all_arguments(&config, &check_convert_value);
+    free(config->option_index);
+    config->option_index = NULL;
+    for_all_arguments(config, &check_convert_value);
+}
+
+void jvcmd_parse_arguments(int argc, char** argv, jvParsingConfig config) {
+    parse_arguments(argc, argv, &config);
+}
+
+bool jvcmd_try_parse_arguments(int argc, char** argv, jvParsingConfig config, char* error, size_t error_size) {
+    jvTryContext context;
+    context.error = error;
+    context.error_size = error_size;
+    config.try_context = &context;
+    if (setjmp(context.jump) != 0)
+        return false; // nothing to release: jvcmd_exit_with_error did it
+    parse_arguments(argc, argv, &config);
+    if (error_size > 0)
+        error[0] = '\0';
+    return true;
+}
+
+// Release what the parses built into one argument, see the OUTPUT and INTERNAL fields of jvArgument.
+static void free_argument(jvParsingConfig* config, jvArgument* arg, bool is_pos_arg) {
+    reset_output(config, arg, is_pos_arg);
+    free((void*)arg->values);
+    arg->values = NULL;
+    arg->values_capacity = 0;
+    free_allowed_indexes(arg);
+    jvstr_pattern_free(arg->compiled_pattern);
+    arg->compiled_pattern = NULL;
+}
+
+void jvcmd_free_arguments(jvParsingConfig const* config) {
+    static jvArgument* const null_arg = NULL;
+    jvParsingConfig lists = *config;
+    SET_IF_NULL(lists.options, &null_arg);
+    SET_IF_NULL(lists.pos_args, &null_arg);
+    for_all_arguments(&lists, &free_argument);
 }
 
 
@@ -55,36 +55,71 @@ See also "calc.c" and "filetree.cpp" in jvcmd's examples.
 #define JV_CMD
 
 #include <stdbool.h>
+#include <stddef.h>
 
 struct jvParsingConfig;
 
 typedef struct jvArgument {
     /* CONFIG: These fields will be read, each unused field must be zero-initialized. */
     char const* name;           /* long name */
-    char const* help;           /* description of the message */
+    char const* help;           /* description of the message, NULL is the same as "" */
     char        short_name;     /* short name, 0 if no short name */
     bool        required   : 1; /* 1 if error must be triggered if this argument is omitted */
     bool        need_value : 1; /* 1 if the option must be followed by a value (error if no values),
-                                     set automatically if any of is_* is true, or if allowed_values is defined */
+                                     set automatically if any of is_* is true, or if allowed_values(_file) or pattern is defined */
     bool        is_int     : 1; /* 1 if the value must be parsed as int (error if not int) */
     bool        is_float   : 1; /* 1 if the value must be parsed as float (error if not float)  */
     bool        is_bool    : 1; /* 1 if the value must be parsed as bool (error if not bool) */
     float       float_min, float_max; /* used if is_float = true and float_min != float_max */
     int         int_min, int_max; /* used if is_int = true and int_min != int_max */
-    char const* allowed_values; /* space-delimited allowed values, or NULL if everything is allowed */
+    char const* allowed_values; /* space-delimited allowed values, or NULL if everything is allowed.
+                                   They are indexed once into a perfect hash, see <jvcmd/StrSwitch.h>. */
     char const* default_value;  /* NULL if no default value, else will be put into 'value' if argument was not specified. */ 
     
     void* userdata; /* Not used by the library, intended for 'action' callback */
     void (*action) (struct jvParsingConfig* config, struct jvArgument* argument); /* Called after OUTPUT values are written to. NULL if nothing to do. */
     
+    /* CONFIG added since, after the first ones so that positional initializers of the above still work. */
+    bool        is_json    : 1; /* 1 if the value must be a JSON document (error if not valid JSON) */
+    bool        multiple   : 1; /* 1 if the option may be repeated, or if the last positional argument takes all remaining values.
+                                   Every value is checked and listed in 'values', the other OUTPUT fields describe the last one. */
+    char const* allowed_values_file; /* path to a file listing one allowed value per line, or NULL.
+                                        The file is mapped in memory and indexed once into a hash set,
+                                        so checking a value is O(1) even with hundreds of thousands of lines. */
+    char const* pattern;        /* regular expression the whole value must match, or NULL.
+                                   It is compiled once into a DFA, see <jvcmd/StrPattern.h> for the syntax. */
+    
     /* OUTPUT: These fields will be written to. They must all be initialized to 0 */
     char const* value;     /* Value specified by the user, NULL if option not specified, "" if need_value=true and was specified */
     bool        specified; /* true if value specified by the user.  */
     int         as_int;    /* Value converted as integer if is_int = 1. */
     float       as_float;  /* Value converted as float if is_float = 1. */
     bool        as_bool;   /* Value converted as boolean if is_bool = 1. */
+    struct JsonDoc* as_json; /* Value indexed as JSON if is_json = 1, queried with <jvcmd/JsonDoc.h> */
+    int         as_index;  /* Index of the value in 'allowed_values' (0 for the first one) if defined, to switch on it, -1 without a value. */
+    unsigned    value_id;  /* Identifier of 'value' in the config's 'value_pool', if any. */
+    char const** values;   /* All values in order if multiple = 1, kept until jvcmd_free_arguments. */
+    int         nb_values; /* Number of elements of 'values'. */
+    
+    /* INTERNAL: These fields are managed by the library, they must be zero-initialized. */
+    struct StrSwitch* allowed_switch; /* index of 'allowed_values', kept until jvcmd_free_arguments */
+    struct StrMap* allowed_set; /* index of 'allowed_values_file', kept until jvcmd_free_arguments */
+    char const* allowed_file_data; /* content of 'allowed_values_file', which the views of 'allowed_set' point into */
+    size_t allowed_file_size;      /* its size, to unmap it */
+    struct StrPattern* compiled_pattern; /* compiled 'pattern', kept until jvcmd_free_arguments */
+    int values_capacity; /* allocated size of 'values' */
+    bool indexed_ignore_case : 1; /* 'case_insensitive' of the config when allowed_switch and allowed_set were built */
 } jvArgument;
 
+/* Index of the options built ahead of time (see jvcmd::Spec in <jvcmd/jvcmd.hpp>),
+   used instead of indexing 'options' at each parse. */
+typedef struct jvOptionLookup {
+    /* Option whose long name is name[0..size), NULL if none. Names are compared ignoring ASCII case if ignore_case. */
+    jvArgument* (*find_long)(struct jvOptionLookup const* lookup, char const* name, size_t size, bool ignore_case);
+    void const* index;              /* data used by find_long */
+    jvArgument* const* short_names; /* 256 options indexed by the short name as unsigned char, NULL if unused */
+} jvOptionLookup;
+
 typedef struct jvParsingConfig {
     bool        no_help : 1;            /* Do not generate -h/--help
                                            NOTE: You will be charged of notifying the user that they can use --jvcmd
@@ -94,7 +129,7 @@ typedef struct jvParsingConfig {
     char const* program_name;   /* if NULL (default), argv[0] is considered as the program name.
                                        if non-NULL, argv[0] is considered an option like any other argv[...] */
     char const* description;    /* text to print before generated help, may be NULL */
-    char const* usage;          /* if NULL, will be generated by jvstr */
+    char const* usage;          /* printed after the program name, if NULL, will be generated by jvstr */
     char const* epilog;         /* text to print after generated help, may be NULL */
     
     char const* short_options_prefix; /* if NULL, "-" is used. if empty, short options are disabled */
@@ -113,18 +148,47 @@ typedef struct jvParsingConfig {
        If you just want to discard extra arguments, pass it '&jvcmd_discard_extra_values' */
     void (*action_extra_value) (char const* extra_value, void* userdata); 
     void* userdata; /* Passed to 'action_extra_arg' for user logic */
+    
+    /* Settings added since, after the first ones so that positional initializers of the above still work. */
+    bool        strict_utf8 : 1;      /* Error if any argument is not valid UTF-8 */
+    bool        case_insensitive : 1; /* Long option names, allowed values and boolean synonyms ignore ASCII case.
+                                         Short options stay case-sensitive, as -v and -V usually differ. */
+    char const* help_text;        /* if non-NULL, printed by --help after the usage instead of the generated help and epilog,
+                                     i.e. rendered ahead of time with jvcmd_render_help */
+    
+    /* If non-NULL, all values (including defaults and extra values) are interned into this pool, see <jvcmd/StrPool.h>.
+       Equal values then share the same pointer and 'value_id', so they can be compared without strcmp. */
+    struct StrPool* value_pool;
+    
+    jvOptionLookup const* option_lookup; /* if non-NULL, it finds the options, which must be the ones listed in 'options' */
+    
+    /* INTERNAL: These fields are managed by the library, they must be zero-initialized. */
+    struct jvOptionIndex* option_index; /* options by long and short name, only during jvcmd_parse_arguments */
+    struct jvTryContext* try_context;   /* where errors return to, only during jvcmd_try_parse_arguments */
 } jvParsingConfig;
 
 
 
 /* Parse the program arguments. */
 void jvcmd_parse_arguments(int argc, char** argv, jvParsingConfig config);
+/* Parse the program arguments, but on error write the message into 'error' and return false instead of exiting.
+   --help and --jvcmd still exit. If an 'action' calls jvcmd_exit_with_error, it returns here with longjmp,
+   so actions must not hold resources across that call. */
+bool jvcmd_try_parse_arguments(int argc, char** argv, jvParsingConfig config, char* error, size_t error_size);
 
 /* Print the command-line help to stdout and then call exit(0) */
 void jvcmd_exit_with_help(jvParsingConfig const* config);
 /* Print the error (formatted with printf) to stderr and then call exit(1) */
 void jvcmd_exit_with_error(jvParsingConfig const* config, char const* fmt, ...);
 
+/* Release what the parses allocated in the arguments of 'options' and 'pos_args' ('values', 'as_json' and the indexes),
+   and clear their OUTPUT fields. The arguments can be parsed again afterwards. */
+void jvcmd_free_arguments(jvParsingConfig const* config);
+
+/* Help printed by --help after the usage, with lines wrapped at 'width' columns, to be stored in 'help_text'.
+   NULL if there is not enough memory, else it must be released with free(). */
+char* jvcmd_render_help(jvParsingConfig const* config, int width);
+
 /* Do nothing. Can be used to initialize jvParsingConfig.action_extra_value */
 void jvcmd_discard_extra_values(char const* extra_value, void* userdata);
 
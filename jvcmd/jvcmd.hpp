@@ -0,0 +1,904 @@
+/*
+This is the C++ header for the jvcmd library, written by Julien Vernay ( jvernay.fr ) in 2021.
+It wraps <jvcmd/jvcmd.h> without adding allocations or virtual calls, see the documentation below.
+jvcmd is a library to parse the command line arguments (argc and argv of the C main function).
+The library is available under the MIT License, whose terms are below.
+Attribution is handled by the library: it will add the --jvcmd option automatically.
+If you disable the automatic --help option, you are then responsible to
+notify the user that they can use the --jvcmd option to see the copyright notice of jvcmd.
+
+MIT License
+
+Copyright (c) 2021 Julien Vernay ( jvernay.fr )
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+jvcmd::Parser keeps every jvArgument, the NULL-terminated lists and the error message inline,
+so a parser is a single object (usually on the stack) and parsing allocates nothing more than the C core.
+Errors are returned in a jvcmd::Result instead of calling exit(1). --help and --jvcmd still exit.
+
+Usage:
+    jvcmd::Parser<> parser("Iterate over a directory.");
+    auto depth = parser.option("max-depth", "Maximum depth.", 'L').is_int(1, 50).default_value("5");
+    auto roots = parser.positional("root", "Directories to iterate.").multiple().default_value(".");
+    if (auto result = parser.parse(argc, argv); !result) {
+        std::cerr << result.error().message << '\n';
+        return 1;
+    }
+    for (std::string_view root : roots.values())
+        iterate(root, depth.as_int());
+*/
+
+#ifndef JV_CMD_HPP
+#define JV_CMD_HPP
+
+#include "jvcmd.h"
+#include "StrBuf.h"
+#include "StrSwitch.h"
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace jvcmd {
+
+// View of the values of an argument, as std::span<std::string_view const> would give in C++20.
+class Values {
+public:
+    class iterator {
+    public:
+        explicit iterator(char const* const* pos) noexcept : pos_(pos) {}
+        std::string_view operator*() const noexcept { return *pos_; }
+        iterator& operator++() noexcept { ++pos_; return *this; }
+        bool operator==(iterator other) const noexcept { return pos_ == other.pos_; }
+        bool operator!=(iterator other) const noexcept { return pos_ != other.pos_; }
+    private:
+        char const* const* pos_;
+    };
+
+    Values() noexcept = default;
+    Values(char const* const* data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    std::string_view operator[](std::size_t i) const noexcept { return data_[i]; }
+    std::string_view front() const noexcept { return data_[0]; }
+    std::string_view back() const noexcept { return data_[size_ - 1]; }
+    iterator begin() const noexcept { return iterator(data_); }
+    iterator end() const noexcept { return iterator(data_ + size_); }
+
+private:
+    char const* const* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// Parsing error, 'message' points into the parser and is valid until its next parse.
+struct Error {
+    std::string_view message;
+};
+
+// Either a value or an Error, like std::expected of C++23. T must be default-constructible.
+template <class T>
+class Result {
+public:
+    Result(T value) : value_(std::move(value)), ok_(true) {}
+    Result(Error error) : error_(error), ok_(false) {}
+
+    bool has_value() const noexcept { return ok_; }
+    explicit operator bool() const noexcept { return ok_; }
+    T& value() noexcept { return value_; }
+    T const& value() const noexcept { return value_; }
+    T& operator*() noexcept { return value_; }
+    T const& operator*() const noexcept { return value_; }
+    T* operator->() noexcept { return &value_; }
+    T const* operator->() const noexcept { return &value_; }
+    Error const& error() const noexcept { return error_; }
+
+private:
+    T value_ = {};
+    Error error_ = {};
+    bool ok_;
+};
+
+template <>
+class Result<void> {
+public:
+    Result() noexcept : ok_(true) {}
+    Result(Error error) noexcept : error_(error), ok_(false) {}
+
+    bool has_value() const noexcept { return ok_; }
+    explicit operator bool() const noexcept { return ok_; }
+    Error const& error() const noexcept { return error_; }
+
+private:
+    Error error_ = {};
+    bool ok_;
+};
+
+// Handle to a jvArgument stored in a Parser. The setters are named after the CONFIG fields and can be chained,
+// the accessors read the OUTPUT fields after Parser::parse.
+class Arg {
+public:
+    explicit Arg(jvArgument* arg) noexcept : arg_(arg) {}
+
+    Arg help(char const* text) noexcept { arg_->help = text; return *this; }
+    Arg required() noexcept { arg_->required = true; return *this; }
+    Arg need_value() noexcept { arg_->need_value = true; return *this; }
+    Arg is_bool() noexcept { arg_->is_bool = true; return *this; }
+    Arg is_json() noexcept { arg_->is_json = true; return *this; }
+    Arg multiple() noexcept { arg_->multiple = true; return *this; }
+    // Bounds are checked if min != max.
+    Arg is_int(int min = 0, int max = 0) noexcept {
+        arg_->is_int = true;
+        arg_->int_min = min;
+        arg_->int_max = max;
+        return *this;
+    }
+    // Bounds are checked if min != max.
+    Arg is_float(float min = 0, float max = 0) noexcept {
+        arg_->is_float = true;
+        arg_->float_min = min;
+        arg_->float_max = max;
+        return *this;
+    }
+    // The strings are not copied, they must outlive the parser (string literals usually).
+    Arg allowed_values(char const* values) noexcept { arg_->allowed_values = values; return *this; }
+    Arg allowed_values_file(char const* path) noexcept { arg_->allowed_values_file = path; return *this; }
+    Arg pattern(char const* regex) noexcept { arg_->pattern = regex; return *this; }
+    Arg default_value(char const* value) noexcept { arg_->default_value = value; return *this; }
+    Arg action(void (*callback)(jvParsingConfig*, jvArgument*), void* userdata = nullptr) noexcept {
+        arg_->action = callback;
+        arg_->userdata = userdata;
+        return *this;
+    }
+
+    bool specified() const noexcept { return arg_->specified; }
+    // Empty if not specified.
+    std::string_view value() const noexcept { return arg_->value != nullptr ? arg_->value : std::string_view(); }
+    int as_int() const noexcept { return arg_->as_int; }
+    float as_float() const noexcept { return arg_->as_float; }
+    bool as_bool() const noexcept { return arg_->as_bool; }
+    // -1 without a value (not specified and no default value).
+    int as_index() const noexcept { return arg_->as_index; }
+    struct JsonDoc const* as_json() const noexcept { return arg_->as_json; }
+    // All values if multiple(), else the value if specified.
+    Values values() const noexcept {
+        if (arg_->multiple)
+            return Values(arg_->values, (std::size_t)arg_->nb_values);
+        return Values(&arg_->value, arg_->value != nullptr ? 1 : 0);
+    }
+
+    jvArgument& c_argument() const noexcept { return *arg_; }
+
+private:
+    jvArgument* arg_;
+};
+
+// Parser with room for MaxArguments options and positional arguments, and for an error message of ErrorSize bytes.
+// It cannot be copied or moved, because the lists given to the C core point into it.
+template <std::size_t MaxArguments = 32, std::size_t ErrorSize = 256>
+class Parser {
+public:
+    Parser() noexcept = default;
+    explicit Parser(char const* description) noexcept { config_.description = description; }
+    Parser(Parser const&) = delete;
+    Parser& operator=(Parser const&) = delete;
+    ~Parser() {
+        jvParsingConfig config = {};
+        config.options = options_;
+        config.pos_args = pos_args_;
+        jvcmd_free_arguments(&config);
+    }
+
+    // The strings are not copied, they must outlive the parser.
+    Arg option(char const* name, char const* help, char short_name = 0) noexcept {
+        jvArgument* arg = add_argument(name, help);
+        arg->short_name = short_name;
+        if (arg != &overflow_)
+            options_[nb_options_++] = arg;
+        return Arg(arg);
+    }
+
+    // Positional arguments are required in declaration order until the first one which is not required().
+    Arg positional(char const* name, char const* help) noexcept {
+        jvArgument* arg = add_argument(name, help);
+        if (arg != &overflow_)
+            pos_args_[nb_pos_args_++] = arg;
+        return Arg(arg);
+    }
+
+    // Other settings: program_name, usage, epilog, prefixes, synonyms, value_pool...
+    // 'options', 'pos_args' and 'nb_pos_args_required' are overwritten by parse().
+    jvParsingConfig& config() noexcept { return config_; }
+
+    Result<void> parse(int argc, char** argv) {
+        if (nb_arguments_ == MaxArguments && overflow_.name != nullptr)
+            return Error{ "Too many arguments declared in jvcmd::Parser, increase MaxArguments." };
+        int nb_pos_args_required = 0;
+        while (nb_pos_args_required < (int)nb_pos_args_ && pos_args_[nb_pos_args_required]->required)
+            ++nb_pos_args_required;
+        jvParsingConfig config = config_; // the C core clears the OUTPUT fields of the previous parse
+        config.options = options_;
+        config.pos_args = pos_args_;
+        config.nb_pos_args_required = nb_pos_args_required;
+        if (!jvcmd_try_parse_arguments(argc, argv, config, error_, ErrorSize))
+            return Error{ error_ };
+        return {};
+    }
+
+private:
+    jvArgument* add_argument(char const* name, char const* help) noexcept {
+        jvArgument* arg = nb_arguments_ < MaxArguments ? &arguments_[nb_arguments_++] : &overflow_;
+        arg->name = name;
+        arg->help = help;
+        return arg;
+    }
+
+    jvArgument arguments_[MaxArguments] = {};
+    jvArgument overflow_ = {}; // receives the arguments after MaxArguments, so that parse() reports them
+    jvArgument* options_[MaxArguments + 1] = {};
+    jvArgument* pos_args_[MaxArguments + 1] = {};
+    std::size_t nb_arguments_ = 0, nb_options_ = 0, nb_pos_args_ = 0;
+    jvParsingConfig config_ = {};
+    char error_[ErrorSize] = {};
+};
+
+namespace detail {
+
+template <class T>
+constexpr bool dependent_false = false;
+
+template <class T, class = void>
+struct is_container : std::false_type {};
+template <class T>
+struct is_container<T, std::void_t<typename T::value_type, decltype(std::declval<T&>().clear()),
+                                   decltype(std::declval<T&>().push_back(std::declval<typename T::value_type>()))>>
+    : std::true_type {};
+
+// Strings are containers of char, but are bound to a single value.
+template <class T>
+constexpr bool is_multiple = is_container<T>::value && !std::is_constructible_v<T, char const*>;
+
+// Prefix of 'arg' in error messages, as written by the C core.
+inline char const* prefix_of(jvParsingConfig const* config, jvArgument const* arg) noexcept {
+    for (jvArgument* const* pos_arg = config->pos_args; *pos_arg != nullptr; ++pos_arg)
+        if (*pos_arg == arg)
+            return "";
+    return config->options_prefix;
+}
+
+// Convert 'text' into 'out', the integers accept the same syntax as 'is_int'.
+// Errors go through jvcmd_exit_with_error, which may longjmp: no local needs a destructor here.
+template <class T>
+void convert(jvParsingConfig* config, jvArgument* arg, char const* text, T& out) {
+    if constexpr (std::is_same_v<T, bool>) {
+        out = !arg->is_bool || arg->as_bool; // a flag, unless declared with is_bool()
+    } else if constexpr (std::is_enum_v<T>) {
+        if (arg->allowed_switch != nullptr) {
+            out = T(jvstr_switch_find(arg->allowed_switch, StrView_make(text)));
+        } else {
+            std::underlying_type_t<T> value;
+            convert(config, arg, text, value);
+            out = T(value);
+        }
+    } else if constexpr (std::is_integral_v<T>) {
+        using Limits = std::numeric_limits<T>;
+        char* end;
+        errno = 0;
+        bool in_range;
+        if constexpr (std::is_signed_v<T>) {
+            long long value = std::strtoll(text, &end, 0);
+            in_range = errno != ERANGE && value >= (long long)Limits::min() && value <= (long long)Limits::max();
+            out = T(value);
+        } else {
+            unsigned long long value = std::strtoull(text, &end, 0);
+            char const* first = text;
+            while (*first == ' ' || (*first >= '\t' && *first <= '\r'))
+                ++first;
+            in_range = errno != ERANGE && *first != '-' && value <= (unsigned long long)Limits::max();
+            out = T(value);
+        }
+        if (end == text)
+            jvcmd_exit_with_error(config, "Invalid value for option '%s%s', '%s' is not an integer.",
+                                  prefix_of(config, arg), arg->name, text);
+        if (!in_range) {
+            char min_value[JVSTR_FORMAT_SIZE], max_value[JVSTR_FORMAT_SIZE];
+            if constexpr (std::is_signed_v<T>) {
+                jvstr_format_int(min_value, Limits::min());
+                jvstr_format_int(max_value, Limits::max());
+            } else {
+                jvstr_format_uint(min_value, Limits::min());
+                jvstr_format_uint(max_value, Limits::max());
+            }
+            jvcmd_exit_with_error(config, "Invalid value for option '%s%s', '%s' is out of range. (min value: %s, max value: %s)",
+                                  prefix_of(config, arg), arg->name, text, min_value, max_value);
+        }
+    } else if constexpr (std::is_floating_point_v<T>) {
+        char* end;
+        if constexpr (std::is_same_v<T, float>)
+            out = std::strtof(text, &end);
+        else if constexpr (std::is_same_v<T, double>)
+            out = std::strtod(text, &end);
+        else
+            out = std::strtold(text, &end);
+        if (end == text)
+            jvcmd_exit_with_error(config, "Invalid value for option '%s%s', '%s' is not a number.",
+                                  prefix_of(config, arg), arg->name, text);
+    } else if constexpr (std::is_constructible_v<T, char const*>) {
+        out = T(text); // std::string_view, char const*, std::string...
+    } else {
+        static_assert(dependent_false<T>, "jvcmd::Binder cannot convert a value into this type.");
+    }
+}
+
+// 'action' of a bound argument, 'userdata' is the member of the bound struct.
+template <class T>
+void store(jvParsingConfig* config, jvArgument* arg) {
+    T& target = *static_cast<T*>(arg->userdata);
+    if constexpr (is_multiple<T>) {
+        target.clear();
+        for (int i = 0; i < arg->nb_values; ++i) {
+            typename T::value_type element{};
+            convert(config, arg, arg->values[i], element);
+            target.push_back(std::move(element));
+        }
+    } else {
+        convert(config, arg, arg->value, target);
+    }
+}
+
+} // namespace detail
+
+/*
+Parser writing the values straight into the members of a struct, converted according to their type:
+    bool                        a flag set to true when specified, or a value if declared with is_bool()
+    integers of any width       same syntax as 'is_int', with the range of the member's type
+    float, double, long double  decimal or hexadecimal floating-point
+    enums                       index in allowed_values() if defined, else the underlying integer
+    std::string_view, std::string, char const*
+    containers of the above     (with clear and push_back, like std::vector) are multiple(), each value is appended
+The members keep their initial value when the argument is not specified, so they act as defaults.
+On error the struct may be partially written.
+
+Usage:
+    struct Settings { unsigned threads = 4; bool verbose = false; std::vector<std::string_view> inputs; };
+    Settings settings;
+    jvcmd::Binder<Settings> parser(settings, "Process the inputs.");
+    parser.bind(&Settings::threads, "threads", 't', "Number of worker threads.");
+    parser.bind(&Settings::verbose, "verbose", 'v', "Print progress.");
+    parser.bind_positional(&Settings::inputs, "inputs", "Files to process.");
+    if (auto result = parser.parse(argc, argv); !result) ...
+*/
+template <class Struct, std::size_t MaxArguments = 32, std::size_t ErrorSize = 256>
+class Binder : public Parser<MaxArguments, ErrorSize> {
+public:
+    explicit Binder(Struct& target, char const* description = nullptr) noexcept : target_(target) {
+        this->config().description = description;
+    }
+
+    template <class T>
+    Arg bind(T Struct::* member, char const* name, char short_name = 0, char const* help = "") noexcept {
+        return bind_argument(this->option(name, help, short_name), member);
+    }
+
+    template <class T>
+    Arg bind_positional(T Struct::* member, char const* name, char const* help = "") noexcept {
+        return bind_argument(this->positional(name, help), member);
+    }
+
+private:
+    template <class T>
+    Arg bind_argument(Arg arg, T Struct::* member) noexcept {
+        if constexpr (!std::is_same_v<T, bool>)
+            arg.need_value();
+        if constexpr (detail::is_multiple<T>)
+            arg.multiple();
+        return arg.action(&detail::store<T>, &(target_.*member));
+    }
+
+    Struct& target_;
+};
+
+// Option or positional argument of a Spec, with constexpr setters named after the CONFIG fields.
+struct ArgSpec {
+    jvArgument arg = {};
+    bool is_positional = false;
+
+    constexpr ArgSpec required() const { ArgSpec copy = *this; copy.arg.required = true; return copy; }
+    constexpr ArgSpec need_value() const { ArgSpec copy = *this; copy.arg.need_value = true; return copy; }
+    constexpr ArgSpec is_bool() const { ArgSpec copy = *this; copy.arg.is_bool = true; return copy; }
+    constexpr ArgSpec is_json() const { ArgSpec copy = *this; copy.arg.is_json = true; return copy; }
+    constexpr ArgSpec multiple() const { ArgSpec copy = *this; copy.arg.multiple = true; return copy; }
+    constexpr ArgSpec is_int(int min = 0, int max = 0) const {
+        ArgSpec copy = *this;
+        copy.arg.is_int = true;
+        copy.arg.int_min = min;
+        copy.arg.int_max = max;
+        return copy;
+    }
+    constexpr ArgSpec is_float(float min = 0, float max = 0) const {
+        ArgSpec copy = *this;
+        copy.arg.is_float = true;
+        copy.arg.float_min = min;
+        copy.arg.float_max = max;
+        return copy;
+    }
+    constexpr ArgSpec allowed_values(char const* values) const { ArgSpec copy = *this; copy.arg.allowed_values = values; return copy; }
+    constexpr ArgSpec allowed_values_file(char const* path) const { ArgSpec copy = *this; copy.arg.allowed_values_file = path; return copy; }
+    constexpr ArgSpec pattern(char const* regex) const { ArgSpec copy = *this; copy.arg.pattern = regex; return copy; }
+    constexpr ArgSpec default_value(char const* value) const { ArgSpec copy = *this; copy.arg.default_value = value; return copy; }
+};
+
+constexpr ArgSpec option(char const* name, char const* help, char short_name = 0) {
+    ArgSpec spec;
+    spec.arg.name = name;
+    spec.arg.help = help;
+    spec.arg.short_name = short_name;
+    return spec;
+}
+
+constexpr ArgSpec positional(char const* name, char const* help) {
+    ArgSpec spec = option(name, help);
+    spec.is_positional = true;
+    return spec;
+}
+
+namespace detail {
+
+constexpr std::size_t length(char const* str) {
+    std::size_t size = 0;
+    while (str[size] != '\0')
+        ++size;
+    return size;
+}
+
+constexpr char lower(char c) { return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c; }
+
+// constexpr counterpart of jvstr_switch_hash in <jvcmd/StrSwitch.h>.
+constexpr std::uint64_t switch_hash(char const* str, std::size_t size, std::uint64_t seed, bool ignore_case) {
+    std::uint64_t hash = 0xcbf29ce484222325u ^ seed;
+    for (std::size_t i = 0; i < size; ++i)
+        hash = (hash ^ (unsigned char)(ignore_case ? lower(str[i]) : str[i])) * 0x100000001b3u;
+    return hash ^ (hash >> 29);
+}
+
+constexpr bool equal_icase(char const* a, char const* b) {
+    std::size_t i = 0;
+    for (; a[i] != '\0' && b[i] != '\0'; ++i)
+        if (lower(a[i]) != lower(b[i]))
+            return false;
+    return a[i] == b[i];
+}
+
+constexpr bool equal(char const* a, char const* b, bool ignore_case) {
+    std::size_t i = 0;
+    for (; a[i] != '\0' && b[i] != '\0'; ++i)
+        if (ignore_case ? lower(a[i]) != lower(b[i]) : a[i] != b[i])
+            return false;
+    return a[i] == b[i];
+}
+
+constexpr std::size_t next_power_of_2(std::size_t n) {
+    std::size_t power = 1;
+    while (power < n)
+        power *= 2;
+    return power;
+}
+
+// Tables of a StrSwitch of at most MaxCases cases, built at compile time by build_switch
+// with the same hash and builder as jvstr_switch_compile, which gives the same tables for the same cases.
+template <std::size_t MaxCases>
+struct SwitchTables {
+    static constexpr std::size_t max_slots = 2 * next_power_of_2(MaxCases);
+
+    std::uint64_t seed = 0;
+    std::uint32_t nb_buckets = 1, nb_slots = 2, nb_cases = 0;
+    bool ignore_case = false;
+    bool failed = false; // no seed gives each case its own slot
+    std::array<std::uint32_t, MaxCases> displacements = {};
+    std::array<std::uint32_t, max_slots> slots = {}; // index + 1 of the case in each slot, 0 if empty
+
+    constexpr std::uint32_t bucket(std::uint64_t hash) const { return (std::uint32_t)((hash >> 32) % nb_buckets); }
+    constexpr std::uint32_t slot(std::uint64_t hash, std::uint32_t displacement) const {
+        return ((std::uint32_t)hash + displacement * ((std::uint32_t)(hash >> 16) | 1u)) & (nb_slots - 1);
+    }
+
+    // Index of the only case which may be equal to str[0..size), or -1: the caller compares them.
+    constexpr int candidate(char const* str, std::size_t size) const {
+        std::uint64_t hash = switch_hash(str, size, seed, ignore_case);
+        return (int)slots[slot(hash, displacements[bucket(hash)])] - 1;
+    }
+};
+
+// place_cases of StrSwitch.c, on 'cases' of at most MaxCases NUL-terminated strings.
+template <std::size_t MaxCases>
+constexpr bool place_cases(SwitchTables<MaxCases>& tables, char const* const* cases) {
+    std::uint32_t nb_buckets = tables.nb_buckets, nb_cases = tables.nb_cases;
+    std::array<std::uint64_t, MaxCases> hashes = {};
+    std::array<std::uint32_t, MaxCases> order = {};
+    std::array<std::uint32_t, MaxCases + 1> bucket_start = {};
+    std::array<std::uint32_t, MaxCases> bucket_order = {};
+    for (std::uint32_t& displacement : tables.displacements)
+        displacement = 0;
+    for (std::uint32_t& slot : tables.slots)
+        slot = 0;
+    // Counting sort of the cases by bucket, in index order within a bucket so that duplicates come after the first.
+    for (std::uint32_t i = 0; i < nb_cases; ++i) {
+        hashes[i] = switch_hash(cases[i], length(cases[i]), tables.seed, tables.ignore_case);
+        ++bucket_start[tables.bucket(hashes[i]) + 1];
+    }
+    std::uint32_t max_size = 0;
+    for (std::uint32_t b = 0; b < nb_buckets; ++b) {
+        if (bucket_start[b + 1] > max_size)
+            max_size = bucket_start[b + 1];
+        bucket_start[b + 1] += bucket_start[b];
+    }
+    for (std::uint32_t i = 0; i < nb_cases; ++i)
+        order[bucket_start[tables.bucket(hashes[i])]++] = i;
+    for (std::uint32_t b = nb_buckets; b > 0; --b)
+        bucket_start[b] = bucket_start[b - 1];
+    bucket_start[0] = 0;
+    // Buckets from the largest to the smallest, empty ones are skipped.
+    std::uint32_t nb_ordered = 0;
+    for (std::uint32_t size = max_size; size > 0; --size)
+        for (std::uint32_t b = 0; b < nb_buckets; ++b)
+            if (bucket_start[b + 1] - bucket_start[b] == size)
+                bucket_order[nb_ordered++] = b;
+
+    for (std::uint32_t k = 0; k < nb_ordered; ++k) {
+        std::uint32_t bucket = bucket_order[k];
+        std::uint32_t begin = bucket_start[bucket], end = bucket_start[bucket + 1];
+        std::uint32_t displacement = 0;
+        for (;; ++displacement) {
+            if (displacement == tables.nb_slots)
+                return false;
+            bool is_free = true;
+            for (std::uint32_t i = begin; i < end && is_free; ++i) {
+                std::uint32_t slot = tables.slot(hashes[order[i]], displacement);
+                is_free = tables.slots[slot] == 0;
+                // Two cases of the bucket in the same slot: fine only if they are equal, then the first is kept.
+                for (std::uint32_t j = begin; j < i && is_free; ++j) {
+                    if (tables.slot(hashes[order[j]], displacement) == slot)
+                        is_free = hashes[order[j]] == hashes[order[i]] && equal(cases[order[j]], cases[order[i]], tables.ignore_case);
+                }
+            }
+            if (is_free)
+                break;
+        }
+        tables.displacements[bucket] = displacement;
+        for (std::uint32_t i = begin; i < end; ++i) {
+            std::uint32_t& slot = tables.slots[tables.slot(hashes[order[i]], displacement)];
+            if (slot == 0)
+                slot = order[i] + 1;
+        }
+    }
+    return true;
+}
+
+// jvstr_switch_compile at compile time, with nb_cases <= MaxCases.
+template <std::size_t MaxCases>
+constexpr SwitchTables<MaxCases> build_switch(char const* const* cases, std::size_t nb_cases, bool ignore_case) {
+    SwitchTables<MaxCases> tables;
+    tables.nb_cases = (std::uint32_t)nb_cases;
+    tables.nb_buckets = nb_cases > 0 ? (std::uint32_t)nb_cases : 1;
+    while (tables.nb_slots < 2 * nb_cases)
+        tables.nb_slots *= 2;
+    tables.ignore_case = ignore_case;
+    for (tables.seed = 0; tables.seed < 64; ++tables.seed)
+        if (place_cases(tables, cases))
+            return tables;
+    tables.failed = true;
+    return tables;
+}
+
+} // namespace detail
+
+/*
+Dispatch on strings known at compile time, like a C switch on integers: the constexpr counterpart
+of StrSwitch (see <jvcmd/StrSwitch.h>), whose perfect hash is built by the compiler with the same tables.
+A lookup is one hash and one comparison with the single candidate.
+Usage:
+    enum { OP_ADD, OP_SUB, OP_MULT, OP_DIV };
+    static constexpr auto operations = jvcmd::make_switch("add", "sub", "mult", "div");
+    static_assert(!operations.failed(), "no perfect hash for the operations"); // not seen in practice
+    switch (operations.find(parser["operation"].value())) {
+    case OP_ADD: ...
+    case -1: // not a case
+    }
+*/
+template <std::size_t NbCases>
+struct Switch {
+    std::array<char const*, NbCases> cases = {};
+    detail::SwitchTables<NbCases> tables = {};
+
+    constexpr bool failed() const { return tables.failed; }
+
+    // Index of the case equal to 'str' (the first one if several are), -1 if there is none.
+    constexpr int find(std::string_view str) const {
+        int index = tables.candidate(str.data(), str.size());
+        if (index < 0)
+            return -1;
+        char const* expected = cases[index];
+        std::size_t i = 0;
+        for (; i < str.size() && expected[i] != '\0'; ++i)
+            if (tables.ignore_case ? detail::lower(str[i]) != detail::lower(expected[i]) : str[i] != expected[i])
+                return -1;
+        return (i == str.size() && expected[i] == '\0') ? index : -1;
+    }
+};
+
+namespace detail {
+
+template <class... Cases>
+constexpr Switch<sizeof...(Cases)> make_switch(bool ignore_case, Cases const&... cases) {
+    static_assert(sizeof...(Cases) > 0, "jvcmd::make_switch needs at least one case.");
+    Switch<sizeof...(Cases)> sw;
+    sw.cases = { { cases... } };
+    sw.tables = build_switch<sizeof...(Cases)>(sw.cases.data(), sizeof...(Cases), ignore_case);
+    return sw;
+}
+
+} // namespace detail
+
+template <class... Cases>
+constexpr Switch<sizeof...(Cases)> make_switch(Cases const&... cases) { return detail::make_switch(false, cases...); }
+
+// Cases compared ignoring ASCII case, as the values of a case_insensitive parse.
+template <class... Cases>
+constexpr Switch<sizeof...(Cases)> make_switch_icase(Cases const&... cases) { return detail::make_switch(true, cases...); }
+
+/*
+Options and positional arguments known at compile time, from which the compiler builds
+a perfect hash of the long names, the short name table and the usage line.
+A StaticParser of a Spec parses without building any index: it only copies the jvArguments of the Spec.
+
+Usage:
+    static constexpr auto spec = jvcmd::make_spec(
+        jvcmd::option("threads", "Number of worker threads.", 't').is_int(1, 64).default_value("4"),
+        jvcmd::option("verbose", "Print progress.", 'v'),
+        jvcmd::positional("input", "File to process.").required());
+    jvcmd::StaticParser<spec> parser("Process a file.");
+    if (auto result = parser.parse(argc, argv); !result) ...
+    int threads = parser["threads"].as_int();
+*/
+template <std::size_t NbArguments>
+struct Spec {
+    static constexpr std::size_t nb_arguments = NbArguments;
+    static constexpr std::size_t usage_capacity = 64 * NbArguments;
+
+    std::array<jvArgument, NbArguments> arguments = {}; // options first, then positional arguments
+    std::size_t nb_options = 0;
+    int nb_pos_args_required = 0;
+
+    // Perfect hash of the long names, the StrSwitch tables of the options ignoring ASCII case,
+    // so that a Spec serves case_insensitive parsers too.
+    detail::SwitchTables<NbArguments> long_names = {};
+    std::array<std::uint16_t, 256> short_names = {}; // index + 1 in 'arguments', 0 if unused
+
+    std::array<char, usage_capacity> usage = {}; // usage line with the default prefixes, if it fits
+
+    // Checked by StaticParser's static_asserts, -1 if there is no error.
+    int duplicate_name = -1;
+    int duplicate_short_name = -1;
+    int invalid_bounds = -1;
+    bool hash_failed = false;
+    bool usage_too_long = false; // then the usage is generated at runtime
+
+    // Index in 'arguments' of the only option which may be named name[0..size), or -1. The caller compares the names.
+    constexpr int find_candidate(char const* name, std::size_t size) const {
+        return long_names.candidate(name, size);
+    }
+
+    // Index in 'arguments' of the option or positional argument named 'name', or -1.
+    constexpr int index_of(std::string_view name) const {
+        for (std::size_t i = 0; i < NbArguments; ++i)
+            if (name == arguments[i].name)
+                return (int)i;
+        return -1;
+    }
+};
+
+namespace detail {
+
+template <std::size_t N>
+constexpr void append(Spec<N>& spec, std::size_t& size, char const* str) {
+    for (; *str != '\0'; ++str) {
+        if (size + 1 >= spec.usage_capacity) {
+            spec.usage_too_long = true;
+            return;
+        }
+        spec.usage[size++] = *str;
+    }
+}
+
+// Same text as the usage generated by jvcmd.c with the default prefixes.
+template <std::size_t N>
+constexpr void build_usage(Spec<N>& spec) {
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < spec.nb_options; ++i) {
+        jvArgument const& arg = spec.arguments[i];
+        append(spec, size, arg.required ? "--" : "[--");
+        append(spec, size, arg.name);
+        if (arg.short_name != 0) {
+            char short_name[] = { '|', '-', arg.short_name, '\0' };
+            append(spec, size, short_name);
+        }
+        if (arg.need_value)
+            append(spec, size, " ...");
+        append(spec, size, arg.required ? " " : "] ");
+    }
+    append(spec, size, "[--] ");
+    for (std::size_t i = spec.nb_options; i < N; ++i) {
+        jvArgument const& arg = spec.arguments[i];
+        bool is_required = (int)(i - spec.nb_options) < spec.nb_pos_args_required;
+        append(spec, size, is_required ? "<" : "[");
+        append(spec, size, arg.name);
+        append(spec, size, is_required ? "> " : "] ");
+        if (arg.multiple)
+            append(spec, size, "... ");
+    }
+}
+
+} // namespace detail
+
+template <class... Args>
+constexpr Spec<sizeof...(Args)> make_spec(Args const&... args) {
+    static_assert(sizeof...(Args) > 0, "jvcmd::make_spec needs at least one argument.");
+    constexpr std::size_t N = sizeof...(Args);
+    Spec<N> spec;
+    ArgSpec const list[] = { args... };
+    for (ArgSpec const& arg : list)
+        if (!arg.is_positional)
+            spec.arguments[spec.nb_options++] = arg.arg;
+    std::size_t nb_arguments = spec.nb_options;
+    bool all_required = true;
+    for (ArgSpec const& arg : list) {
+        if (arg.is_positional) {
+            all_required = all_required && arg.arg.required;
+            spec.nb_pos_args_required += all_required;
+            spec.arguments[nb_arguments++] = arg.arg;
+        }
+    }
+
+    std::array<char const*, N> names = {};
+    std::array<std::uint64_t, N> hashes = {}; // only names with the same hash are compared
+    for (std::size_t i = 0; i < N; ++i) {
+        jvArgument& arg = spec.arguments[i];
+        // as done by the parser at each parse, so that the usage is right
+        arg.need_value = arg.need_value || arg.is_int || arg.is_float || arg.is_bool || arg.is_json
+                      || arg.allowed_values != nullptr || arg.allowed_values_file != nullptr || arg.pattern != nullptr;
+        if ((arg.is_int && arg.int_min > arg.int_max) || (arg.is_float && arg.float_min > arg.float_max))
+            spec.invalid_bounds = (int)i;
+        if (i >= spec.nb_options)
+            continue;
+        names[i] = arg.name;
+        hashes[i] = detail::switch_hash(arg.name, detail::length(arg.name), 0, true);
+        for (std::size_t j = 0; j < i; ++j)
+            if (hashes[j] == hashes[i] && detail::equal_icase(spec.arguments[j].name, arg.name))
+                spec.duplicate_name = (int)i;
+        unsigned char short_name = (unsigned char)arg.short_name;
+        if (short_name != 0) {
+            if (spec.short_names[short_name] != 0)
+                spec.duplicate_short_name = (int)i;
+            else
+                spec.short_names[short_name] = (std::uint16_t)(i + 1);
+        }
+    }
+
+    if (spec.duplicate_name < 0) {
+        spec.long_names = detail::build_switch<N>(names.data(), spec.nb_options, true);
+        spec.hash_failed = spec.long_names.failed;
+    }
+    detail::build_usage(spec);
+    return spec;
+}
+
+// Parser of a constexpr Spec: each instance has its own jvArguments, copied from the Spec with the pointer tables
+// to them, while the perfect hash and the usage stay in the Spec. Nothing is indexed at construction or at parse.
+// The setters of the arguments are in the Spec, the accessors read the OUTPUT fields after parse.
+template <auto const& S, std::size_t ErrorSize = 256>
+class StaticParser {
+    using SpecType = std::remove_cv_t<std::remove_reference_t<decltype(S)>>;
+    static constexpr std::size_t N = SpecType::nb_arguments;
+
+    static_assert(S.duplicate_name < 0, "jvcmd::Spec: two options have the same long name (ignoring ASCII case).");
+    static_assert(S.duplicate_short_name < 0, "jvcmd::Spec: two options have the same short name.");
+    static_assert(S.invalid_bounds < 0, "jvcmd::Spec: an argument has int_min > int_max or float_min > float_max.");
+    static_assert(!S.hash_failed, "jvcmd::Spec: no perfect hash found for the long names.");
+
+public:
+    explicit StaticParser(char const* description = nullptr) noexcept : arguments_(S.arguments) {
+        for (std::size_t i = 0; i < N; ++i)
+            (i < S.nb_options ? options_[i] : pos_args_[i - S.nb_options]) = &arguments_[i];
+        for (std::size_t c = 0; c < 256; ++c)
+            short_names_[c] = S.short_names[c] != 0 ? &arguments_[S.short_names[c] - 1] : nullptr;
+        lookup_.find_long = &find_long;
+        lookup_.index = this;
+        lookup_.short_names = short_names_.data();
+        unknown_.as_index = -1;
+        config_.description = description;
+    }
+    StaticParser(StaticParser const&) = delete;
+    StaticParser& operator=(StaticParser const&) = delete;
+    ~StaticParser() {
+        jvParsingConfig config = {};
+        config.options = options_.data();
+        config.pos_args = pos_args_.data();
+        jvcmd_free_arguments(&config);
+    }
+
+    // Other settings, 'options', 'pos_args', 'nb_pos_args_required' and 'option_lookup' are overwritten by parse().
+    jvParsingConfig& config() noexcept { return config_; }
+
+    Result<void> parse(int argc, char** argv) {
+        jvParsingConfig config = config_; // the C core clears the OUTPUT fields of the previous parse
+        config.options = options_.data();
+        config.pos_args = pos_args_.data();
+        config.nb_pos_args_required = S.nb_pos_args_required;
+        config.option_lookup = &lookup_;
+        bool default_prefixes = config.options_prefix == nullptr && config.short_options_prefix == nullptr
+                             && config.no_more_options == nullptr;
+        if (config.usage == nullptr && default_prefixes && !S.usage_too_long)
+            config.usage = S.usage.data();
+        if (!jvcmd_try_parse_arguments(argc, argv, config, error_, ErrorSize))
+            return Error{ error_ };
+        return {};
+    }
+
+    // Argument by index in the Spec, options first then positional arguments.
+    Arg operator[](std::size_t index) noexcept { return Arg(&arguments_[index]); }
+    // Argument by name, an unknown name gives an argument never specified.
+    Arg operator[](std::string_view name) noexcept {
+        int index = S.index_of(name);
+        return Arg(index >= 0 ? &arguments_[index] : &unknown_);
+    }
+
+private:
+    static jvArgument* find_long(jvOptionLookup const* lookup, char const* name, std::size_t size, bool ignore_case) {
+        int index = S.find_candidate(name, size);
+        if (index < 0)
+            return nullptr;
+        jvArgument* argument = static_cast<StaticParser const*>(lookup->index)->options_[index]; // options come first
+        StrView expected = StrView_make(argument->name);
+        StrView str = { name, size };
+        return (ignore_case ? jvstr_equal_icase(str, expected) : jvstr_equal(str, expected)) ? argument : nullptr;
+    }
+
+    std::array<jvArgument, N> arguments_;
+    std::array<jvArgument*, N + 1> options_ = {};  // NULL-terminated
+    std::array<jvArgument*, N + 1> pos_args_ = {}; // NULL-terminated
+    std::array<jvArgument*, 256> short_names_ = {};
+    jvOptionLookup lookup_ = {};
+    jvArgument unknown_ = {};
+
+    jvParsingConfig config_ = {};
+    char error_[ErrorSize] = {};
+};
+
+} // namespace jvcmd
+
+#endif
@@ -0,0 +1,427 @@
+/*
+This is the C implementation of the compiled specs of the jvcmd library, written by Julien Vernay ( jvernay.fr ) in 2021.
+The format is documented in jvspec.h.
+The library is available under the MIT License, whose terms are below.
+
+MIT License
+
+Copyright (c) 2021 Julien Vernay ( jvernay.fr )
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "jvspec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define JVSPEC_HAS_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "StrView.h"
+#include "StrBuf.h"
+#include "StrSwitch.h"
+
+struct jvSpec {
+    unsigned char const* data;  /* the compiled spec */
+    size_t size;
+    void* mapping;              /* to munmap, or NULL */
+    void* allocation;           /* to free, or NULL */
+    jvOptionLookup lookup;
+    StrSwitch long_names;       /* the perfect hash of the file, without the cases */
+    jvArgument* short_names[256];
+    jvArgument** options;       /* NULL-terminated, in the same allocation as the structure */
+    jvArgument** pos_args;      /* NULL-terminated */
+    jvArgument* arguments;      /* nb_options + nb_pos_args, options first */
+};
+
+static jvSpecHeader const* header_of(jvSpec const* spec) {
+    return (jvSpecHeader const*)spec->data;
+}
+
+static size_t align8(size_t offset) {
+    return (offset + 7) & ~(size_t)7;
+}
+
+
+/* --- Compilation --- */
+
+/* Offset of 'str' in the strings section, once appended to it */
+static uint32_t add_string(StrBuf* strings, char const* str) {
+    if (str == NULL)
+        return JVSPEC_NONE;
+    uint32_t offset = (uint32_t)strings->size;
+    jvstr_buf_append(strings, StrView_make(str));
+    jvstr_buf_append_char(strings, '\0');
+    return offset;
+}
+
+static void compile_argument(jvSpecArgument* out, jvArgument const* arg, StrBuf* strings) {
+    out->name = add_string(strings, arg->name);
+    out->help = add_string(strings, arg->help);
+    out->allowed_values = add_string(strings, arg->allowed_values);
+    out->allowed_values_file = add_string(strings, arg->allowed_values_file);
+    out->pattern = add_string(strings, arg->pattern);
+    out->default_value = add_string(strings, arg->default_value);
+    out->int_min = arg->int_min;
+    out->int_max = arg->int_max;
+    out->float_min = arg->float_min;
+    out->float_max = arg->float_max;
+    bool need_value = arg->need_value || arg->is_int || arg->is_float || arg->is_bool || arg->is_json
+                   || (arg->allowed_values != NULL) || (arg->allowed_values_file != NULL) || (arg->pattern != NULL);
+    out->flags = (arg->required ? JVSPEC_REQUIRED : 0) | (need_value ? JVSPEC_NEED_VALUE : 0)
+               | (arg->is_int ? JVSPEC_IS_INT : 0) | (arg->is_float ? JVSPEC_IS_FLOAT : 0)
+               | (arg->is_bool ? JVSPEC_IS_BOOL : 0) | (arg->is_json ? JVSPEC_IS_JSON : 0)
+               | (arg->multiple ? JVSPEC_MULTIPLE : 0);
+    out->short_name = (unsigned char)arg->short_name;
+}
+
+/* Layout of the file once the arguments and the hash are built, returns NULL if there is not enough memory */
+static unsigned char* serialize(jvParsingConfig const* config, StrSwitch const* hash, jvSpecArgument* arguments,
+                                size_t nb_options, size_t nb_pos_args, size_t* size) {
+    StrBuf strings;
+    jvstr_buf_init(&strings);
+    jvstr_buf_append_char(&strings, '\0'); // offset 0 is the empty string
+    jvSpecHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, JVSPEC_MAGIC, sizeof(header.magic));
+    header.version = JVSPEC_VERSION;
+    header.byte_order = 0x01020304;
+    header.seed = hash->seed;
+    header.flags = (config->no_help ? JVSPEC_NO_HELP : 0) | (config->stops_at_last_pos ? JVSPEC_STOPS_AT_LAST_POS : 0)
+                 | (config->strict_utf8 ? JVSPEC_STRICT_UTF8 : 0) | (config->case_insensitive ? JVSPEC_CASE_INSENSITIVE : 0);
+    header.nb_options = (uint32_t)nb_options;
+    header.nb_pos_args = (uint32_t)nb_pos_args;
+    header.nb_pos_args_required = (uint32_t)config->nb_pos_args_required;
+    header.nb_buckets = hash->nb_buckets;
+    header.table_size = hash->nb_slots;
+    header.description = add_string(&strings, config->description);
+    header.usage = add_string(&strings, config->usage);
+    header.epilog = add_string(&strings, config->epilog);
+    header.help_text = add_string(&strings, config->help_text);
+    for (size_t i = 0; i < nb_options; ++i)
+        compile_argument(&arguments[i], config->options[i], &strings);
+    for (size_t i = 0; i < nb_pos_args; ++i)
+        compile_argument(&arguments[nb_options + i], config->pos_args[i], &strings);
+
+    size_t offset = align8(sizeof(jvSpecHeader));
+    header.arguments_offset = (uint32_t)offset;
+    offset = align8(offset + (nb_options + nb_pos_args) * sizeof(jvSpecArgument));
+    header.displacements_offset = (uint32_t)offset;
+    offset = align8(offset + hash->nb_buckets * sizeof(uint32_t));
+    header.slots_offset = (uint32_t)offset;
+    offset = align8(offset + hash->nb_slots * sizeof(uint32_t));
+    header.short_names_offset = (uint32_t)offset;
+    offset = align8(offset + 256 * sizeof(uint32_t));
+    header.strings_offset = (uint32_t)offset;
+    header.strings_size = (uint32_t)strings.size;
+    offset = align8(offset + strings.size);
+    header.file_size = offset;
+
+    unsigned char* data = NULL;
+    if (!strings.has_failed && offset <= UINT32_MAX)
+        data = (unsigned char*)calloc(offset, 1);
+    if (data != NULL) {
+        memcpy(data, &header, sizeof(header));
+        memcpy(data + header.arguments_offset, arguments, (nb_options + nb_pos_args) * sizeof(jvSpecArgument));
+        memcpy(data + header.displacements_offset, hash->displacements, hash->nb_buckets * sizeof(uint32_t));
+        memcpy(data + header.slots_offset, hash->slots, hash->nb_slots * sizeof(uint32_t));
+        uint32_t* short_names = (uint32_t*)(data + header.short_names_offset);
+        for (size_t i = nb_options; i-- > 0;) // the first option wins, as in the index built by jvcmd
+            if (config->options[i]->short_name != 0)
+                short_names[(unsigned char)config->options[i]->short_name] = (uint32_t)i + 1;
+        memcpy(data + header.strings_offset, strings.begin, strings.size);
+        *size = offset;
+    }
+    jvstr_buf_free(&strings);
+    return data;
+}
+
+void* jvspec_compile(jvParsingConfig const* config, size_t* size) {
+    size_t nb_options = 0, nb_pos_args = 0;
+    while (config->options != NULL && config->options[nb_options] != NULL)
+        ++nb_options;
+    while (config->pos_args != NULL && config->pos_args[nb_pos_args] != NULL)
+        ++nb_pos_args;
+
+    jvSpecArgument* arguments = (jvSpecArgument*)calloc(nb_options + nb_pos_args + 1, sizeof(jvSpecArgument));
+    StrView* names = (StrView*)calloc(nb_options + 1, sizeof(StrView));
+    StrSwitch* hash = NULL;
+    unsigned char* data = NULL;
+    if (arguments != NULL && names != NULL) {
+        for (size_t i = 0; i < nb_options; ++i)
+            names[i] = StrView_make(config->options[i]->name);
+        // hashed ignoring case so that the file serves case-insensitive parses too, the lookup compares the names
+        char const* error;
+        hash = jvstr_switch_compile(names, nb_options, true, &error);
+        bool has_duplicates = false;
+        for (size_t i = 0; hash != NULL && i < nb_options; ++i)
+            has_duplicates |= jvstr_switch_find(hash, names[i]) != (int)i;
+        if (hash != NULL && !has_duplicates)
+            data = serialize(config, hash, arguments, nb_options, nb_pos_args, size);
+    }
+    jvstr_switch_free(hash);
+    free(names);
+    free(arguments);
+    return data;
+}
+
+bool jvspec_save(jvParsingConfig const* config, char const* path) {
+    size_t size;
+    void* data = jvspec_compile(config, &size);
+    if (data == NULL)
+        return false;
+    FILE* f = fopen(path, "wb");
+    bool ok = f != NULL && fwrite(data, 1, size, f) == size;
+    if (f != NULL)
+        ok = (fclose(f) == 0) && ok;
+    free(data);
+    return ok;
+}
+
+
+/* --- Loading --- */
+
+static jvArgument* spec_find_long(jvOptionLookup const* lookup, char const* name, size_t size, bool ignore_case) {
+    jvSpec const* spec = (jvSpec const*)lookup->index;
+    StrView wanted = { name, size };
+    int index = jvstr_switch_candidate(&spec->long_names, wanted);
+    if (index < 0)
+        return NULL;
+    jvArgument* option = &spec->arguments[index];
+    StrView option_name = StrView_make(option->name);
+    bool is_equal = ignore_case ? jvstr_equal_icase(option_name, wanted) : jvstr_equal(option_name, wanted);
+    return is_equal ? option : NULL;
+}
+
+static bool section_fits(jvSpecHeader const* header, uint32_t offset, uint64_t count, size_t item_size) {
+    return offset % 8 == 0 && offset >= sizeof(jvSpecHeader) && offset <= header->file_size
+        && count * item_size <= header->file_size - offset;
+}
+
+/* Checks of jvspec_load_memory, returns the error message or NULL */
+static char const* check_header(jvSpecHeader const* header, size_t size) {
+    if (size < sizeof(jvSpecHeader) || memcmp(header->magic, JVSPEC_MAGIC, sizeof(header->magic)) != 0)
+        return "not a compiled jvcmd spec";
+    if (header->byte_order != 0x01020304)
+        return "compiled spec with another byte order";
+    if (header->version != JVSPEC_VERSION)
+        return "compiled spec with an unsupported version";
+    if (header->file_size != size)
+        return "truncated compiled spec";
+    if (header->nb_buckets != (header->nb_options > 0 ? header->nb_options : 1) || header->table_size < 2
+            || (header->table_size & (header->table_size - 1)) != 0 || header->table_size < 2 * (uint64_t)header->nb_options
+            || header->nb_pos_args_required > header->nb_pos_args)
+        return "inconsistent compiled spec";
+    if (!section_fits(header, header->arguments_offset, (uint64_t)header->nb_options + header->nb_pos_args, sizeof(jvSpecArgument))
+            || !section_fits(header, header->displacements_offset, header->nb_buckets, sizeof(uint32_t))
+            || !section_fits(header, header->slots_offset, header->table_size, sizeof(uint32_t))
+            || !section_fits(header, header->short_names_offset, 256, sizeof(uint32_t))
+            || !section_fits(header, header->strings_offset, header->strings_size, 1) || header->strings_size == 0
+            || ((char const*)header)[header->strings_offset + header->strings_size - 1] != '\0')
+        return "compiled spec with sections out of bounds";
+    return NULL;
+}
+
+/* Converts a string offset to a pointer, returns false if it is out of the strings section */
+static bool load_string(jvSpec const* spec, uint32_t offset, char const** str) {
+    jvSpecHeader const* header = header_of(spec);
+    *str = NULL;
+    if (offset == JVSPEC_NONE)
+        return true;
+    if (offset >= header->strings_size)
+        return false;
+    *str = (char const*)spec->data + header->strings_offset + offset;
+    return true;
+}
+
+static bool load_argument(jvSpec const* spec, jvSpecArgument const* in, jvArgument* arg) {
+    bool ok = load_string(spec, in->name, &arg->name) && arg->name != NULL
+           && load_string(spec, in->help, &arg->help)
+           && load_string(spec, in->allowed_values, &arg->allowed_values)
+           && load_string(spec, in->allowed_values_file, &arg->allowed_values_file)
+           && load_string(spec, in->pattern, &arg->pattern)
+           && load_string(spec, in->default_value, &arg->default_value);
+    arg->short_name = (char)in->short_name;
+    arg->required = (in->flags & JVSPEC_REQUIRED) != 0;
+    arg->need_value = (in->flags & JVSPEC_NEED_VALUE) != 0;
+    arg->is_int = (in->flags & JVSPEC_IS_INT) != 0;
+    arg->is_float = (in->flags & JVSPEC_IS_FLOAT) != 0;
+    arg->is_bool = (in->flags & JVSPEC_IS_BOOL) != 0;
+    arg->is_json = (in->flags & JVSPEC_IS_JSON) != 0;
+    arg->multiple = (in->flags & JVSPEC_MULTIPLE) != 0;
+    arg->int_min = in->int_min;
+    arg->int_max = in->int_max;
+    arg->float_min = in->float_min;
+    arg->float_max = in->float_max;
+    return ok && in->short_name < 256;
+}
+
+jvSpec* jvspec_load_memory(void const* data, size_t size, char const** error) {
+    jvSpecHeader const* header = (jvSpecHeader const*)data;
+    if ((uintptr_t)data % 8 != 0) {
+        *error = "compiled spec not aligned on 8 bytes";
+        return NULL;
+    }
+    *error = check_header(header, size);
+    if (*error != NULL)
+        return NULL;
+
+    size_t nb_arguments = (size_t)header->nb_options + header->nb_pos_args;
+    jvSpec* spec = (jvSpec*)calloc(1, sizeof(jvSpec) + nb_arguments * sizeof(jvArgument)
+                                      + (nb_arguments + 2) * sizeof(jvArgument*));
+    if (spec == NULL) {
+        *error = "not enough memory";
+        return NULL;
+    }
+    spec->data = (unsigned char const*)data;
+    spec->size = size;
+    spec->arguments = (jvArgument*)(spec + 1);
+    spec->options = (jvArgument**)(spec->arguments + nb_arguments);
+    spec->pos_args = spec->options + header->nb_options + 1;
+    spec->lookup.find_long = &spec_find_long;
+    spec->lookup.index = spec;
+    spec->lookup.short_names = spec->short_names;
+    spec->long_names.seed = header->seed;
+    spec->long_names.nb_buckets = header->nb_buckets;
+    spec->long_names.nb_slots = header->table_size;
+    spec->long_names.displacements = (uint32_t const*)(spec->data + header->displacements_offset);
+    spec->long_names.slots = (uint32_t const*)(spec->data + header->slots_offset);
+    spec->long_names.nb_cases = header->nb_options;
+    spec->long_names.ignore_case = true;
+
+    jvSpecArgument const* arguments = (jvSpecArgument const*)(spec->data + header->arguments_offset);
+    bool ok = true;
+    for (size_t i = 0; ok && i < nb_arguments; ++i)
+        ok = load_argument(spec, &arguments[i], &spec->arguments[i]);
+    for (size_t i = 0; i < header->nb_options; ++i)
+        spec->options[i] = &spec->arguments[i];
+    for (size_t i = 0; i < header->nb_pos_args; ++i)
+        spec->pos_args[i] = &spec->arguments[header->nb_options + i];
+    uint32_t const* short_names = (uint32_t const*)(spec->data + header->short_names_offset);
+    for (size_t c = 0; ok && c < 256; ++c) {
+        ok = short_names[c] <= header->nb_options;
+        spec->short_names[c] = (ok && short_names[c] != 0) ? &spec->arguments[short_names[c] - 1] : NULL;
+    }
+    if (!ok) {
+        free(spec);
+        *error = "compiled spec with invalid arguments";
+        return NULL;
+    }
+    return spec;
+}
+
+jvSpec* jvspec_load(char const* path, char const** error) {
+    *error = "cannot read the compiled spec";
+    void* mapping = NULL;
+    void* allocation = NULL;
+    size_t size = 0;
+#ifdef JVSPEC_HAS_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        size = (size_t)st.st_size;
+        mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+            mapping = NULL;
+    }
+    close(fd);
+    if (mapping == NULL)
+        return NULL;
+    void const* data = mapping;
+#else
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+        return NULL;
+    long file_size = (fseek(f, 0, SEEK_END) == 0) ? ftell(f) : -1;
+    if (file_size > 0 && fseek(f, 0, SEEK_SET) == 0) {
+        size = (size_t)file_size;
+        allocation = malloc(align8(size)); // malloc is aligned enough for the uint64_t of the header
+        if (allocation != NULL && fread(allocation, 1, size, f) != size) {
+            free(allocation);
+            allocation = NULL;
+        }
+    }
+    fclose(f);
+    if (allocation == NULL)
+        return NULL;
+    void const* data = allocation;
+#endif
+    jvSpec* spec = jvspec_load_memory(data, size, error);
+    if (spec == NULL) {
+#ifdef JVSPEC_HAS_MMAP
+        munmap(mapping, size);
+#endif
+        free(allocation);
+        return NULL;
+    }
+    spec->mapping = mapping;
+    spec->allocation = allocation;
+    return spec;
+}
+
+void jvspec_free(jvSpec* spec) {
+    if (spec == NULL)
+        return;
+    jvParsingConfig config = jvspec_config(spec);
+    jvcmd_free_arguments(&config); // what the parses built into the arguments
+#ifdef JVSPEC_HAS_MMAP
+    if (spec->mapping != NULL)
+        munmap(spec->mapping, spec->size);
+#endif
+    free(spec->allocation);
+    free(spec);
+}
+
+jvParsingConfig jvspec_config(jvSpec* spec) {
+    jvSpecHeader const* header = header_of(spec);
+    jvParsingConfig config;
+    memset(&config, 0, sizeof(config));
+    config.no_help = (header->flags & JVSPEC_NO_HELP) != 0;
+    config.stops_at_last_pos = (header->flags & JVSPEC_STOPS_AT_LAST_POS) != 0;
+    config.strict_utf8 = (header->flags & JVSPEC_STRICT_UTF8) != 0;
+    config.case_insensitive = (header->flags & JVSPEC_CASE_INSENSITIVE) != 0;
+    load_string(spec, header->description, &config.description);
+    load_string(spec, header->usage, &config.usage);
+    load_string(spec, header->epilog, &config.epilog);
+    load_string(spec, header->help_text, &config.help_text);
+    config.options = spec->options;
+    config.pos_args = spec->pos_args;
+    config.nb_pos_args_required = (int)header->nb_pos_args_required;
+    config.option_lookup = &spec->lookup;
+    return config;
+}
+
+jvArgument* jvspec_find(jvSpec* spec, char const* name) {
+    jvArgument* option = spec_find_long(&spec->lookup, name, strlen(name), false);
+    if (option != NULL)
+        return option;
+    for (jvArgument** pos_arg = spec->pos_args; *pos_arg != NULL; ++pos_arg)
+        if (strcmp((*pos_arg)->name, name) == 0)
+            return *pos_arg;
+    return NULL;
+}
@@ -0,0 +1,120 @@
+/*
+This is the C header for compiled specs of the jvcmd library, written by Julien Vernay ( jvernay.fr ) in 2021.
+A compiled spec is a jvcmd command line saved as a binary file, which is loaded without indexing the options again.
+The library is available under the MIT License, whose terms are below.
+
+MIT License
+
+Copyright (c) 2021 Julien Vernay ( jvernay.fr )
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+jvspec_compile serializes the arguments of a jvParsingConfig, with the perfect hash of the long names,
+into a position-independent binary format. jvspec_load maps such a file in memory and checks it,
+then jvspec_config gives the configuration to pass to jvcmd_parse_arguments.
+Usage:
+    // at build time, or when a plugin is installed
+    jvspec_save(&config, "plugin.jvspec");
+    // at each start
+    char const* error;
+    jvSpec* spec = jvspec_load("plugin.jvspec", &error);
+    if (spec == NULL) ...
+    jvcmd_parse_arguments(argc, argv, jvspec_config(spec));
+    jvArgument const* threads = jvspec_find(spec, "threads");
+
+Format, in native byte order (checked with 'byte_order'), each section aligned on 8 bytes:
+    header        jvSpecHeader, whose offsets are from the start of the file
+    arguments     jvSpecArgument[nb_options + nb_pos_args], options first
+    displacements uint32_t[nb_buckets], displacement of each bucket of the perfect hash (nb_buckets = max(nb_options, 1))
+    slots         uint32_t[table_size], index + 1 in 'arguments' of the option in each slot, 0 if empty
+    short_names   uint32_t[256], index + 1 in 'arguments' of the option with this short name, 0 if none
+    strings       NUL-terminated strings, referenced by their offset in this section
+The perfect hash is the one of <jvcmd/StrSwitch.h> built with ignore_case: a long name is hashed from its ASCII-lowercase bytes,
+and table_size is its nb_slots. jvspec_compile builds it with jvstr_switch_compile, the lookup uses jvstr_switch_candidate.
+Loading checks the header and the section bounds, then converts the arguments in a single pass:
+it does not hash any name nor copy any string, about 100 ns per argument.
+*/
+
+#ifndef JV_SPEC
+#define JV_SPEC
+
+#include "jvcmd.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define JVSPEC_MAGIC "JVCMDSPC"
+#define JVSPEC_VERSION 1
+#define JVSPEC_NONE 0xFFFFFFFFu /* string offset of a NULL string */
+
+typedef struct jvSpecHeader {
+    char     magic[8];      /* JVSPEC_MAGIC, without NUL character */
+    uint32_t version;       /* JVSPEC_VERSION */
+    uint32_t byte_order;    /* 0x01020304 */
+    uint64_t file_size;
+    uint64_t seed;          /* of the perfect hash */
+    uint32_t flags;         /* JVSPEC_NO_HELP... */
+    uint32_t nb_options, nb_pos_args, nb_pos_args_required;
+    uint32_t nb_buckets, table_size;
+    uint32_t arguments_offset, displacements_offset, slots_offset, short_names_offset, strings_offset, strings_size;
+    uint32_t description, usage, epilog, help_text; /* string offsets */
+} jvSpecHeader;
+
+enum {
+    JVSPEC_NO_HELP = 1, JVSPEC_STOPS_AT_LAST_POS = 2, JVSPEC_STRICT_UTF8 = 4, JVSPEC_CASE_INSENSITIVE = 8,
+};
+
+typedef struct jvSpecArgument {
+    uint32_t name, help, allowed_values, allowed_values_file, pattern, default_value; /* string offsets */
+    int32_t  int_min, int_max;
+    float    float_min, float_max;
+    uint32_t flags;         /* JVSPEC_REQUIRED... */
+    uint32_t short_name;
+} jvSpecArgument;
+
+enum {
+    JVSPEC_REQUIRED = 1, JVSPEC_NEED_VALUE = 2, JVSPEC_IS_INT = 4, JVSPEC_IS_FLOAT = 8,
+    JVSPEC_IS_BOOL = 16, JVSPEC_IS_JSON = 32, JVSPEC_MULTIPLE = 64,
+};
+
+typedef struct jvSpec jvSpec;
+
+/* Serialize the arguments, texts and flags of 'config' (not its prefixes, synonyms, actions nor userdata).
+   Returns a buffer of *size bytes to be released with free(),
+   NULL if there is not enough memory or if two options have the same long name ignoring ASCII case. */
+void* jvspec_compile(jvParsingConfig const* config, size_t* size);
+/* jvspec_compile then write the result to 'path'. Returns false on error. */
+bool jvspec_save(jvParsingConfig const* config, char const* path);
+
+/* Map a compiled spec in memory and check it. On error, returns NULL and sets *error to a static message. */
+jvSpec* jvspec_load(char const* path, char const** error);
+/* Same with a compiled spec already in memory, aligned on 8 bytes, which must stay valid until jvspec_free. */
+jvSpec* jvspec_load_memory(void const* data, size_t size, char const** error);
+/* Release the spec and its arguments, NULL is accepted. */
+void jvspec_free(jvSpec* spec);
+
+/* Configuration to parse the arguments of the spec, whose other fields (prefixes, actions...) can then be set. */
+jvParsingConfig jvspec_config(jvSpec* spec);
+/* Argument named 'name', to read its OUTPUT fields after parsing. NULL if there is none. */
+jvArgument* jvspec_find(jvSpec* spec, char const* name);
+
+
+#endif
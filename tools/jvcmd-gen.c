@@ -0,0 +1,805 @@
+/* jvcmd-gen: generates the C source and header of a jvcmd command line from a spec file,
+   so that the program starts with static jvArgument tables instead of indexing them at each parse.
+
+The spec has one argument per line, each followed by indented attribute lines. '#' starts a comment line.
+    description Calculate the result of a binary operation.
+    option int i
+        help Values are considered as int.
+    positional operation
+        help Operation evaluated on left and right values.
+        allowed add sub mult div
+        required
+Top-level lines: description, epilog, no_help, strict_utf8, case_insensitive, stops_at_last_pos,
+                 option <name> [<short name>], positional <name>.
+Attribute lines: help, required, value, int [<min> <max>], float [<min> <max>], bool, json, multiple,
+                 allowed <values>, allowed_file <path>, pattern <regex>, default <value>.
+The text of description, epilog, help, allowed, allowed_file, pattern and default is the rest of the line.
+
+For 'calc.jvcmd', `jvcmd-gen calc.jvcmd` writes:
+    calc.h  declaring 'jvArgument calc_<name>' for each argument, 'CALC_<NAME>_<VALUE>' enum constants
+            for each allowed value (to switch on 'as_index'), and 'jvParsingConfig const calc_config'.
+    calc.c  defining them, with the short name table, a perfect hash of the long names and of each 'allowed' list,
+            the usage line and the help rendered ahead of time.
+Then the program calls `jvcmd_parse_arguments(argc, argv, calc_config)`.
+*/
+
+#include "../jvcmd/jvcmd.h"
+#include "../jvcmd/StrBuf.h"
+#include "../jvcmd/StrPool.h"
+#include "../jvcmd/StrSwitch.h"
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct GenArgument {
+    jvArgument arg; /* CONFIG fields, the strings point into the spec content */
+    bool is_positional;
+    int line;
+    int allowed_line; /* line of the 'allowed' attribute */
+} GenArgument;
+
+typedef struct GenSpec {
+    char const* path;
+    jvParsingConfig config;
+    GenArgument* arguments;
+    size_t nb_arguments, capacity;
+} GenSpec;
+
+static void fail(GenSpec const* spec, int line, char const* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "%s:%d: ", spec->path, line);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+    exit(1);
+}
+
+static char* read_file(char const* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL)
+        return NULL;
+    StrBuf content;
+    jvstr_buf_init(&content);
+    char chunk[4096];
+    for (size_t size; (size = fread(chunk, 1, sizeof(chunk), f)) > 0;)
+        jvstr_buf_append(&content, (StrView) { chunk, size });
+    fclose(f);
+    if (content.has_failed)
+        return NULL;
+    char* result = (char*)malloc(content.size + 1);
+    if (result != NULL)
+        memcpy(result, content.begin, content.size + 1);
+    jvstr_buf_free(&content);
+    return result;
+}
+
+/* Cut the first word of *line (NUL-terminating it), *line then starts at the next word. */
+static char* next_word(char** line) {
+    char* word = *line;
+    while (*word == ' ' || *word == '\t')
+        ++word;
+    char* end = word;
+    while (*end != '\0' && *end != ' ' && *end != '\t')
+        ++end;
+    *line = end;
+    if (*end != '\0') {
+        *end = '\0';
+        *line = end + 1;
+        while (**line == ' ' || **line == '\t')
+            ++*line;
+    }
+    return word;
+}
+
+static bool has_value(jvArgument const* arg) {
+    return arg->need_value || arg->is_int || arg->is_float || arg->is_bool || arg->is_json
+        || arg->allowed_values != NULL || arg->allowed_values_file != NULL || arg->pattern != NULL;
+}
+
+static char lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static bool equal_icase(char const* a, char const* b) {
+    for (; *a != '\0' && *b != '\0'; ++a, ++b)
+        if (lower(*a) != lower(*b))
+            return false;
+    return *a == *b;
+}
+
+/* Append 'str' as part of a C identifier, in upper case if 'upper'. */
+static void append_identifier(StrBuf* out, char const* str, bool upper) {
+    for (; *str != '\0'; ++str) {
+        char c = *str;
+        bool is_alnum = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        if (!is_alnum)
+            c = '_';
+        else if (upper && c >= 'a' && c <= 'z')
+            c = (char)(c - 'a' + 'A');
+        jvstr_buf_append_char(out, c);
+    }
+}
+
+/* Append the enum constant of 'value' of the argument 'name', without the prefix: NAME_VALUE. */
+static void append_value_identifier(StrBuf* out, char const* name, StrView value) {
+    append_identifier(out, name, true);
+    jvstr_buf_append_char(out, '_');
+    for (size_t c = 0; c < value.size; ++c) {
+        char part[2] = { value.begin[c], '\0' };
+        append_identifier(out, part, true);
+    }
+}
+
+/* What a C identifier of the generated code names, to report collisions. */
+typedef struct GenIdentifier {
+    GenArgument const* argument; /* NULL for the identifiers of the generated tables */
+    StrView value;               /* allowed value of an enum constant, NULL for the jvArgument */
+    int line;
+} GenIdentifier;
+
+typedef struct GenIdentifiers {
+    StrPool pool;          /* identifiers without the prefix, the first char tells jvArguments from enum constants */
+    GenIdentifier* owners; /* by id in 'pool' */
+    uint32_t capacity;
+} GenIdentifiers;
+
+/* Add the identifier in 'buf' named by 'owner', fails if something else has it. */
+static void add_identifier(GenSpec const* spec, GenIdentifiers* identifiers, StrBuf const* buf, GenIdentifier owner) {
+    uint32_t nb_identifiers = identifiers->pool.size, id;
+    if (nb_identifiers == identifiers->capacity) {
+        identifiers->capacity = identifiers->capacity == 0 ? 64 : 2 * identifiers->capacity;
+        identifiers->owners = (GenIdentifier*)realloc(identifiers->owners, identifiers->capacity * sizeof(GenIdentifier));
+    }
+    StrView interned = jvstr_pool_intern(&identifiers->pool, (StrView) { buf->begin, buf->size }, &id);
+    if (identifiers->owners == NULL || interned.begin == NULL || buf->has_failed)
+        fail(spec, owner.line, "Not enough memory.");
+    if (id == nb_identifiers) {
+        identifiers->owners[id] = owner;
+        return;
+    }
+    GenIdentifier const* other = &identifiers->owners[id];
+    if (owner.value.begin != NULL)
+        fail(spec, owner.line, "Value '%.*s' of '%s' has the same enum constant as value '%.*s' of '%s' at line %d.",
+             STRVIEW_ARGS(owner.value), owner.argument->arg.name, STRVIEW_ARGS(other->value), other->argument->arg.name, other->line);
+    if (owner.argument != NULL && other->argument != NULL)
+        fail(spec, owner.line, "'%s' has the same C identifier as '%s' at line %d.", owner.argument->arg.name,
+             other->argument->arg.name, other->line);
+    GenIdentifier const* argument = owner.argument != NULL ? &owner : other;
+    fail(spec, argument->line, "The C identifier of '%s' is already used by the generated tables.", argument->argument->arg.name);
+}
+
+/* Check that the identifiers of the arguments and the enum constants of their allowed values are distinct,
+   else the generated code would not compile. */
+static void check_identifiers(GenSpec const* spec) {
+    GenIdentifiers identifiers = { .owners = NULL };
+    if (!jvstr_pool_init(&identifiers.pool))
+        fail(spec, 0, "Not enough memory.");
+    StrBuf buf;
+    jvstr_buf_init(&buf);
+    static char const* const tables[] = { "options", "pos_args", "short_names", "long_names", "long_names_displacements",
+                                          "long_names_slots", "find_long", "lookup", "config" };
+    for (size_t t = 0; t < sizeof(tables) / sizeof(tables[0]); ++t) {
+        jvstr_buf_clear(&buf);
+        jvstr_buf_append_format(&buf, "a%s", tables[t]);
+        add_identifier(spec, &identifiers, &buf, (GenIdentifier) { .argument = NULL });
+    }
+    for (size_t i = 0; i < spec->nb_arguments; ++i) {
+        GenArgument const* arg = &spec->arguments[i];
+        jvstr_buf_clear(&buf);
+        jvstr_buf_append_char(&buf, 'a');
+        append_identifier(&buf, arg->arg.name, false);
+        add_identifier(spec, &identifiers, &buf, (GenIdentifier) { .argument = arg, .line = arg->line });
+        if (arg->arg.allowed_values == NULL)
+            continue;
+        static char const* const suffixes[] = { "_values", "_values_cases", "_values_displacements", "_values_slots" };
+        for (size_t s = 0; s < sizeof(suffixes) / sizeof(suffixes[0]); ++s) {
+            jvstr_buf_clear(&buf);
+            jvstr_buf_append_char(&buf, 'a');
+            append_identifier(&buf, arg->arg.name, false);
+            jvstr_buf_append(&buf, StrView_make(suffixes[s]));
+            add_identifier(spec, &identifiers, &buf, (GenIdentifier) { .argument = NULL, .line = arg->line });
+        }
+        jvSplitIter iter = jvstr_split_all(StrView_make(arg->arg.allowed_values), ' ', true);
+        for (StrView value; jvstr_split_next(&iter, &value);) {
+            jvstr_buf_clear(&buf);
+            jvstr_buf_append_char(&buf, 'e');
+            append_value_identifier(&buf, arg->arg.name, value);
+            add_identifier(spec, &identifiers, &buf, (GenIdentifier) { .argument = arg, .value = value, .line = arg->allowed_line });
+        }
+    }
+    jvstr_buf_free(&buf);
+    jvstr_pool_free(&identifiers.pool);
+    free(identifiers.owners);
+}
+
+static void parse_spec(GenSpec* spec, char* content) {
+    int line_number = 0;
+    GenArgument* current = NULL;
+    for (char* line = content; line != NULL;) {
+        char* end = strchr(line, '\n');
+        if (end != NULL)
+            *end = '\0';
+        char* next = end != NULL ? end + 1 : NULL;
+        ++line_number;
+        size_t size = strlen(line);
+        if (size > 0 && line[size - 1] == '\r')
+            line[size - 1] = '\0';
+
+        bool is_attribute = (line[0] == ' ' || line[0] == '\t');
+        char* rest = line;
+        char* key = next_word(&rest);
+        if (key[0] == '\0' || key[0] == '#') {
+            line = next;
+            continue;
+        }
+
+        if (!is_attribute) {
+            current = NULL;
+            if (strcmp(key, "option") == 0 || strcmp(key, "positional") == 0) {
+                if (spec->nb_arguments == spec->capacity) {
+                    spec->capacity = spec->capacity == 0 ? 16 : 2 * spec->capacity;
+                    spec->arguments = (GenArgument*)realloc(spec->arguments, spec->capacity * sizeof(GenArgument));
+                    if (spec->arguments == NULL)
+                        fail(spec, line_number, "Not enough memory.");
+                }
+                current = &spec->arguments[spec->nb_arguments++];
+                memset(current, 0, sizeof(*current));
+                current->is_positional = (key[0] == 'p');
+                current->line = line_number;
+                current->arg.help = "";
+                current->arg.name = next_word(&rest);
+                if (current->arg.name[0] == '\0')
+                    fail(spec, line_number, "Missing name after '%s'.", key);
+                char const* short_name = next_word(&rest);
+                if (short_name[0] != '\0') {
+                    if (current->is_positional)
+                        fail(spec, line_number, "Positional arguments have no short name.");
+                    if (short_name[1] != '\0')
+                        fail(spec, line_number, "Short name '%s' must be a single char.", short_name);
+                    current->arg.short_name = short_name[0];
+                }
+            } else if (strcmp(key, "description") == 0) {
+                spec->config.description = rest;
+            } else if (strcmp(key, "epilog") == 0) {
+                spec->config.epilog = rest;
+            } else if (strcmp(key, "no_help") == 0) {
+                spec->config.no_help = true;
+            } else if (strcmp(key, "strict_utf8") == 0) {
+                spec->config.strict_utf8 = true;
+            } else if (strcmp(key, "case_insensitive") == 0) {
+                spec->config.case_insensitive = true;
+            } else if (strcmp(key, "stops_at_last_pos") == 0) {
+                spec->config.stops_at_last_pos = true;
+            } else {
+                fail(spec, line_number, "Unknown key '%s'.", key);
+            }
+            line = next;
+            continue;
+        }
+
+        if (current == NULL)
+            fail(spec, line_number, "Attribute '%s' is not below an option or a positional argument.", key);
+        jvArgument* arg = &current->arg;
+        if (strcmp(key, "help") == 0) {
+            arg->help = rest;
+        } else if (strcmp(key, "required") == 0) {
+            arg->required = true;
+        } else if (strcmp(key, "value") == 0) {
+            arg->need_value = true;
+        } else if (strcmp(key, "bool") == 0) {
+            arg->is_bool = true;
+        } else if (strcmp(key, "json") == 0) {
+            arg->is_json = true;
+        } else if (strcmp(key, "multiple") == 0) {
+            arg->multiple = true;
+        } else if (strcmp(key, "int") == 0 || strcmp(key, "float") == 0) {
+            bool is_int = (key[0] == 'i');
+            char const* min = next_word(&rest);
+            char const* max = next_word(&rest);
+            if ((min[0] == '\0') != (max[0] == '\0'))
+                fail(spec, line_number, "'%s' takes either no bounds or both min and max.", key);
+            char* min_end = NULL;
+            char* max_end = NULL;
+            if (is_int) {
+                arg->is_int = true;
+                arg->int_min = (int)strtol(min, &min_end, 0);
+                arg->int_max = (int)strtol(max, &max_end, 0);
+                if (arg->int_min > arg->int_max)
+                    fail(spec, line_number, "Invalid bounds, min %d is greater than max %d.", arg->int_min, arg->int_max);
+            } else {
+                arg->is_float = true;
+                arg->float_min = strtof(min, &min_end);
+                arg->float_max = strtof(max, &max_end);
+                if (arg->float_min > arg->float_max)
+                    fail(spec, line_number, "Invalid bounds, min %s is greater than max %s.", min, max);
+            }
+            if (*min_end != '\0' || *max_end != '\0')
+                fail(spec, line_number, "Invalid bounds '%s' and '%s'.", min, max);
+        } else if (strcmp(key, "allowed") == 0) {
+            if (rest[0] == '\0')
+                fail(spec, line_number, "'allowed' needs at least one value.");
+            arg->allowed_values = rest;
+            current->allowed_line = line_number;
+        } else if (strcmp(key, "allowed_file") == 0) {
+            arg->allowed_values_file = rest;
+        } else if (strcmp(key, "pattern") == 0) {
+            arg->pattern = rest;
+        } else if (strcmp(key, "default") == 0) {
+            arg->default_value = rest;
+        } else {
+            fail(spec, line_number, "Unknown attribute '%s'.", key);
+        }
+        line = next;
+    }
+
+    if (spec->nb_arguments == 0)
+        fail(spec, line_number, "The spec has no arguments.");
+    for (size_t i = 0; i < spec->nb_arguments; ++i) {
+        GenArgument* a = &spec->arguments[i];
+        a->arg.need_value = has_value(&a->arg);
+        for (size_t j = 0; j < i; ++j) {
+            GenArgument const* b = &spec->arguments[j];
+            if (a->is_positional || b->is_positional)
+                continue;
+            if (equal_icase(a->arg.name, b->arg.name))
+                fail(spec, a->line, "Option '%s' has the same name as line %d.", a->arg.name, b->line);
+            if (a->arg.short_name != 0 && a->arg.short_name == b->arg.short_name)
+                fail(spec, a->line, "Option '%s' has the same short name as line %d.", a->arg.name, b->line);
+        }
+    }
+    check_identifiers(spec);
+}
+
+
+/* Append 'str' as a C string literal. */
+static void append_literal(StrBuf* out, char const* str) {
+    if (str == NULL) {
+        jvstr_buf_append(out, STRVIEW_MAKE("NULL"));
+        return;
+    }
+    jvstr_buf_append_char(out, '"');
+    for (; *str != '\0'; ++str) {
+        unsigned char c = (unsigned char)*str;
+        if (c == '"' || c == '\\') {
+            jvstr_buf_append_char(out, '\\');
+            jvstr_buf_append_char(out, (char)c);
+        } else if (c == '\n') { // one literal line per text line
+            jvstr_buf_append(out, str[1] != '\0' ? STRVIEW_MAKE("\\n\"\n    \"") : STRVIEW_MAKE("\\n"));
+        } else if (c < 0x20 || c == 0x7F) {
+            jvstr_buf_append_format(out, "\\%03o", c);
+        } else {
+            jvstr_buf_append_char(out, (char)c);
+        }
+    }
+    jvstr_buf_append_char(out, '"');
+}
+
+/* Append 'c' as a C char literal, an integer if it is not printable ASCII. */
+static void append_char_literal(StrBuf* out, char c) {
+    if (c < 0x20 || c >= 0x7F)
+        jvstr_buf_append_format(out, "%d", (unsigned char)c);
+    else if (c == '\'' || c == '\\')
+        jvstr_buf_append_format(out, "'\\%c'", c);
+    else
+        jvstr_buf_append_format(out, "'%c'", c);
+}
+
+static void append_argument_name(StrBuf* out, char const* prefix, GenArgument const* arg) {
+    jvstr_buf_append(out, StrView_make(prefix));
+    jvstr_buf_append_char(out, '_');
+    append_identifier(out, arg->arg.name, false);
+}
+
+/* Same text as the usage generated by jvcmd.c with the default prefixes. */
+static void append_usage(StrBuf* out, jvParsingConfig const* config) {
+    for (jvArgument* const* options = config->options; *options != NULL; ++options) {
+        jvArgument const* option = *options;
+        jvstr_buf_append_format(out, option->required ? "--%s" : "[--%s", option->name);
+        if (option->short_name != 0)
+            jvstr_buf_append_format(out, "|-%c", option->short_name);
+        if (option->need_value)
+            jvstr_buf_append(out, STRVIEW_MAKE(" ..."));
+        jvstr_buf_append(out, option->required ? STRVIEW_MAKE(" ") : STRVIEW_MAKE("] "));
+    }
+    jvstr_buf_append(out, STRVIEW_MAKE("[--] "));
+    int arg_pos = 0;
+    for (jvArgument* const* pos_args = config->pos_args; *pos_args != NULL; ++pos_args, ++arg_pos) {
+        bool is_required = arg_pos < config->nb_pos_args_required;
+        jvstr_buf_append_format(out, is_required ? "<%s> " : "[%s] ", (*pos_args)->name);
+        if ((*pos_args)->multiple)
+            jvstr_buf_append(out, STRVIEW_MAKE("... "));
+    }
+}
+
+static void append_header(StrBuf* out, GenSpec const* spec, char const* prefix, char const* jvcmd_header) {
+    jvstr_buf_append_format(out, "/* Generated by jvcmd-gen from %s, do not edit. */\n\n", spec->path);
+    jvstr_buf_append(out, STRVIEW_MAKE("#ifndef JVCMD_GEN_"));
+    append_identifier(out, prefix, true);
+    jvstr_buf_append(out, STRVIEW_MAKE("\n#define JVCMD_GEN_"));
+    append_identifier(out, prefix, true);
+    jvstr_buf_append_format(out, "\n\n#include \"%s\"\n\n", jvcmd_header);
+
+    for (size_t i = 0; i < spec->nb_arguments; ++i) {
+        jvstr_buf_append(out, STRVIEW_MAKE("extern jvArgument "));
+        append_argument_name(out, prefix, &spec->arguments[i]);
+        jvstr_buf_append(out, STRVIEW_MAKE(";\n"));
+    }
+
+    for (size_t i = 0; i < spec->nb_arguments; ++i) {
+        jvArgument const* arg = &spec->arguments[i].arg;
+        if (arg->allowed_values == NULL)
+            continue;
+        jvstr_buf_append_format(out, "\n/* Values of '%s', as its 'as_index' */\nenum {\n", arg->name);
+        jvSplitIter iter = jvstr_split_all(StrView_make(arg->allowed_values), ' ', true);
+        for (StrView value; jvstr_split_next(&iter, &value);) {
+            jvstr_buf_append(out, STRVIEW_MAKE("    "));
+            append_identifier(out, prefix, true);
+            jvstr_buf_append_char(out, '_');
+            append_value_identifier(out, arg->name, value);
+            jvstr_buf_append(out, STRVIEW_MAKE(",\n"));
+        }
+        jvstr_buf_append(out, STRVIEW_MAKE("};\n"));
+    }
+
+    jvstr_buf_append(out, STRVIEW_MAKE("\n/* Configuration with the prebuilt index of the options, the usage and the help.\n"
+                                       "   If you change its prefixes, set 'option_lookup', 'usage' and 'help_text' to NULL. */\n"));
+    jvstr_buf_append_format(out, "extern jvParsingConfig const %s_config;\n\n#endif\n", prefix);
+}
+
+/* Append the tables of 'sw' and the StrSwitch named 'name' using them, whose cases are 'cases' if non-NULL.
+   It is const unless a jvArgument points to it. */
+static void append_switch(StrBuf* out, char const* name, StrSwitch const* sw, char const* cases, bool is_const) {
+    jvstr_buf_append_format(out, "static uint32_t const %s_displacements[%u] = {", name, (unsigned)sw->nb_buckets);
+    for (uint32_t b = 0; b < sw->nb_buckets; ++b)
+        jvstr_buf_append_format(out, "%s%u,", b % 16 == 0 ? "\n    " : " ", (unsigned)sw->displacements[b]);
+    jvstr_buf_append_format(out, "\n};\nstatic uint32_t const %s_slots[%u] = {", name, (unsigned)sw->nb_slots);
+    for (uint32_t s = 0; s < sw->nb_slots; ++s)
+        jvstr_buf_append_format(out, "%s%u,", s % 16 == 0 ? "\n    " : " ", (unsigned)sw->slots[s]);
+    jvstr_buf_append_format(out, "\n};\nstatic StrSwitch%s %s = {\n"
+                                 "    .seed = %u, .nb_buckets = %u, .nb_slots = %u,\n"
+                                 "    .displacements = %s_displacements, .slots = %s_slots,\n"
+                                 "    .cases = %s, .nb_cases = %u, .ignore_case = %s,\n};\n",
+                            is_const ? " const" : "", name, (unsigned)sw->seed, (unsigned)sw->nb_buckets, (unsigned)sw->nb_slots, name, name,
+                            cases != NULL ? cases : "NULL", (unsigned)sw->nb_cases, sw->ignore_case ? "true" : "false");
+}
+
+/* Append the StrSwitch '<prefix>_<name>_values' of the allowed values of 'arg', as jvcmd.c builds it at the first parse,
+   and its cases. */
+static void append_allowed_switch(StrBuf* out, GenSpec const* spec, char const* prefix, GenArgument const* arg,
+                                  bool ignore_case) {
+    size_t nb_values = 0;
+    jvSplitIter iter = jvstr_split_all(StrView_make(arg->arg.allowed_values), ' ', true);
+    for (StrView v; jvstr_split_next(&iter, &v);)
+        ++nb_values;
+    StrView* values = (StrView*)malloc((nb_values + 1) * sizeof(StrView));
+    StrBuf name, value;
+    jvstr_buf_init(&name);
+    jvstr_buf_init(&value);
+    append_argument_name(&name, prefix, arg);
+    jvstr_buf_append(&name, STRVIEW_MAKE("_values"));
+    if (values == NULL || name.has_failed)
+        fail(spec, arg->line, "Not enough memory.");
+    iter = jvstr_split_all(StrView_make(arg->arg.allowed_values), ' ', true);
+    jvstr_split_batch(&iter, values, nb_values);
+    char const* error;
+    StrSwitch* sw = jvstr_switch_compile(values, nb_values, ignore_case, &error);
+    if (sw == NULL)
+        fail(spec, arg->line, "Cannot index the allowed values of '%s': %s.", arg->arg.name, error);
+
+    StrBuf cases;
+    jvstr_buf_init(&cases);
+    if (nb_values > 0) { // else no lookup reaches the cases
+        jvstr_buf_append_format(&cases, "%s_cases", name.begin);
+        jvstr_buf_append_format(out, "static StrView const %s[%u] = {\n", cases.begin, (unsigned)nb_values);
+        for (size_t v = 0; v < nb_values; ++v) {
+            jvstr_buf_clear(&value);
+            jvstr_buf_append(&value, values[v]);
+            jvstr_buf_append(out, STRVIEW_MAKE("    { "));
+            append_literal(out, value.begin);
+            jvstr_buf_append_format(out, ", %u },\n", (unsigned)values[v].size);
+        }
+        jvstr_buf_append(out, STRVIEW_MAKE("};\n"));
+    }
+    append_switch(out, name.begin, sw, nb_values > 0 ? cases.begin : NULL, false);
+    jvstr_buf_append_char(out, '\n');
+    jvstr_buf_free(&cases);
+    jvstr_switch_free(sw);
+    jvstr_buf_free(&value);
+    jvstr_buf_free(&name);
+    free(values);
+}
+
+static void append_source(StrBuf* out, GenSpec const* spec, char const* prefix, char const* header_name,
+                          char const* switch_header, jvParsingConfig const* config,
+                          GenArgument const* const* options, size_t nb_options, StrSwitch const* hash) {
+    jvstr_buf_append_format(out, "/* Generated by jvcmd-gen from %s, do not edit. */\n\n", spec->path);
+    jvstr_buf_append_format(out, "#include \"%s\"\n#include \"%s\"\n\n#include <stdint.h>\n\n", header_name, switch_header);
+
+    /* The jvArguments point to these indexes, built with the 'case_insensitive' of the config:
+       jvcmd.c builds them again only if a parse changes it. */
+    for (size_t i = 0; i < spec->nb_arguments; ++i)
+        if (spec->arguments[i].arg.allowed_values != NULL)
+            append_allowed_switch(out, spec, prefix, &spec->arguments[i], config->case_insensitive);
+
+    for (size_t i = 0; i < spec->nb_arguments; ++i) {
+        jvArgument const* arg = &spec->arguments[i].arg;
+        jvstr_buf_append(out, STRVIEW_MAKE("jvArgument "));
+        append_argument_name(out, prefix, &spec->arguments[i]);
+        jvstr_buf_append(out, STRVIEW_MAKE(" = {\n    .name = "));
+        append_literal(out, arg->name);
+        jvstr_buf_append(out, STRVIEW_MAKE(",\n    .help = "));
+        append_literal(out, arg->help);
+        jvstr_buf_append(out, STRVIEW_MAKE(",\n"));
+        if (arg->short_name != 0) {
+            jvstr_buf_append(out, STRVIEW_MAKE("    .short_name = "));
+            append_char_literal(out, arg->short_name);
+            jvstr_buf_append(out, STRVIEW_MAKE(",\n"));
+        }
+        if (arg->required)
+            jvstr_buf_append(out, STRVIEW_MAKE("    .required = true,\n"));
+        if (arg->need_value)
+            jvstr_buf_append(out, STRVIEW_MAKE("    .need_value = true,\n"));
+        if (arg->is_int)
+            jvstr_buf_append(out, STRVIEW_MAKE("    .is_int = true,\n"));
+        if (arg->is_int && arg->int_min != arg->int_max)
+            jvstr_buf_append_format(out, "    .int_min = %d, .int_max = %d,\n", arg->int_min, arg->int_max);
+        if (arg->is_float)
+            jvstr_buf_append(out, STRVIEW_MAKE("    .is_float = true,\n"));
+        if (arg->is_float && arg->float_min != arg->float_max) // 9 significant digits read back as the same float
+            jvstr_buf_append_format(out, "    .float_min = %.8ef, .float_max = %.8ef,\n",
+                                    (double)arg->float_min, (double)arg->float_max);
+        if (arg->is_bool)
+            jvstr_buf_append(out, STRVIEW_MAKE("    .is_bool = true,\n"));
+        if (arg->is_json)
+            jvstr_buf_append(out, STRVIEW_MAKE("    .is_json = true,\n"));
+        if (arg->multiple)
+            jvstr_buf_append(out, STRVIEW_MAKE("    .multiple = true,\n"));
+        char const* const strings[] = { arg->allowed_values, arg->allowed_values_file, arg->pattern, arg->default_value };
+        char const* const fields[] = { "allowed_values", "allowed_values_file", "pattern", "default_value" };
+        for (int f = 0; f < 4; ++f) {
+            if (strings[f] == NULL)
+                continue;
+            jvstr_buf_append_format(out, "    .%s = ", fields[f]);
+            append_literal(out, strings[f]);
+            jvstr_buf_append(out, STRVIEW_MAKE(",\n"));
+        }
+        if (arg->allowed_values != NULL) {
+            jvstr_buf_append(out, STRVIEW_MAKE("    .allowed_switch = &"));
+            append_argument_name(out, prefix, &spec->arguments[i]);
+            jvstr_buf_append(out, STRVIEW_MAKE("_values,\n"));
+        }
+        if (config->case_insensitive)
+            jvstr_buf_append(out, STRVIEW_MAKE("    .indexed_ignore_case = true,\n"));
+        jvstr_buf_append(out, STRVIEW_MAKE("};\n"));
+    }
+
+    jvstr_buf_append_format(out, "\nstatic jvArgument* const %s_options[] = {", prefix);
+    for (size_t i = 0; i < nb_options; ++i) {
+        jvstr_buf_append(out, STRVIEW_MAKE(" &"));
+        append_argument_name(out, prefix, options[i]);
+        jvstr_buf_append_char(out, ',');
+    }
+    jvstr_buf_append_format(out, " NULL };\nstatic jvArgument* const %s_pos_args[] = {", prefix);
+    for (size_t i = 0; i < spec->nb_arguments; ++i) {
+        if (!spec->arguments[i].is_positional)
+            continue;
+        jvstr_buf_append(out, STRVIEW_MAKE(" &"));
+        append_argument_name(out, prefix, &spec->arguments[i]);
+        jvstr_buf_append_char(out, ',');
+    }
+    jvstr_buf_append(out, STRVIEW_MAKE(" NULL };\n"));
+
+    jvstr_buf_append_format(out, "\nstatic jvArgument* const %s_short_names[256] = {\n", prefix);
+    for (size_t i = 0; i < nb_options; ++i) {
+        if (options[i]->arg.short_name == 0)
+            continue;
+        jvstr_buf_append(out, STRVIEW_MAKE("    ["));
+        append_char_literal(out, options[i]->arg.short_name);
+        jvstr_buf_append(out, STRVIEW_MAKE("] = &"));
+        append_argument_name(out, prefix, options[i]);
+        jvstr_buf_append(out, STRVIEW_MAKE(",\n"));
+    }
+    jvstr_buf_append(out, STRVIEW_MAKE("};\n"));
+
+    jvstr_buf_append(out, STRVIEW_MAKE("\n/* Perfect hash of the long names (see <jvcmd/StrSwitch.h>): each name has its own slot,\n"
+                                       "   hashed ignoring case so that it serves both comparisons. */\n"));
+    StrBuf name;
+    jvstr_buf_init(&name);
+    jvstr_buf_append_format(&name, "%s_long_names", prefix);
+    append_switch(out, name.begin, hash, NULL, true);
+    jvstr_buf_free(&name);
+
+    jvstr_buf_append_format(out,
+        "\nstatic jvArgument* %s_find_long(jvOptionLookup const* lookup, char const* name, size_t size, bool ignore_case) {\n"
+        "    (void)lookup;\n"
+        "    StrView wanted = { name, size };\n"
+        "    int index = jvstr_switch_candidate(&%s_long_names, wanted);\n"
+        "    if (index < 0)\n"
+        "        return NULL;\n"
+        "    StrView option_name = StrView_make(%s_options[index]->name);\n"
+        "    bool is_equal = ignore_case ? jvstr_equal_icase(option_name, wanted) : jvstr_equal(option_name, wanted);\n"
+        "    return is_equal ? %s_options[index] : NULL;\n"
+        "}\n\n",
+        prefix, prefix, prefix, prefix);
+
+    jvstr_buf_append_format(out, "static jvOptionLookup const %s_lookup = { &%s_find_long, NULL, %s_short_names };\n\n",
+                            prefix, prefix, prefix);
+
+    jvstr_buf_append_format(out, "jvParsingConfig const %s_config = {\n", prefix);
+    char const* const flags[] = { "no_help", "stops_at_last_pos", "strict_utf8", "case_insensitive" };
+    bool const values[] = { config->no_help, config->stops_at_last_pos, config->strict_utf8, config->case_insensitive };
+    for (int f = 0; f < 4; ++f)
+        if (values[f])
+            jvstr_buf_append_format(out, "    .%s = true,\n", flags[f]);
+    jvstr_buf_append(out, STRVIEW_MAKE("    .description = "));
+    append_literal(out, config->description);
+    jvstr_buf_append(out, STRVIEW_MAKE(",\n    .usage = "));
+    append_literal(out, config->usage);
+    jvstr_buf_append(out, STRVIEW_MAKE(",\n    .epilog = "));
+    append_literal(out, config->epilog);
+    jvstr_buf_append(out, STRVIEW_MAKE(",\n    .help_text =\n    "));
+    append_literal(out, config->help_text);
+    jvstr_buf_append_format(out, ",\n    .options = %s_options,\n    .pos_args = %s_pos_args,\n", prefix, prefix);
+    jvstr_buf_append_format(out, "    .nb_pos_args_required = %d,\n", config->nb_pos_args_required);
+    jvstr_buf_append_format(out, "    .option_lookup = &%s_lookup,\n};\n", prefix);
+}
+
+static bool write_file(char const* path, StrBuf const* content) {
+    FILE* f = fopen(path, "wb");
+    if (f == NULL)
+        return false;
+    bool success = fwrite(content->begin, 1, content->size, f) == content->size;
+    return fclose(f) == 0 && success;
+}
+
+int main(int argc, char** argv) {
+    jvArgument output = { "output", "Path of the generated files without extension, by default the spec path without extension.",
+                          'o', .need_value = true };
+    jvArgument prefix = { "prefix", "Prefix of the generated identifiers, by default the file name of 'output'.",
+                          'p', .pattern = "[A-Za-z_][A-Za-z0-9_]*" };
+    jvArgument jvcmd_header = { "jvcmd-header", "Path of jvcmd.h, as included by the generated header.",
+                                'I', .need_value = true, .default_value = "jvcmd/jvcmd.h" };
+    jvArgument spec_path = { "spec", "Spec file describing the command line." };
+    jvArgument* options[] = { &output, &prefix, &jvcmd_header, NULL };
+    jvArgument* pos_args[] = { &spec_path, NULL };
+    jvParsingConfig gen_config = {
+        .description = "Generate the C source and header of a jvcmd command line from a spec file.",
+        .options = options,
+        .pos_args = pos_args,
+        .nb_pos_args_required = 1,
+    };
+    jvcmd_parse_arguments(argc, argv, gen_config);
+
+    GenSpec spec = { .path = spec_path.value };
+    char* content = read_file(spec.path);
+    if (content == NULL) {
+        fprintf(stderr, "Cannot read '%s'.\n", spec.path);
+        return 1;
+    }
+    parse_spec(&spec, content);
+
+    // options first, then positional arguments, as listed in the spec
+    GenArgument const** options_list = (GenArgument const**)malloc(spec.nb_arguments * sizeof(GenArgument const*));
+    jvArgument** config_lists = (jvArgument**)malloc((spec.nb_arguments + 2) * sizeof(jvArgument*));
+    if (options_list == NULL || config_lists == NULL)
+        fail(&spec, 0, "Not enough memory.");
+    size_t nb_options = 0, nb_lists = 0;
+    for (size_t i = 0; i < spec.nb_arguments; ++i)
+        if (!spec.arguments[i].is_positional)
+            options_list[nb_options++] = &spec.arguments[i];
+    for (size_t i = 0; i < nb_options; ++i)
+        config_lists[nb_lists++] = (jvArgument*)&options_list[i]->arg;
+    config_lists[nb_lists++] = NULL;
+    jvArgument** config_pos_args = config_lists + nb_lists;
+    bool all_required = true;
+    for (size_t i = 0; i < spec.nb_arguments; ++i) {
+        if (spec.arguments[i].is_positional) {
+            all_required = all_required && spec.arguments[i].arg.required;
+            spec.config.nb_pos_args_required += all_required;
+            config_lists[nb_lists++] = &spec.arguments[i].arg;
+        }
+    }
+    config_lists[nb_lists++] = NULL;
+    spec.config.options = config_lists;
+    spec.config.pos_args = config_pos_args;
+
+    StrView* names = (StrView*)malloc((nb_options + 1) * sizeof(StrView));
+    if (names == NULL)
+        fail(&spec, 0, "Not enough memory.");
+    for (size_t i = 0; i < nb_options; ++i)
+        names[i] = StrView_make(options_list[i]->arg.name);
+    char const* error;
+    StrSwitch* hash = jvstr_switch_compile(names, nb_options, true, &error);
+    if (hash == NULL)
+        fail(&spec, 0, "Cannot index the long names: %s.", error);
+    free(names); // the cases of 'hash' are not used
+
+    StrBuf usage;
+    jvstr_buf_init(&usage);
+    append_usage(&usage, &spec.config);
+    spec.config.usage = usage.begin;
+    char* help_text = jvcmd_render_help(&spec.config, 80);
+    if (help_text == NULL)
+        fail(&spec, 0, "Not enough memory.");
+    spec.config.help_text = help_text;
+
+    // output paths and prefix
+    StrView spec_view = StrView_make(spec.path);
+    StrView base = output.specified ? StrView_make(output.value) : spec_view;
+    if (!output.specified) {
+        size_t dot = jvstr_rfind(base, '.');
+        size_t slash = jvstr_rfind(base, '/');
+        if (dot != (size_t)-1 && (slash == (size_t)-1 || dot > slash))
+            base.size = dot;
+    }
+    StrView file_name = base;
+    size_t slash = jvstr_rfind(base, '/');
+    if (slash != (size_t)-1)
+        jvstr_split(&file_name, 0, slash + 1);
+
+    StrBuf path, identifier_prefix, header_name;
+    jvstr_buf_init(&path);
+    jvstr_buf_init(&identifier_prefix);
+    jvstr_buf_init(&header_name);
+    if (prefix.specified)
+        jvstr_buf_append(&identifier_prefix, StrView_make(prefix.value));
+    else {
+        StrBuf name;
+        jvstr_buf_init(&name);
+        jvstr_buf_append(&name, file_name);
+        if (name.begin[0] >= '0' && name.begin[0] <= '9')
+            jvstr_buf_append_char(&identifier_prefix, '_');
+        append_identifier(&identifier_prefix, name.begin, false);
+        jvstr_buf_free(&name);
+    }
+    jvstr_buf_append(&header_name, file_name);
+    jvstr_buf_append(&header_name, STRVIEW_MAKE(".h"));
+    // StrSwitch.h is next to jvcmd.h
+    StrBuf switch_header;
+    jvstr_buf_init(&switch_header);
+    StrView jvcmd_dir = StrView_make(jvcmd_header.value);
+    size_t jvcmd_slash = jvstr_rfind(jvcmd_dir, '/');
+    jvcmd_dir.size = jvcmd_slash == (size_t)-1 ? 0 : jvcmd_slash + 1;
+    jvstr_buf_append(&switch_header, jvcmd_dir);
+    jvstr_buf_append(&switch_header, STRVIEW_MAKE("StrSwitch.h"));
+
+    StrBuf out;
+    jvstr_buf_init(&out);
+    append_header(&out, &spec, identifier_prefix.begin, jvcmd_header.value);
+    jvstr_buf_append(&path, base);
+    jvstr_buf_append(&path, STRVIEW_MAKE(".h"));
+    if (out.has_failed || !write_file(path.begin, &out)) {
+        fprintf(stderr, "Cannot write '%s'.\n", path.begin);
+        return 1;
+    }
+
+    jvstr_buf_clear(&out);
+    append_source(&out, &spec, identifier_prefix.begin, header_name.begin, switch_header.begin,
+                  &spec.config, options_list, nb_options, hash);
+    jvstr_buf_clear(&path);
+    jvstr_buf_append(&path, base);
+    jvstr_buf_append(&path, STRVIEW_MAKE(".c"));
+    if (out.has_failed || !write_file(path.begin, &out)) {
+        fprintf(stderr, "Cannot write '%s'.\n", path.begin);
+        return 1;
+    }
+
+    jvstr_buf_free(&out);
+    jvstr_buf_free(&path);
+    jvstr_buf_free(&identifier_prefix);
+    jvstr_buf_free(&header_name);
+    jvstr_buf_free(&usage);
+    free(help_text);
+    jvstr_buf_free(&switch_header);
+    jvstr_switch_free(hash);
+    free(config_lists);
+    free(options_list);
+    free(spec.arguments);
+    free(content);
+    jvcmd_free_arguments(&gen_config);
+    return 0;
+}